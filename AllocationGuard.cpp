@@ -0,0 +1,187 @@
+/*
+ * AllocationGuard.cpp - Command line check that the hot paths of the rules engine never allocate
+ * heap memory. It counts the allocations made by each call to loadState(), resetState(),
+ * submitMove(), undoMoves() and redoMoves() and the game state detection (run after every move, or
+ * on the first query when the game state is evaluated lazily) while playing random legal games from
+ * a corpus of positions, with and without a move cache, and exits with a non-zero status if any call
+ * allocated.
+ *
+ * Usage: allocguard [games per position] [first seed]
+ */
+
+#include "AllocationTracker.h"
+#include "ChessGame.h"
+#include "MoveCache.h"
+#include "Move.h"
+#include "Zobrist.h"
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+
+static const int maxPliesPerGame = 300;
+static const int maxFailuresListed = 20;
+static const size_t cacheCapacity = 1024;
+static const int historyLimit = 64; // Smaller than most games, so that the history wraps around
+
+// Positions covering castling, en passant, promotions (including captures onto the final rank), check and endgames
+static const char* const corpus[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+    "4k3/1P6/8/3p4/4P3/8/6p1/4K3 w - - 0 1",
+    "7k/8/6QK/8/8/8/8/8 w - - 90 120"
+};
+
+/*
+ * The allocations counted for one kind of call.
+ */
+struct CallStatistics {
+    const char* name; // The call being checked
+    uint64_t calls; // The number of calls measured
+    uint64_t allocations; // The number of allocations made by those calls
+};
+
+static int failuresListed = 0;
+
+/* RECORDS THE ALLOCATIONS OF ONE CALL, LISTING THE CALL IF IT ALLOCATED */
+static void recordCall(CallStatistics& statistics, uint64_t allocationsBefore, const char* fenString, int ply) {
+    if (statistics.name == nullptr) { // Calls that are not checked
+        return;
+    }
+    uint64_t allocations = getAllocationCount() - allocationsBefore;
+    statistics.calls++;
+    statistics.allocations += allocations;
+
+    if (allocations > 0 && failuresListed < maxFailuresListed) {
+        cout << "  " << statistics.name << " made " << allocations << " allocation(s) at ply " << ply
+             << " of a game from " << fenString << "\n";
+        failuresListed++;
+    }
+}
+
+/* PLAYS ONE RANDOM GAME, MEASURING EVERY CALL TO THE RULES ENGINE */
+static void checkGame(ChessGame& game, const char* fenString, uint64_t seed, bool lazy, CallStatistics* statistics) {
+    CallStatistics& loads = statistics[0];
+    CallStatistics& moves = statistics[1];
+    CallStatistics& rejectedMoves = statistics[2];
+    CallStatistics& gameStates = statistics[3];
+    CallStatistics& resets = statistics[4];
+    CallStatistics& takebacks = statistics[5];
+    Move legalMoves[256];
+    char stringCoord1[3], stringCoord2[3];
+
+    uint64_t allocationsBefore = getAllocationCount();
+    game.loadState(fenString);
+    recordCall(loads, allocationsBefore, fenString, 0);
+
+    allocationsBefore = getAllocationCount();
+    game.resetState(fenString);
+    recordCall(resets, allocationsBefore, fenString, 0);
+
+    uint64_t random = seed;
+    for (int ply = 1; ply <= maxPliesPerGame; ply++) {
+        int legalMoveCount = game.generateLegalMoves(legalMoves);
+
+        // An illegal move: a legal move reversed, from a square that is empty or holds an opposing piece
+        if (legalMoveCount > 0) {
+            Move legalMove = legalMoves[splitMix64(random) % legalMoveCount];
+            legalMove.toStrings(stringCoord1, stringCoord2);
+
+            allocationsBefore = getAllocationCount();
+            game.submitMove(stringCoord2, stringCoord1);
+            recordCall(rejectedMoves, allocationsBefore, fenString, ply);
+        }
+
+        if (lazy) {
+            allocationsBefore = getAllocationCount();
+            game.isInCheck(white);
+            game.isInProgress();
+            recordCall(gameStates, allocationsBefore, fenString, ply);
+        }
+
+        // Once the game is over, submitting any move is rejected
+        Move move = (legalMoveCount > 0 ? legalMoves[splitMix64(random) % legalMoveCount] : Move(0, 8, noPromotion));
+        allocationsBefore = getAllocationCount();
+        bool moveAccepted = game.submitMove(move);
+        recordCall(moves, allocationsBefore, fenString, ply);
+
+        if (!moveAccepted) {
+            break;
+        }
+
+        // Occasionally take back some moves and make them again
+        if (splitMix64(random) % 8 == 0) {
+            int count = static_cast<int>(splitMix64(random) % 8) + 1;
+            allocationsBefore = getAllocationCount();
+            game.redoMoves(game.undoMoves(count));
+            recordCall(takebacks, allocationsBefore, fenString, ply);
+        }
+    }
+}
+
+/* CHECKS EVERY POSITION OF THE CORPUS IN ONE CONFIGURATION OF THE GAME */
+static bool checkConfiguration(const char* description, int gamesPerPosition, uint64_t firstSeed, bool lazy, MoveCache* cache) {
+    CallStatistics statistics[6] = {{"loadState()", 0, 0}, {"submitMove()", 0, 0}, {"submitMove() (illegal move)", 0, 0},
+                                    {"game state detection", 0, 0}, {"resetState()", 0, 0},
+                                    {"undoMoves() and redoMoves()", 0, 0}};
+
+    cout << description << ":\n";
+    uint64_t seed = firstSeed;
+    for (const char* fenString : corpus) {
+        for (int gameIndex = 0; gameIndex < gamesPerPosition; gameIndex++) {
+            ChessGame game;
+            game.setConsoleOutput(false);
+            game.setLazyGameState(lazy);
+            game.setMoveCache(cache);
+            game.setHistoryLimit(historyLimit);
+            checkGame(game, fenString, seed++, lazy, statistics);
+        }
+    }
+
+    bool passed = true;
+    for (const CallStatistics& entry : statistics) {
+        if (entry.calls > 0) {
+            cout << "  " << entry.name << ": " << entry.calls << " calls, " << entry.allocations << " allocations\n";
+        }
+        passed = passed && (entry.allocations == 0);
+    }
+    return passed;
+}
+
+/* FILLS A MOVE CACHE, WHICH ALLOCATES AN INDEX ENTRY FOR EACH SLOT THE FIRST TIME IT IS USED */
+static void fillMoveCache(MoveCache& cache, uint64_t seed) {
+    CallStatistics unchecked[6] = {};
+    ChessGame game;
+    game.setConsoleOutput(false);
+    game.setMoveCache(&cache);
+
+    // Play until positions have been evicted, so that every segment has been filled
+    for (int gameIndex = 0; cache.getStatistics().evictions < cacheCapacity; gameIndex++) {
+        checkGame(game, corpus[gameIndex % (sizeof(corpus) / sizeof(corpus[0]))], seed++, false, unchecked);
+    }
+}
+
+/****************************** MAIN ******************************/
+
+int main(int argc, char** argv) {
+    int gamesPerPosition = (argc > 1 ? atoi(argv[1]) : 25);
+    uint64_t firstSeed = (argc > 2 ? strtoull(argv[2], nullptr, 10) : 1);
+
+    MoveCache cache(cacheCapacity);
+    fillMoveCache(cache, firstSeed + 1000000); // Seeds other than those of the checked games
+    bool passed = checkConfiguration("Game state detected after every move", gamesPerPosition, firstSeed, false, nullptr);
+    passed = checkConfiguration("Game state detected lazily", gamesPerPosition, firstSeed, true, nullptr) && passed;
+    passed = checkConfiguration("Move cache attached", gamesPerPosition, firstSeed, false, &cache) && passed;
+
+    if (!passed) {
+        cout << "FAILED: the calls above must not allocate heap memory\n";
+        return 1;
+    }
+    cout << "No allocations in any checked call\n";
+    return 0;
+}
@@ -0,0 +1,64 @@
+/*
+ * AllocationTracker.cpp - Implementation file for the allocation counter: replacements of the
+ * global operator new and operator delete that count allocations before passing them on to malloc.
+ */
+
+#include "AllocationTracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+// The number of calls to the global operator new (the array and nothrow forms call the plain form)
+static atomic<uint64_t> allocationCount(0);
+
+/* GETTER FOR THE NUMBER OF ALLOCATIONS MADE SO FAR */
+uint64_t getAllocationCount() {
+    return allocationCount.load(memory_order_relaxed);
+}
+
+
+/****************************** Replacement Allocation Functions ******************************/
+
+/* ALLOCATES MEMORY, COUNTING THE ALLOCATION */
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    void* memory = malloc(size == 0 ? 1 : size);
+    if (memory == nullptr) {
+        throw bad_alloc();
+    }
+    return memory;
+}
+
+/* ALLOCATES OVER-ALIGNED MEMORY, COUNTING THE ALLOCATION */
+void* operator new(size_t size, align_val_t alignment) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    size_t bytes = static_cast<size_t>(alignment);
+    void* memory = aligned_alloc(bytes, (size + bytes - 1) / bytes * bytes); // The size must be a multiple of the alignment
+    if (memory == nullptr) {
+        throw bad_alloc();
+    }
+    return memory;
+}
+
+/* FREES MEMORY */
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+/* FREES MEMORY OF A KNOWN SIZE */
+void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+/* FREES OVER-ALIGNED MEMORY */
+void operator delete(void* memory, align_val_t) noexcept {
+    free(memory);
+}
+
+/* FREES OVER-ALIGNED MEMORY OF A KNOWN SIZE */
+void operator delete(void* memory, size_t, align_val_t) noexcept {
+    free(memory);
+}
@@ -0,0 +1,21 @@
+/*
+ * AllocationTracker.h - Header file for the allocation counter used to check that the hot paths
+ * of the engine never touch the heap. Linking AllocationTracker.o into a program replaces the
+ * global operator new and operator delete with versions that count every allocation.
+ */
+
+#ifndef ALLOCATIONTRACKER_H
+#define ALLOCATIONTRACKER_H
+
+#include <cstdint>
+
+/*
+ * Getter function for the number of heap allocations (calls to any form of the global operator
+ * new) made by the whole process so far. The difference between two readings taken around a call
+ * is the number of allocations that call made, provided no other thread allocates in between.
+ *
+ * @return The number of allocations made since the program started.
+ */
+uint64_t getAllocationCount();
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ * Analysis.cpp - Implementation file for asynchronous, cancellable analysis of
+ * positions on a shared Executor.
+ */
+
+#include "Analysis.h"
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+/*
+ * The state of one analysis, shared between the tasks that deepen it.
+ */
+struct AnalysisJob {
+    AnalysisRequest request; // The position and limits
+    promise<AnalysisResult> result; // Fulfilled when the analysis finishes
+    AnalysisResult best; // The deepest completed result so far
+    unique_ptr<ChessGame> game; // The game searched (allocated on the first task)
+    unique_ptr<TranspositionTable> table; // The transposition table (allocated on the first task)
+    unique_ptr<Search> search; // The search, kept between depths
+};
+
+/*
+ * Finishes an analysis, freeing its game and table and fulfilling its future.
+ */
+static void finishAnalysis(AnalysisJob& job, AnalysisOutcome outcome) {
+    job.search.reset();
+    job.table.reset();
+    job.game.reset();
+    job.best.outcome = outcome;
+    job.result.set_value(job.best);
+}
+
+/*
+ * Searches the next depth of an analysis, then requeues it or finishes it.
+ */
+static void runAnalysisStep(Executor& executor, shared_ptr<AnalysisJob> job) {
+    const AnalysisRequest& request = job->request;
+    if (request.cancellation.isCancelled()) {
+        finishAnalysis(*job, analysisCancelled);
+        return;
+    }
+    if (Clock::now() >= request.deadline) {
+        finishAnalysis(*job, analysisDeadlineReached);
+        return;
+    }
+
+    if (job->search == nullptr) {
+        job->game = make_unique<ChessGame>();
+        job->game->setConsoleOutput(false);
+        if (!job->game->restorePlayablePosition(request.position)) { // The search assumes a king of each colour, and so on
+            finishAnalysis(*job, analysisInvalidPosition);
+            return;
+        }
+        job->table = make_unique<TranspositionTable>(request.transpositionEntries);
+        job->search = make_unique<Search>(*job->game, *job->table);
+        job->search->setStopCondition([&request]() {
+            return request.cancellation.isCancelled() || Clock::now() >= request.deadline;
+        });
+    }
+
+    vector<SearchResult> lines(max(request.lineCount, 1));
+    int lineCount = 0;
+    if (!job->search->searchLines(job->best.best.depth + 1, lines.size(), lines.data(), lineCount)) {
+        finishAnalysis(*job, request.cancellation.isCancelled() ? analysisCancelled : analysisDeadlineReached);
+        return;
+    }
+    lines.resize(lineCount);
+    const SearchResult& result = lines[0];
+    job->best.best = result;
+    job->best.lines = lines;
+    if (request.onDepthCompleted) {
+        request.onDepthCompleted(result);
+    }
+
+    bool gameOver = result.bestMove.isNull();
+    bool mateFound = (result.score >= mateThreshold || result.score <= -mateThreshold);
+    if (gameOver || mateFound || result.depth >= min(request.maxDepth, maxSearchDepth - 1)) {
+        finishAnalysis(*job, analysisComplete);
+        return;
+    }
+    executor.submit([&executor, job]() { runAnalysisStep(executor, job); });
+}
+
+
+/****************************** CancellationToken - Member Function Definitions ******************************/
+
+/* DEFAULT CONSTRUCTOR */
+CancellationToken::CancellationToken() : cancelled(make_shared<atomic<bool>>(false)) {}
+
+/* CANCELS EVERY ANALYSIS SHARING THE TOKEN */
+void CancellationToken::cancel() {
+    cancelled->store(true, memory_order_relaxed);
+}
+
+/* DETERMINES WHETHER THE TOKEN HAS BEEN CANCELLED */
+bool CancellationToken::isCancelled() const {
+    return cancelled->load(memory_order_relaxed);
+}
+
+
+/****************************** Analysis - Function Definitions ******************************/
+
+/* STARTS AN ANALYSIS ON AN EXECUTOR */
+future<AnalysisResult> startAnalysis(Executor& executor, AnalysisRequest request) {
+    shared_ptr<AnalysisJob> job = make_shared<AnalysisJob>();
+    job->request = move(request);
+    future<AnalysisResult> result = job->result.get_future();
+
+    executor.submit([&executor, job]() { runAnalysisStep(executor, job); });
+    return result;
+}
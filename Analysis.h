@@ -0,0 +1,92 @@
+/*
+ * Analysis.h - Header file for asynchronous, cancellable analysis of positions. Each
+ * analysis deepens its search one depth per task on a shared Executor, so any number
+ * of analyses can be pending without a thread each.
+ */
+
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include "Executor.h"
+#include "Position.h"
+#include "Search.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+/*
+ * A token shared between the requester of an analysis and the analysis itself. Copies
+ * refer to the same token, so cancelling any copy cancels the analysis.
+ */
+class CancellationToken final {
+
+    public:
+        /*
+         * Default constructor for a token that has not been cancelled.
+         */
+        CancellationToken();
+
+        /*
+         * Cancels every analysis holding a copy of this token. Thread-safe.
+         */
+        void cancel();
+
+        /*
+         * Determines whether the token has been cancelled. Thread-safe.
+         *
+         * @return true if cancel() has been called on any copy; false otherwise.
+         */
+        bool isCancelled() const;
+
+    private:
+        std::shared_ptr<std::atomic<bool>> cancelled; // The state shared by every copy
+};
+
+/*
+ * Enum representing why an analysis finished.
+ */
+enum AnalysisOutcome {analysisComplete, analysisDeadlineReached, analysisCancelled, analysisInvalidPosition};
+
+/*
+ * The parameters of a single analysis.
+ */
+struct AnalysisRequest {
+    Position position; // The position to analyse (see ChessGame::savePosition()), which must be playable (see ChessGame::restorePlayablePosition())
+    int maxDepth = 8; // The deepest search to complete
+    int lineCount = 1; // The number of distinct lines to find (more than one for multi-PV analysis)
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max(); // When to stop searching
+    CancellationToken cancellation; // Cancelled to stop the analysis early
+    std::function<void(const SearchResult&)> onDepthCompleted; // Called (on an executor thread) with each completed depth (may be empty)
+    size_t transpositionEntries = 1 << 16; // The size of the analysis' transposition table
+};
+
+/*
+ * The final result of an analysis.
+ */
+struct AnalysisResult {
+    SearchResult best; // The result of the deepest completed depth (depth 0 if none completed)
+    std::vector<SearchResult> lines; // Every line found at that depth, best first (see AnalysisRequest::lineCount)
+    AnalysisOutcome outcome = analysisComplete; // Why the analysis finished
+};
+
+/*
+ * Starts analysing a position on an executor. The search is deepened one depth per task,
+ * and each task requeues the next, so analyses share the executor's threads in turn. The
+ * game and transposition table are only allocated once the analysis first runs, and are
+ * freed as soon as it finishes.
+ *
+ * @param executor The executor to run the analysis on (which must outlive it).
+ * @param request The position to analyse and the limits of the analysis.
+ *
+ * @return A future holding the result once the maximum depth is completed, the deadline
+ *         passes, the analysis is cancelled or the position is found to be checkmate or stalemate,
+ *         or at once (with outcome analysisInvalidPosition and no depth completed) if the position
+ *         is not playable.
+ */
+std::future<AnalysisResult> startAnalysis(Executor& executor, AnalysisRequest request);
+
+#endif
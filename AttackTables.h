@@ -0,0 +1,180 @@
+/*
+ * AttackTables.h - Header file for the attack and geometry tables used to validate moves
+ * and detect attacks. The tables are generated at compile time, so looking up the squares a
+ * piece attacks (or the squares between two others) needs no loops and no runtime initialisation.
+ * Attacks by rooks, bishops and queens are still detected by walking outwards from the attacked
+ * square in each direction to the nearest piece (see ChessGame::findNearestNeighbour()), which
+ * measured faster than testing every enemy slider for a shared line and an empty path between.
+ */
+
+#ifndef ATTACKTABLES_H
+#define ATTACKTABLES_H
+
+#include "Enums.h"
+#include <cstdint>
+
+/*
+ * A set of squares on the chess board, with bit (rank * 8 + file) set for each square in the set.
+ */
+using SquareSet = uint64_t;
+
+/*
+ * The unit moves of a piece (the complete set of shortest moves in each direction it may move in).
+ * For knights, pawns and kings this is the set of all moves.
+ */
+struct UnitMoves {
+    int count; // The number of unit moves
+    int moves[8][2]; // The (rank, file) offset of each unit move
+};
+
+inline constexpr UnitMoves pawnUnitMoves[2] = {{3, {{1, 0}, {1, 1}, {1, -1}}},     // Indexed by PieceColour
+                                               {3, {{-1, 0}, {-1, 1}, {-1, -1}}}}; // NB: Pawn captures are dealt with in ChessGame
+inline constexpr UnitMoves rookUnitMoves = {4, {{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
+inline constexpr UnitMoves knightUnitMoves = {8, {{1, 2}, {-1, 2}, {1, -2}, {-1, -2}, {2, 1}, {-2, 1}, {2, -1}, {-2, -1}}};
+inline constexpr UnitMoves bishopUnitMoves = {4, {{1, 1}, {-1, -1}, {1, -1}, {-1, 1}}};
+inline constexpr UnitMoves queenUnitMoves = {8, {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, -1}, {1, -1}, {-1, 1}}};
+inline constexpr UnitMoves kingUnitMoves = {8, {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, -1}, {1, -1}, {-1, 1}}};
+
+/*
+ * The precomputed attack and geometry tables, indexed by square (rank * 8 + file).
+ */
+struct AttackTables {
+    SquareSet knightAttacks[64]; // The squares a knight attacks from each square
+    SquareSet kingAttacks[64]; // The squares a king attacks from each square
+    SquareSet pawnAttacks[2][64]; // Indexed by [PieceColour][square]: the squares a pawn of that colour attacks
+    SquareSet between[64][64]; // The squares strictly between two squares sharing a rank, file or diagonal (empty otherwise)
+};
+
+/*
+ * Obtains the set holding a single square, or the empty set if the coordinates are off the board.
+ *
+ * @param rank The index of the rank of the square (zero indexed).
+ * @param file The index of the file of the square (zero indexed).
+ * @return The set containing only that square.
+ */
+constexpr SquareSet squareSet(int rank, int file) {
+    return (rank >= 0 && rank < 8 && file >= 0 && file < 8) ? (SquareSet(1) << (rank * 8 + file)) : 0;
+}
+
+/*
+ * Determines whether a set contains a square.
+ *
+ * @param set The set of squares.
+ * @param square The index (rank * 8 + file) of the square.
+ * @return true if the square is in the set; false otherwise.
+ */
+constexpr bool containsSquare(SquareSet set, int square) {
+    return (set >> square) & 1;
+}
+
+/*
+ * Removes the lowest square from a non-empty set.
+ *
+ * @param set A reference to the set of squares.
+ * @return The index (rank * 8 + file) of the square removed.
+ */
+inline int popSquare(SquareSet& set) {
+    int square = __builtin_ctzll(set);
+    set &= set - 1;
+    return square;
+}
+
+inline constexpr SquareSet notFileA = 0xFEFEFEFEFEFEFEFEull; // Every square except those on the A file
+inline constexpr SquareSet notFileH = 0x7F7F7F7F7F7F7F7Full; // Every square except those on the H file
+inline constexpr SquareSet notFilesAB = 0xFCFCFCFCFCFCFCFCull; // Every square except those on the A and B files
+inline constexpr SquareSet notFilesGH = 0x3F3F3F3F3F3F3F3Full; // Every square except those on the G and H files
+
+/*
+ * Shifts every square of a set by the same offset, towards higher squares if positive. Squares
+ * shifted along a rank wrap onto the next rank, so callers mask off the files they cannot reach.
+ *
+ * @param set The set of squares.
+ * @param offset The change in square index (rank * 8 + file).
+ * @return The shifted set.
+ */
+constexpr SquareSet shiftSquares(SquareSet set, int offset) {
+    return (offset > 0 ? set << offset : set >> -offset);
+}
+
+/*
+ * Obtains the squares attacked by a whole set of pawns at once.
+ *
+ * @param pawns The squares of the pawns.
+ * @param colour The colour of the pawns.
+ * @return The squares attacked by at least one of the pawns.
+ */
+constexpr SquareSet pawnAttackSet(SquareSet pawns, PieceColour colour) {
+    return (colour == white ? ((pawns << 9) & notFileA) | ((pawns << 7) & notFileH)
+                            : ((pawns >> 7) & notFileA) | ((pawns >> 9) & notFileH));
+}
+
+/*
+ * Obtains the squares attacked by a whole set of knights at once.
+ *
+ * @param knights The squares of the knights.
+ * @return The squares attacked by at least one of the knights.
+ */
+constexpr SquareSet knightAttackSet(SquareSet knights) {
+    SquareSet oneFile = ((knights << 1) & notFileA) | ((knights >> 1) & notFileH);
+    SquareSet twoFiles = ((knights << 2) & notFilesAB) | ((knights >> 2) & notFilesGH);
+    return (oneFile << 16) | (oneFile >> 16) | (twoFiles << 8) | (twoFiles >> 8);
+}
+
+/*
+ * Obtains the squares attacked in one direction by a whole set of sliding pieces at once, with a
+ * Kogge-Stone fill: the pieces are smeared along the direction through empty squares in three
+ * doubling steps, then shifted once more onto the first occupied square (or the edge of the board).
+ *
+ * @param sliders The squares of the sliding pieces.
+ * @param empty The empty squares of the board.
+ * @param offset The change in square index of one step in the direction (+-1, +-7, +-8 or +-9).
+ * @param wrapMask The squares a step in the direction can land on (notFileA for steps towards the H file,
+ *                 notFileH for steps towards the A file, every square for steps along a file).
+ * @return The squares attacked by at least one of the pieces in that direction.
+ */
+constexpr SquareSet slidingAttackSet(SquareSet sliders, SquareSet empty, int offset, SquareSet wrapMask) {
+    SquareSet propagators = empty & wrapMask;
+    sliders |= propagators & shiftSquares(sliders, offset);
+    propagators &= shiftSquares(propagators, offset);
+    sliders |= propagators & shiftSquares(sliders, 2 * offset);
+    propagators &= shiftSquares(propagators, 2 * offset);
+    sliders |= propagators & shiftSquares(sliders, 4 * offset);
+    return shiftSquares(sliders, offset) & wrapMask;
+}
+
+/*
+ * Generates every attack and geometry table.
+ *
+ * @return The complete set of tables.
+ */
+constexpr AttackTables generateAttackTables() {
+    AttackTables tables{};
+
+    for (int square = 0; square < 64; square++) {
+        int rank = square / 8, file = square % 8;
+
+        for (int move = 0; move < 8; move++) {
+            tables.knightAttacks[square] |= squareSet(rank + knightUnitMoves.moves[move][0], file + knightUnitMoves.moves[move][1]);
+            tables.kingAttacks[square] |= squareSet(rank + kingUnitMoves.moves[move][0], file + kingUnitMoves.moves[move][1]);
+        }
+        tables.pawnAttacks[white][square] = squareSet(rank + 1, file - 1) | squareSet(rank + 1, file + 1);
+        tables.pawnAttacks[black][square] = squareSet(rank - 1, file - 1) | squareSet(rank - 1, file + 1);
+
+        // Walk each of the eight directions, recording the path to every square reached
+        for (int direction = 0; direction < 8; direction++) {
+            int rankStep = queenUnitMoves.moves[direction][0], fileStep = queenUnitMoves.moves[direction][1];
+
+            SquareSet path = 0;
+            for (int distance = 1; squareSet(rank + distance * rankStep, file + distance * fileStep) != 0; distance++) {
+                int target = (rank + distance * rankStep) * 8 + (file + distance * fileStep);
+                tables.between[square][target] = path;
+                path |= SquareSet(1) << target;
+            }
+        }
+    }
+    return tables;
+}
+
+inline constexpr AttackTables attackTables = generateAttackTables();
+
+#endif
@@ -0,0 +1,305 @@
+/*
+ * ChessApi.cpp - Implementation file for the C API of the rules engine (see ChessApi.h).
+ *
+ * Every position is parsed strictly and loaded with ChessGame::restorePlayablePosition(), as the
+ * other ways of loading a position assume valid input and exit on some malformed positions. Every
+ * handle's game is silent and evaluates its game state lazily, so that moves are made as cheaply
+ * as possible and the state only when asked.
+ */
+
+#include "ChessApi.h"
+#include "ChessGame.h"
+#include "ChessPiece.h"
+#include "PackedPosition.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <new>
+
+using namespace std;
+
+static_assert(CHESS_FEN_BUFFER_SIZE == maxFenLength + 1, "CHESS_FEN_BUFFER_SIZE must hold any FEN string");
+static_assert(CHESS_MAX_MOVES == maxLegalMoves, "CHESS_MAX_MOVES must match maxLegalMoves");
+static_assert(CHESS_PACKED_POSITION_SIZE == packedPositionSize, "CHESS_PACKED_POSITION_SIZE must match packedPositionSize");
+static_assert(int(CHESS_STATUS_CHECK) == sideInCheck && int(CHESS_STATUS_CHECKMATE) == sideCheckmated &&
+              int(CHESS_STATUS_STALEMATE) == sideStalemated && int(CHESS_STATUS_FIFTY_MOVES) == sideDrawnByFiftyMoves &&
+              int(CHESS_STATUS_INVALID) == positionInvalid,
+              "ChessStatus must match PositionStateFlags");
+static_assert(int(CHESS_PROMOTE_KNIGHT) == promoteToKnight && int(CHESS_PROMOTE_BISHOP) == promoteToBishop &&
+              int(CHESS_PROMOTE_ROOK) == promoteToRook && int(CHESS_PROMOTE_QUEEN) == promoteToQueen,
+              "ChessPromotion must match Promotion");
+
+static const char* const startingPosition = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+static const char promotionCharacters[] = " nbrq"; // Indexed by Promotion
+
+/*
+ * The game behind a handle.
+ */
+struct ChessGameHandle {
+    ChessGame game;
+};
+
+/*
+ * Decodes a move as ChessGame interprets it in the current position: a pawn move to the final
+ * rank without a promotion promotes to a queen, and the promotion of any other move is ignored.
+ *
+ * @return false if the promotion is not a valid ChessPromotion; true otherwise.
+ */
+static bool decodeMove(ChessGame& game, ChessMove raw, Move& move) {
+    Move decoded = Move::fromRaw(raw);
+    if (decoded.getPromotion() > promoteToQueen) {
+        return false;
+    }
+    int origin = decoded.getOrigin(), destination = decoded.getDestination();
+    const ChessPiece* piece = game.chessBoard[origin / 8][origin % 8];
+    bool promoting = (piece != nullptr && piece->getType() == pawn && (destination / 8 == 0 || destination / 8 == 7));
+    Promotion promotion = (!promoting ? noPromotion : (decoded.getPromotion() == noPromotion ? promoteToQueen : decoded.getPromotion()));
+    move = Move(origin, destination, promotion);
+    return true;
+}
+
+
+/****************************** Games ******************************/
+
+/* OBTAINS THE VERSION OF THE API */
+uint32_t chess_api_version(void) {
+    return CHESS_API_VERSION;
+}
+
+/* CREATES A GAME HOLDING THE STARTING POSITION */
+ChessGameHandle* chess_game_create(void) {
+    ChessGameHandle* handle = new (nothrow) ChessGameHandle;
+    if (handle != nullptr) {
+        handle->game.setConsoleOutput(false);
+        handle->game.setLazyGameState(true);
+        handle->game.resetState(startingPosition);
+    }
+    return handle;
+}
+
+/* DESTROYS A GAME */
+void chess_game_destroy(ChessGameHandle* game) {
+    delete game;
+}
+
+/* LOADS A POSITION FROM A FEN STRING */
+int chess_game_load_fen(ChessGameHandle* game, const char* fen) {
+    if (game == nullptr || fen == nullptr) {
+        return CHESS_INVALID_ARGUMENT;
+    }
+    Position position;
+    if (!parseFen(fen, position)) {
+        return CHESS_INVALID_POSITION;
+    }
+    return (game->game.restorePlayablePosition(position) ? CHESS_OK : CHESS_INVALID_POSITION);
+}
+
+/* LOADS A POSITION IN THE PACKED POSITION FORMAT */
+int chess_game_load_packed(ChessGameHandle* game, const uint8_t* packed) {
+    if (game == nullptr || packed == nullptr) {
+        return CHESS_INVALID_ARGUMENT;
+    }
+    PackedPosition packing;
+    memcpy(packing.bytes, packed, packedPositionSize);
+    Position position;
+    if (!unpackPosition(packing, position)) {
+        return CHESS_INVALID_POSITION;
+    }
+    return (game->game.restorePlayablePosition(position) ? CHESS_OK : CHESS_INVALID_POSITION);
+}
+
+/* WRITES THE CURRENT POSITION AS A FEN STRING */
+int chess_game_fen(ChessGameHandle* game, char* buffer, size_t size) {
+    if (game == nullptr || buffer == nullptr) {
+        return CHESS_INVALID_ARGUMENT;
+    }
+    char fenString[maxFenLength + 1];
+    size_t length = formatFen(game->game.savePosition(), fenString);
+    if (length >= size) {
+        return CHESS_INVALID_ARGUMENT;
+    }
+    memcpy(buffer, fenString, length + 1);
+    return static_cast<int>(length);
+}
+
+/* WRITES THE CURRENT POSITION IN THE PACKED POSITION FORMAT */
+int chess_game_packed(ChessGameHandle* game, uint8_t* packed) {
+    if (game == nullptr || packed == nullptr) {
+        return CHESS_INVALID_ARGUMENT;
+    }
+    memcpy(packed, game->game.savePackedPosition().bytes, packedPositionSize);
+    return CHESS_OK;
+}
+
+/* OBTAINS THE SIDE TO MOVE */
+int chess_game_side_to_move(ChessGameHandle* game) {
+    if (game == nullptr) {
+        return CHESS_INVALID_ARGUMENT;
+    }
+    return game->game.getTurn();
+}
+
+/* OBTAINS THE STATUS OF THE CURRENT POSITION FOR THE SIDE TO MOVE */
+int chess_game_status(ChessGameHandle* game) {
+    if (game == nullptr) {
+        return CHESS_INVALID_ARGUMENT;
+    }
+    return game->game.classifyCurrentPosition();
+}
+
+/* GENERATES THE LEGAL MOVES OF THE CURRENT POSITION */
+int chess_game_legal_moves(ChessGameHandle* game, ChessMove* moves, size_t capacity) {
+    if (game == nullptr || moves == nullptr) {
+        return CHESS_INVALID_ARGUMENT;
+    }
+    Move moveList[maxLegalMoves];
+    int count = game->game.generateLegalMoves(moveList);
+    if (static_cast<size_t>(count) > capacity) {
+        return CHESS_INVALID_ARGUMENT;
+    }
+    for (int index = 0; index < count; index++) {
+        moves[index] = moveList[index].getRaw();
+    }
+    return count;
+}
+
+/* MAKES A MOVE IF IT IS LEGAL */
+int chess_game_make_move(ChessGameHandle* game, ChessMove move) {
+    if (game == nullptr) {
+        return CHESS_INVALID_ARGUMENT;
+    }
+    Move decoded;
+    if (decodeMove(game->game, move, decoded) && game->game.submitMove(decoded)) {
+        return CHESS_OK;
+    }
+    // Moves are rarely rejected, so only then is it worth finding out whether the game has ended
+    uint8_t ended = sideCheckmated | sideStalemated | sideDrawnByFiftyMoves;
+    return (game->game.classifyCurrentPosition() & ended ? CHESS_GAME_OVER : CHESS_ILLEGAL_MOVE);
+}
+
+
+/****************************** Moves ******************************/
+
+/* PARSES A MOVE IN UCI NOTATION */
+int chess_move_parse(const char* text, ChessMove* move) {
+    if (text == nullptr || move == nullptr) {
+        return CHESS_INVALID_ARGUMENT;
+    }
+    for (int index = 0; index < 4; index++) {
+        char minimum = (index % 2 == 0 ? 'a' : '1');
+        if (text[index] < minimum || text[index] > minimum + 7) {
+            return CHESS_INVALID_ARGUMENT;
+        }
+    }
+    int promotion = noPromotion;
+    if (text[4] != '\0') {
+        const char* found = strchr(promotionCharacters + 1, text[4]);
+        if (found == nullptr || text[5] != '\0') {
+            return CHESS_INVALID_ARGUMENT;
+        }
+        promotion = static_cast<int>(found - promotionCharacters);
+    }
+    *move = Move((text[1] - '1') * 8 + (text[0] - 'a'), (text[3] - '1') * 8 + (text[2] - 'a'), static_cast<Promotion>(promotion)).getRaw();
+    return CHESS_OK;
+}
+
+/* WRITES A MOVE IN UCI NOTATION */
+int chess_move_format(ChessMove move, char* buffer) {
+    Move decoded = Move::fromRaw(move);
+    if (buffer == nullptr || decoded.getPromotion() > promoteToQueen) {
+        return CHESS_INVALID_ARGUMENT;
+    }
+    int squares[2] = {decoded.getOrigin(), decoded.getDestination()};
+    for (int index = 0; index < 2; index++) {
+        buffer[index * 2] = static_cast<char>('a' + squares[index] % 8);
+        buffer[index * 2 + 1] = static_cast<char>('1' + squares[index] / 8);
+    }
+    int length = 4;
+    if (decoded.getPromotion() != noPromotion) {
+        buffer[length++] = promotionCharacters[decoded.getPromotion()];
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+
+/****************************** Batches ******************************/
+
+/* CHECKS WHETHER EACH OF MANY MOVES IS LEGAL IN THE CURRENT POSITION */
+int chess_game_check_moves(ChessGameHandle* game, const ChessMove* moves, size_t count, uint8_t* legal) {
+    if (game == nullptr || (count > 0 && (moves == nullptr || legal == nullptr)) || count > INT_MAX) {
+        return CHESS_INVALID_ARGUMENT;
+    }
+
+    // No move can be made once the 50-move rule has ended the game (nor after checkmate or stalemate, with no legal moves)
+    Move moveList[maxLegalMoves];
+    int legalCount = (game->game.getHalfMoveCounter() >= 100 ? 0 : game->game.generateLegalMoves(moveList));
+    uint16_t sortedMoves[maxLegalMoves];
+    for (int index = 0; index < legalCount; index++) {
+        sortedMoves[index] = moveList[index].getRaw();
+    }
+    sort(sortedMoves, sortedMoves + legalCount);
+
+    int legalMoves = 0;
+    for (size_t index = 0; index < count; index++) {
+        Move decoded;
+        legal[index] = (decodeMove(game->game, moves[index], decoded) &&
+                        binary_search(sortedMoves, sortedMoves + legalCount, decoded.getRaw()));
+        legalMoves += legal[index];
+    }
+    return legalMoves;
+}
+
+/* MAKES A SEQUENCE OF MOVES, STOPPING AT THE FIRST THAT IS ILLEGAL */
+int chess_game_make_moves(ChessGameHandle* game, const ChessMove* moves, size_t count) {
+    if (game == nullptr || (count > 0 && moves == nullptr) || count > INT_MAX) {
+        return CHESS_INVALID_ARGUMENT;
+    }
+    size_t made = 0;
+    while (made < count) {
+        Move decoded;
+        if (!decodeMove(game->game, moves[made], decoded) || !game->game.submitMove(decoded)) {
+            break;
+        }
+        made++;
+    }
+    return static_cast<int>(made);
+}
+
+/* CHECKS MANY FEN STRINGS AND OBTAINS THE STATUS OF EACH PLAYABLE POSITION */
+int chess_game_check_fens(ChessGameHandle* game, const char* const* fens, size_t count, uint8_t* statuses) {
+    if (game == nullptr || (count > 0 && (fens == nullptr || statuses == nullptr)) || count > INT_MAX) {
+        return CHESS_INVALID_ARGUMENT;
+    }
+    Position previous = game->game.savePosition();
+    int playable = 0;
+    for (size_t index = 0; index < count; index++) {
+        statuses[index] = (fens[index] != nullptr ? game->game.classifyPosition(fens[index]) : CHESS_STATUS_INVALID);
+        playable += (statuses[index] != CHESS_STATUS_INVALID);
+    }
+    game->game.restorePosition(previous);
+    return playable;
+}
+
+/* CHECKS MANY PACKED POSITIONS AND OBTAINS THE STATUS OF EACH PLAYABLE POSITION */
+int chess_game_check_packed(ChessGameHandle* game, const uint8_t* packed, size_t count, uint8_t* statuses) {
+    if (game == nullptr || (count > 0 && (packed == nullptr || statuses == nullptr)) || count > INT_MAX) {
+        return CHESS_INVALID_ARGUMENT;
+    }
+    Position previous = game->game.savePosition();
+    int playable = 0;
+    for (size_t index = 0; index < count; index++) {
+        PackedPosition packing;
+        memcpy(packing.bytes, packed + index * packedPositionSize, packedPositionSize);
+        Position position;
+        if (unpackPosition(packing, position) && game->game.restorePlayablePosition(position)) {
+            statuses[index] = game->game.classifyCurrentPosition();
+            playable++;
+        }
+        else {
+            statuses[index] = CHESS_STATUS_INVALID;
+        }
+    }
+    game->game.restorePosition(previous);
+    return playable;
+}
@@ -0,0 +1,267 @@
+/*
+ * ChessApi.h - Header file for the C API of the rules engine, built as the shared library
+ * libchess.so (make libchess.so) for programs in other languages to call in-process.
+ *
+ * The API is plain C with a stable ABI: games are opaque handles, moves are 16-bit integers,
+ * and every call reports failure through its return value (a negative ChessResult) rather than
+ * by exception, console output or exit. Only the symbols declared here are exported.
+ *
+ * A move is encoded as origin | (destination << 6) | (promotion << 12), where squares are
+ * numbered rank * 8 + file from a1 = 0 to h8 = 63 and the promotion is one of ChessPromotion.
+ * A pawn move to the final rank without a promotion promotes to a queen; the promotion of any
+ * other move is ignored. Castling is the king's move of two squares.
+ *
+ * Each handle must be used by one thread at a time; different handles may be used on different
+ * threads at once. Threefold repetition is not detected, as a handle holds a position rather
+ * than the history of a game.
+ */
+
+#ifndef CHESSAPI_H
+#define CHESSAPI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The version of the API, incremented whenever a declaration here changes incompatibly */
+#define CHESS_API_VERSION 1
+
+/* The size of a buffer that holds any FEN string written by chess_game_fen(), including the terminating null */
+#define CHESS_FEN_BUFFER_SIZE 97
+
+/* The size of a move list that holds the legal moves of any position */
+#define CHESS_MAX_MOVES 256
+
+/* The size of a packed position (see PackedPosition.h) */
+#define CHESS_PACKED_POSITION_SIZE 32
+
+/* A game, holding one position at a time */
+typedef struct ChessGameHandle ChessGameHandle;
+
+/* A move in its 16-bit encoding */
+typedef uint16_t ChessMove;
+
+/* The results of calls: zero or more on success, negative on failure */
+typedef enum ChessResult {
+    CHESS_OK = 0,
+    CHESS_INVALID_ARGUMENT = -1, /* A pointer argument is null, or a buffer is too small */
+    CHESS_INVALID_POSITION = -2, /* The FEN string or packed position is malformed or describes an unplayable position */
+    CHESS_ILLEGAL_MOVE = -3, /* The move is not legal in the current position */
+    CHESS_GAME_OVER = -4 /* The game has ended by checkmate, stalemate or the 50-move rule, so no move can be made */
+} ChessResult;
+
+/* The status of the current position for the side to move, combined as bit flags */
+typedef enum ChessStatus {
+    CHESS_STATUS_CHECK = 1, /* The side to move is in check */
+    CHESS_STATUS_CHECKMATE = 2, /* The side to move is in check and has no legal moves */
+    CHESS_STATUS_STALEMATE = 4, /* The side to move is not in check and has no legal moves */
+    CHESS_STATUS_FIFTY_MOVES = 8, /* The side to move has legal moves but the 50-move rule has ended the game */
+    CHESS_STATUS_INVALID = 128 /* Set by the batch position checks for a position that could not be loaded */
+} ChessStatus;
+
+/* The promotion of a move */
+typedef enum ChessPromotion {
+    CHESS_PROMOTE_NONE = 0,
+    CHESS_PROMOTE_KNIGHT = 1,
+    CHESS_PROMOTE_BISHOP = 2,
+    CHESS_PROMOTE_ROOK = 3,
+    CHESS_PROMOTE_QUEEN = 4
+} ChessPromotion;
+
+
+/****************************** Games ******************************/
+
+/*
+ * Obtains the version of the API that the library implements.
+ *
+ * @return CHESS_API_VERSION, as the library was built.
+ */
+uint32_t chess_api_version(void);
+
+/*
+ * Creates a game holding the starting position.
+ *
+ * @return The new game, or null if it could not be allocated.
+ */
+ChessGameHandle* chess_game_create(void);
+
+/*
+ * Destroys a game, freeing its memory.
+ *
+ * @param game The game (null is ignored).
+ */
+void chess_game_destroy(ChessGameHandle* game);
+
+/*
+ * Loads a position from a FEN string. The counters may be omitted, in which case they are 0 and
+ * 1. The position must be playable: one king and at most 16 pieces of each colour, no pawn on
+ * the first or last rank, the side not to move not in check, castling rights only with the king
+ * and rook on their starting squares, and an en passant square only behind a pawn that has just
+ * advanced two squares.
+ *
+ * @param game The game.
+ * @param fen The null-terminated FEN string (with single spaces between fields).
+ *
+ * @return CHESS_OK, or CHESS_INVALID_POSITION (leaving the game unchanged).
+ */
+int chess_game_load_fen(ChessGameHandle* game, const char* fen);
+
+/*
+ * Loads a position in the packed position format (see PackedPosition.h), which must be
+ * playable, as for chess_game_load_fen().
+ *
+ * @param game The game.
+ * @param packed The CHESS_PACKED_POSITION_SIZE bytes of the packed position.
+ *
+ * @return CHESS_OK, or CHESS_INVALID_POSITION (leaving the game unchanged).
+ */
+int chess_game_load_packed(ChessGameHandle* game, const uint8_t* packed);
+
+/*
+ * Writes the current position as a full FEN string.
+ *
+ * @param game The game.
+ * @param buffer A buffer to store the null-terminated FEN string in.
+ * @param size The size of the buffer (CHESS_FEN_BUFFER_SIZE is always enough).
+ *
+ * @return The length of the FEN string, or CHESS_INVALID_ARGUMENT if the buffer is too small.
+ */
+int chess_game_fen(ChessGameHandle* game, char* buffer, size_t size);
+
+/*
+ * Writes the current position in the packed position format.
+ *
+ * @param game The game.
+ * @param packed A buffer of at least CHESS_PACKED_POSITION_SIZE bytes to store the packed position in.
+ *
+ * @return CHESS_OK.
+ */
+int chess_game_packed(ChessGameHandle* game, uint8_t* packed);
+
+/*
+ * Obtains the side to move.
+ *
+ * @param game The game.
+ *
+ * @return 0 for white or 1 for black.
+ */
+int chess_game_side_to_move(ChessGameHandle* game);
+
+/*
+ * Obtains the status of the current position for the side to move.
+ *
+ * @param game The game.
+ *
+ * @return A combination of ChessStatus flags (zero if the side to move is not in check and the game continues).
+ */
+int chess_game_status(ChessGameHandle* game);
+
+/*
+ * Generates the legal moves of the current position. A pawn move to the final rank appears
+ * once for each promotion.
+ *
+ * @param game The game.
+ * @param moves A buffer to store the moves in.
+ * @param capacity The number of moves the buffer holds (CHESS_MAX_MOVES is always enough).
+ *
+ * @return The number of legal moves, or CHESS_INVALID_ARGUMENT if the buffer is too small for them.
+ */
+int chess_game_legal_moves(ChessGameHandle* game, ChessMove* moves, size_t capacity);
+
+/*
+ * Makes a move, if it is legal in the current position.
+ *
+ * @param game The game.
+ * @param move The move.
+ *
+ * @return CHESS_OK, CHESS_ILLEGAL_MOVE or CHESS_GAME_OVER (leaving the game unchanged on failure).
+ */
+int chess_game_make_move(ChessGameHandle* game, ChessMove move);
+
+
+/****************************** Moves ******************************/
+
+/*
+ * Parses a move in UCI long algebraic notation (e.g. "e2e4" or "e7e8q").
+ *
+ * @param text The null-terminated move.
+ * @param move A reference to store the move in.
+ *
+ * @return CHESS_OK, or CHESS_INVALID_ARGUMENT if the text is not a move in UCI notation.
+ */
+int chess_move_parse(const char* text, ChessMove* move);
+
+/*
+ * Writes a move in UCI long algebraic notation.
+ *
+ * @param move The move.
+ * @param buffer A buffer of at least 6 characters to store the null-terminated move in.
+ *
+ * @return The length of the move (4, or 5 with a promotion), or CHESS_INVALID_ARGUMENT if its promotion is invalid.
+ */
+int chess_move_format(ChessMove move, char* buffer);
+
+
+/****************************** Batches ******************************/
+
+/*
+ * Checks whether each of many moves is legal in the current position, which is left unchanged.
+ * The legal moves are generated once for the whole batch.
+ *
+ * @param game The game.
+ * @param moves The moves to check.
+ * @param count The number of moves.
+ * @param legal An array of count bytes to store 1 (legal) or 0 (illegal) in for each move.
+ *
+ * @return The number of legal moves among them.
+ */
+int chess_game_check_moves(ChessGameHandle* game, const ChessMove* moves, size_t count, uint8_t* legal);
+
+/*
+ * Makes a sequence of moves in order (e.g. to replay a game), stopping at the first that is
+ * illegal. The status is evaluated once, when it is next queried, rather than after each move.
+ *
+ * @param game The game.
+ * @param moves The moves to make.
+ * @param count The number of moves.
+ *
+ * @return The number of moves made (equal to count if every move was legal).
+ */
+int chess_game_make_moves(ChessGameHandle* game, const ChessMove* moves, size_t count);
+
+/*
+ * Checks many FEN strings, as chess_game_load_fen() would, and obtains the status of each
+ * playable position. The game is used to load each one, and holds its previous position again
+ * on return.
+ *
+ * @param game The game.
+ * @param fens The null-terminated FEN strings.
+ * @param count The number of FEN strings.
+ * @param statuses An array of count bytes to store the ChessStatus flags of each position in
+ *                 (CHESS_STATUS_INVALID if it is malformed or unplayable).
+ *
+ * @return The number of playable positions among them.
+ */
+int chess_game_check_fens(ChessGameHandle* game, const char* const* fens, size_t count, uint8_t* statuses);
+
+/*
+ * Checks many consecutive packed positions, as chess_game_check_fens() does for FEN strings.
+ *
+ * @param game The game.
+ * @param packed The packed positions, CHESS_PACKED_POSITION_SIZE bytes each.
+ * @param count The number of packed positions.
+ * @param statuses An array of count bytes to store the ChessStatus flags of each position in
+ *                 (CHESS_STATUS_INVALID if it is malformed or unplayable).
+ *
+ * @return The number of playable positions among them.
+ */
+int chess_game_check_packed(ChessGameHandle* game, const uint8_t* packed, size_t count, uint8_t* statuses);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,1234 @@
+/*
+ * ChessBench.cpp - Benchmarks for the chess engine. Each benchmark is a named
+ * section; running without arguments runs every section.
+ *
+ * Usage: bench [section...]
+ */
+
+#include "AllocationTracker.h"
+#include "Analysis.h"
+#include "ChessApi.h"
+#include "ChessGame.h"
+#include "Executor.h"
+#include "GameRecord.h"
+#include "MateSolver.h"
+#include "MoveCache.h"
+#include "MonteCarloSearch.h"
+#include "Move.h"
+#include "PackedPosition.h"
+#include "PawnHashTable.h"
+#include "Position.h"
+#include "PositionClassifier.h"
+#include "RandomGames.h"
+#include "Search.h"
+#include "TranspositionTable.h"
+#include "Zobrist.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+static const char* const startingPosition = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+/*
+ * A small corpus of complete games, written as letter-integer coordinate pairs.
+ */
+struct SampleGame {
+    const char* startFen;
+    vector<const char*> moves; // Alternating origin and destination squares
+};
+
+static const vector<SampleGame> sampleGames = {
+    {startingPosition, {"E2", "E4", "E7", "E6", "D2", "D4", "D7", "D5", "B1", "C3", "F8", "B4", "F1", "D3", "B4", "C3",
+                        "B2", "C3", "H7", "H6", "C1", "A3", "B8", "D7", "D1", "E2", "D5", "E4", "D3", "E4", "G8", "F6",
+                        "E4", "D3", "B7", "B6", "E2", "E6", "F7", "E6", "D3", "G6"}}, // Alekhine vs. Vasic (1931)
+    {startingPosition, {"E2", "E4", "E7", "E5", "F1", "C4", "B8", "C6", "D1", "H5", "G8", "F6", "H5", "F7"}}, // Scholar's mate
+    {startingPosition, {"E2", "E4", "E7", "E5", "G1", "F3", "B8", "C6", "F1", "C4", "F8", "C5", "E1", "G1", "G8", "F6",
+                        "D2", "D3", "E8", "G8", "C1", "G5", "H7", "H6", "G5", "H4", "D7", "D6", "B1", "C3", "C8", "G4"}}
+};
+
+/* RETURNS THE NUMBER OF SECONDS ELAPSED SINCE A GIVEN TIME */
+static double secondsSince(Clock::time_point start) {
+    return chrono::duration<double>(Clock::now() - start).count();
+}
+
+/* RETURNS A MOVE AS ITS ORIGIN AND DESTINATION SQUARES (E.G. "E2E4") */
+static string moveText(Move move) {
+    char origin[3], destination[3];
+    move.toStrings(origin, destination);
+    return string(origin) + destination;
+}
+
+
+/****************************** BENCHMARK: GAME RECORD FORMATS ******************************/
+
+/*
+ * Compares the size and replay speed of the binary game record format against
+ * text coordinate pairs ("E2 E4" per line), which is how game histories were stored.
+ */
+static void benchmarkGameRecords() {
+    const int repetitions = 300;
+
+    // ENCODE THE CORPUS IN BOTH FORMATS
+    ostringstream text, binary;
+    GameRecordWriter writer(binary);
+    int gameCount = 0, moveCount = 0;
+
+    for (int repetition = 0; repetition < repetitions; repetition++) {
+        for (const SampleGame& game : sampleGames) {
+            text << game.startFen << "\n";
+            writer.beginGame(game.startFen);
+            for (size_t index = 0; index < game.moves.size(); index += 2) {
+                text << game.moves[index] << " " << game.moves[index + 1] << "\n";
+                writer.addMove(Move::fromStrings(game.moves[index], game.moves[index + 1]));
+                moveCount++;
+            }
+            text << "\n";
+            writer.endGame();
+            gameCount++;
+        }
+    }
+
+    string textData = text.str(), binaryData = binary.str();
+
+    ChessGame game;
+    game.setConsoleOutput(false);
+
+    // REPLAY THE TEXT FORMAT
+    Clock::time_point start = Clock::now();
+    istringstream textInput(textData);
+    string line;
+    while (getline(textInput, line)) {
+        if (line.size() > 5) { // FEN line
+            game.loadState(line.c_str());
+        }
+        else if (line.size() == 5) { // "E2 E4"
+            line[2] = '\0';
+            game.submitMove(line.c_str(), line.c_str() + 3);
+        }
+    }
+    double textSeconds = secondsSince(start);
+
+    // REPLAY THE BINARY FORMAT
+    start = Clock::now();
+    istringstream binaryInput(binaryData);
+    GameRecordReader reader(binaryInput);
+    int replayed = 0;
+    while (reader.replayGame(game)) {
+        replayed++;
+    }
+    double binarySeconds = secondsSince(start);
+
+    cout << "Game records: " << gameCount << " games, " << moveCount << " moves\n";
+    cout << "  text coordinates: " << textData.size() << " bytes, replayed in " << textSeconds * 1000 << " ms\n";
+    cout << "  binary record:    " << binaryData.size() << " bytes, replayed in " << binarySeconds * 1000 << " ms"
+         << " (" << replayed << " games, " << reader.getSkippedGames() << " skipped)\n";
+}
+
+
+/****************************** BENCHMARK: LEGAL MOVE CACHE ******************************/
+
+/*
+ * Compares replaying the sample games with every move validated from scratch against
+ * replaying them with a shared legal move cache attached.
+ */
+static void benchmarkMoveCache() {
+    const int repetitions = 300;
+
+    MoveCache moveCache(1 << 12);
+    for (int cached = 0; cached < 2; cached++) {
+        ChessGame game;
+        game.setConsoleOutput(false);
+        game.setMoveCache(cached ? &moveCache : nullptr);
+
+        Clock::time_point start = Clock::now();
+        int moves = 0;
+        for (int repetition = 0; repetition < repetitions; repetition++) {
+            for (const SampleGame& sample : sampleGames) {
+                game.loadState(sample.startFen);
+                for (size_t index = 0; index < sample.moves.size(); index += 2) {
+                    moves += game.submitMove(sample.moves[index], sample.moves[index + 1]);
+                }
+            }
+        }
+        double seconds = secondsSince(start);
+
+        cout << (cached ? "Move cache:   " : "No move cache: ") << moves << " moves in " << seconds * 1000 << " ms ("
+             << static_cast<long>(moves / seconds) << " moves/s)\n";
+    }
+
+    MoveCacheStatistics statistics = moveCache.getStatistics();
+    cout << "  hit rate " << statistics.hitRate() * 100 << "% (" << statistics.hits << " hits, " << statistics.misses << " misses)\n";
+}
+
+
+/****************************** BENCHMARK: PERFT ******************************/
+
+/*
+ * Counts the leaf nodes of the legal move tree of the standard perft test positions,
+ * checking each count against its published value.
+ */
+static void benchmarkPerft() {
+    struct PerftPosition {
+        const char* fen;
+        int depth;
+        uint64_t expectedNodes;
+    };
+    static const PerftPosition positions[] = {
+        {startingPosition, 4, 197281},
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, 97862}, // "Kiwipete"
+        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624},
+        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3, 9467},
+        {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379}
+    };
+
+    ChessGame game;
+    game.setConsoleOutput(false);
+
+    uint64_t totalNodes = 0;
+    double totalSeconds = 0;
+    for (const PerftPosition& position : positions) {
+        game.loadState(position.fen);
+
+        Clock::time_point start = Clock::now();
+        uint64_t nodes = game.perft(position.depth);
+        double seconds = secondsSince(start);
+
+        cout << "Perft " << position.depth << ": " << nodes << " nodes in " << seconds * 1000 << " ms"
+             << (nodes == position.expectedNodes ? "" : " (MISMATCH)") << "\n";
+        totalNodes += nodes;
+        totalSeconds += seconds;
+    }
+    cout << "  " << static_cast<long>(totalNodes / totalSeconds) << " nodes/s\n";
+}
+
+
+/****************************** BENCHMARK: POSITION SNAPSHOTS ******************************/
+
+/*
+ * Compares restoring a Position snapshot against reloading the FEN string, then splits a
+ * perft count across threads, each restoring the same snapshot into its own game.
+ */
+static void benchmarkSnapshots() {
+    const int repetitions = 20000;
+    const char* const fens[] = {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                                "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K1R1 b Qkq - 1 1"};
+
+    ChessGame game;
+    game.setConsoleOutput(false);
+
+    // RELOAD BY FEN, ALTERNATING BETWEEN TWO POSITIONS ONE MOVE APART
+    Clock::time_point start = Clock::now();
+    for (int repetition = 0; repetition < repetitions; repetition++) {
+        game.loadState(fens[repetition % 2]);
+    }
+    double loadSeconds = secondsSince(start);
+
+    // RESTORE SNAPSHOTS OF THE SAME TWO POSITIONS
+    Position positions[2];
+    for (int index = 0; index < 2; index++) {
+        game.loadState(fens[index]);
+        positions[index] = game.savePosition();
+    }
+    start = Clock::now();
+    for (int repetition = 0; repetition < repetitions; repetition++) {
+        game.restorePosition(positions[repetition % 2]);
+    }
+    double restoreSeconds = secondsSince(start);
+
+    cout << "Snapshots: " << sizeof(Position) << " bytes each\n";
+    cout << "  loadState:       " << static_cast<long>(repetitions / loadSeconds) << " loads/s\n";
+    cout << "  restorePosition: " << static_cast<long>(repetitions / restoreSeconds) << " restores/s\n";
+
+    // SPLIT A PERFT COUNT BY ROOT MOVE ACROSS THREADS, SHARING ONE SNAPSHOT
+    const int depth = 4;
+    game.restorePosition(positions[0]);
+    Move rootMoves[maxLegalMoves];
+    int rootMoveCount = game.generateLegalMoves(rootMoves);
+
+    start = Clock::now();
+    uint64_t serialNodes = game.perft(depth);
+    double serialSeconds = secondsSince(start);
+
+    unsigned threadCount = max(thread::hardware_concurrency(), 1u);
+    vector<uint64_t> threadNodes(threadCount, 0);
+    vector<thread> threads;
+    const Position& root = positions[0];
+
+    start = Clock::now();
+    for (unsigned index = 0; index < threadCount; index++) {
+        threads.emplace_back([&, index]() {
+            ChessGame threadGame;
+            threadGame.setConsoleOutput(false);
+            for (int move = index; move < rootMoveCount; move += threadCount) {
+                threadGame.restorePosition(root);
+                threadGame.submitMove(rootMoves[move]);
+                threadNodes[index] += threadGame.perft(depth - 1);
+            }
+        });
+    }
+    uint64_t parallelNodes = 0;
+    for (unsigned index = 0; index < threadCount; index++) {
+        threads[index].join();
+        parallelNodes += threadNodes[index];
+    }
+    double parallelSeconds = secondsSince(start);
+
+    cout << "  perft " << depth << " serial:   " << serialNodes << " nodes in " << serialSeconds * 1000 << " ms\n";
+    cout << "  perft " << depth << " parallel: " << parallelNodes << " nodes in " << parallelSeconds * 1000 << " ms ("
+         << threadCount << " threads)" << (parallelNodes == serialNodes ? "" : " (MISMATCH)") << "\n";
+}
+
+
+/****************************** BENCHMARK: BATCH CLASSIFICATION ******************************/
+
+/*
+ * Compares classifying a large batch of positions one loadState() at a time against
+ * classifyPositions() on one thread and on every hardware thread, checking each status.
+ */
+static void benchmarkClassification() {
+    struct ClassifiedPosition {
+        const char* fen;
+        uint8_t expectedStatus;
+    };
+    static const ClassifiedPosition samples[] = {
+        {startingPosition, 0},
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 0},
+        {"rnbqkbnr/ppp2ppp/3p4/1B2p3/4P3/8/PPPP1PPP/RNBQK1NR b KQkq - 1 3", sideInCheck},
+        {"rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3", sideInCheck | sideCheckmated}, // Fool's mate
+        {"7k/5Q2/6K1/8/8/8/8/8 b - - 0 1", sideStalemated},
+        {"8/8/4k3/8/8/4K3/8/R7 w - - 100 80", sideDrawnByFiftyMoves}
+    };
+    const size_t sampleCount = sizeof(samples) / sizeof(samples[0]);
+    const size_t positionCount = 60000;
+
+    vector<const char*> fens(positionCount);
+    for (size_t index = 0; index < positionCount; index++) {
+        fens[index] = samples[index % sampleCount].fen;
+    }
+    vector<uint8_t> statuses(positionCount);
+
+    // ONE loadState() PER POSITION, AS BEFORE
+    ChessGame game;
+    game.setConsoleOutput(false);
+    Clock::time_point start = Clock::now();
+    for (size_t index = 0; index < positionCount; index++) {
+        game.loadState(fens[index]);
+    }
+    double loadSeconds = secondsSince(start);
+    cout << "Classification: " << positionCount << " positions\n";
+    cout << "  loadState:                   " << static_cast<long>(positionCount / loadSeconds) << " positions/s\n";
+
+    vector<unsigned> threadCounts = {1};
+    if (thread::hardware_concurrency() > 1) {
+        threadCounts.push_back(thread::hardware_concurrency());
+    }
+    for (unsigned threadCount : threadCounts) {
+        fill(statuses.begin(), statuses.end(), 0xFF);
+        start = Clock::now();
+        classifyPositions(fens.data(), positionCount, statuses.data(), threadCount);
+        double seconds = secondsSince(start);
+
+        size_t mismatches = 0;
+        for (size_t index = 0; index < positionCount; index++) {
+            mismatches += (statuses[index] != samples[index % sampleCount].expectedStatus);
+        }
+        cout << "  classifyPositions (" << threadCount << " thread" << (threadCount == 1 ? "): " : "s):") << "  "
+             << static_cast<long>(positionCount / seconds) << " positions/s" << (mismatches == 0 ? "" : " (MISMATCH)") << "\n";
+    }
+}
+
+
+/****************************** BENCHMARK: ASYNCHRONOUS ANALYSIS ******************************/
+
+/*
+ * Runs many analyses at once on a shared executor, then measures how quickly analyses
+ * stop when cancelled and when their deadlines pass.
+ */
+static void benchmarkAnalysis() {
+    const int analysisCount = 48;
+    const char* const fens[] = {startingPosition,
+                                "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                                "r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 4 4"};
+
+    ChessGame game;
+    game.setConsoleOutput(false);
+    Executor executor;
+
+    // CHECK THAT A MATE IN ONE IS FOUND
+    game.loadState("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+    AnalysisRequest mateRequest;
+    mateRequest.position = game.savePosition();
+    AnalysisResult mate = startAnalysis(executor, mateRequest).get();
+    bool mateFound = (mate.best.bestMove == Move::fromStrings("A1", "A8") && mate.best.score == mateScore - 1);
+    cout << "Analysis: mate in one found at depth " << mate.best.depth << (mateFound ? "" : " (MISMATCH)") << "\n";
+
+    // MANY CONCURRENT ANALYSES TO A FIXED DEPTH, STREAMING EACH COMPLETED DEPTH
+    atomic<int> updates(0);
+    vector<future<AnalysisResult>> results;
+    Clock::time_point start = Clock::now();
+    for (int index = 0; index < analysisCount; index++) {
+        game.loadState(fens[index % 3]);
+        AnalysisRequest request;
+        request.position = game.savePosition();
+        request.maxDepth = 3;
+        request.onDepthCompleted = [&updates](const SearchResult&) { updates++; };
+        results.push_back(startAnalysis(executor, request));
+    }
+    uint64_t nodes = 0;
+    for (future<AnalysisResult>& result : results) {
+        nodes += result.get().best.nodes;
+    }
+    double seconds = secondsSince(start);
+    cout << "  " << analysisCount << " analyses to depth 3 on " << executor.getThreadCount() << " threads: " << seconds * 1000 << " ms ("
+         << updates << " partial results, " << static_cast<long>(nodes / seconds) << " nodes/s)\n";
+
+    // CANCEL A BATCH OF DEEP ANALYSES PART-WAY THROUGH
+    results.clear();
+    vector<CancellationToken> tokens(analysisCount);
+    for (int index = 0; index < analysisCount; index++) {
+        game.loadState(fens[index % 3]);
+        AnalysisRequest request;
+        request.position = game.savePosition();
+        request.maxDepth = maxSearchDepth;
+        request.cancellation = tokens[index];
+        results.push_back(startAnalysis(executor, request));
+    }
+    this_thread::sleep_for(chrono::milliseconds(100));
+    start = Clock::now();
+    for (CancellationToken& token : tokens) {
+        token.cancel();
+    }
+    int cancelled = 0;
+    for (future<AnalysisResult>& result : results) {
+        cancelled += (result.get().outcome == analysisCancelled);
+    }
+    cout << "  cancelled " << cancelled << " analyses, all stopped within " << secondsSince(start) * 1000 << " ms\n";
+
+    // LET A BATCH OF DEEP ANALYSES RUN INTO THEIR DEADLINE
+    results.clear();
+    Clock::time_point deadline = Clock::now() + chrono::milliseconds(100);
+    for (int index = 0; index < analysisCount; index++) {
+        game.loadState(fens[index % 3]);
+        AnalysisRequest request;
+        request.position = game.savePosition();
+        request.maxDepth = maxSearchDepth;
+        request.deadline = deadline;
+        results.push_back(startAnalysis(executor, request));
+    }
+    int deepest = 0;
+    for (future<AnalysisResult>& result : results) {
+        deepest = max(deepest, result.get().best.depth);
+    }
+    cout << "  100 ms deadline: all stopped " << chrono::duration<double>(Clock::now() - deadline).count() * 1000
+         << " ms after it (deepest depth " << deepest << ")\n";
+}
+
+
+/****************************** BENCHMARK: MULTI-PV SEARCH ******************************/
+
+/*
+ * Compares finding the best few lines in one multi-PV search against running one independent
+ * search per line, each excluding the root moves of the lines found before it.
+ */
+static void benchmarkMultiPV() {
+    const int lineCount = 3, depth = 4;
+    const size_t tableEntries = 1 << 16;
+    const char* const fens[] = {startingPosition,
+                                "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                                "r1bqkbnr/pppp1ppp/2n5/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R b KQkq - 3 3"};
+
+    ChessGame game;
+    game.setConsoleOutput(false);
+
+    double multiSeconds = 0, independentSeconds = 0;
+    uint64_t multiNodes = 0, independentNodes = 0;
+    int matchingScores = 0;
+    for (const char* fen : fens) {
+        game.loadState(fen);
+
+        // ONE MULTI-PV SEARCH, DEEPENING EVERY LINE TOGETHER
+        Clock::time_point start = Clock::now();
+        TranspositionTable table(tableEntries);
+        Search search(game, table);
+        SearchResult lines[lineCount];
+        int found = 0;
+        for (int iteration = 1; iteration <= depth; iteration++) {
+            search.searchLines(iteration, lineCount, lines, found);
+        }
+        multiSeconds += secondsSince(start);
+        multiNodes += search.getNodes();
+
+        // ONE INDEPENDENT SEARCH PER LINE, EXCLUDING THE MOVES ALREADY FOUND
+        start = Clock::now();
+        Move excluded[lineCount];
+        for (int line = 0; line < found; line++) {
+            TranspositionTable lineTable(tableEntries);
+            Search lineSearch(game, lineTable);
+            lineSearch.setExcludedRootMoves(excluded, line);
+            SearchResult result;
+            for (int iteration = 1; iteration <= depth; iteration++) {
+                lineSearch.searchDepth(iteration, result);
+            }
+            excluded[line] = result.bestMove;
+            independentNodes += lineSearch.getNodes();
+            matchingScores += (result.score == lines[line].score);
+        }
+        independentSeconds += secondsSince(start);
+    }
+
+    cout << "Multi-PV: best " << lineCount << " lines to depth " << depth << " in " << sizeof(fens) / sizeof(fens[0]) << " positions\n";
+    cout << "  one multi-PV search:      " << multiSeconds * 1000 << " ms, " << multiNodes << " nodes\n";
+    cout << "  " << lineCount << " independent searches:  " << independentSeconds * 1000 << " ms, " << independentNodes << " nodes ("
+         << matchingScores << " of " << lineCount * sizeof(fens) / sizeof(fens[0]) << " line scores agree)\n";
+}
+
+
+/****************************** BENCHMARK: MATE SOLVER ******************************/
+
+/*
+ * Compares proving mate puzzles with the df-pn mate solver against a brute-force alpha-beta
+ * search to the full depth of the mate, and checks that each mate is not found a move sooner.
+ */
+static void benchmarkMateSolver() {
+    struct MatePuzzle {
+        const char* fen;
+        int mateInMoves;
+    };
+    static const MatePuzzle puzzles[] = {
+        {"kbK5/pp6/1P6/8/8/8/8/R7 w - - 0 1", 2},
+        {"r2qkb1r/pp2nppp/3p4/2pNN1B1/2BnP3/3P4/PPP2PPP/R2bK2R w KQkq - 1 1", 2},
+        {"r1b2k1r/ppppq3/5N1p/4P2Q/4PP2/1B6/PP5P/n2K2R1 w - - 1 1", 2},
+        {"5rk1/1p1q2bp/p2pN1p1/2pP2Bn/2P3P1/1P6/P4QKP/5R2 w - - 1 1", 2},
+        {"r5rk/5p1p/5R2/4B3/8/8/7P/7K w - - 0 1", 3},
+        {"r1b1kb1r/pppp1ppp/5q2/4n3/3KP3/2N3PN/PPP4P/R1BQ1B1R b kq - 0 1", 3}
+    };
+    const uint64_t nodeLimit = 10000000;
+
+    ChessGame game;
+    game.setConsoleOutput(false);
+    MateSolver solver(game, 16 << 20);
+
+    double solverSeconds = 0, searchSeconds = 0;
+    uint64_t solverNodes = 0, searchNodes = 0;
+    int wrong = 0;
+    for (const MatePuzzle& puzzle : puzzles) {
+        game.loadState(puzzle.fen);
+
+        Clock::time_point start = Clock::now();
+        MateResult mate = solver.solve(puzzle.mateInMoves, nodeLimit);
+        MateResult shorter = solver.solve(puzzle.mateInMoves - 1, nodeLimit);
+        solverSeconds += secondsSince(start);
+        solverNodes += mate.nodes + shorter.nodes;
+        wrong += (mate.verdict != mateProven) + (puzzle.mateInMoves > 1 && shorter.verdict != mateDisproven);
+
+        // Brute force: search every line one ply beyond the mate, as the quiescence search does not detect mate
+        start = Clock::now();
+        TranspositionTable table(1 << 16);
+        Search search(game, table);
+        SearchResult result;
+        for (int depth = 1; depth <= 2 * puzzle.mateInMoves; depth++) {
+            search.searchDepth(depth, result);
+        }
+        searchSeconds += secondsSince(start);
+        searchNodes += search.getNodes();
+        wrong += (result.score != mateScore - (2 * puzzle.mateInMoves - 1));
+    }
+
+    size_t puzzleCount = sizeof(puzzles) / sizeof(puzzles[0]);
+    cout << "Mate solver: " << puzzleCount << " puzzles (mate in 2 and 3), each also disproven a move sooner"
+         << (wrong == 0 ? "" : " (MISMATCH)") << "\n";
+    cout << "  df-pn:       " << solverSeconds * 1000 << " ms, " << solverNodes << " nodes, "
+         << (solver.getMemoryUsage() >> 20) << " MB table\n";
+    cout << "  alpha-beta:  " << searchSeconds * 1000 << " ms, " << searchNodes << " nodes\n";
+}
+
+
+/****************************** BENCHMARK: MONTE CARLO TREE SEARCH ******************************/
+
+/*
+ * Measures playouts per second of the Monte Carlo tree search on 1, 2 and 4 threads, compares the
+ * two playout policies, and checks how much of the tree is kept when the root advances by a move.
+ */
+static void benchmarkMonteCarlo() {
+    const uint64_t playouts = 500;
+    ChessGame game;
+    game.setConsoleOutput(false);
+    game.loadState("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4");
+    Position position = game.savePosition();
+
+    cout << "Monte Carlo tree search: " << playouts << " playouts from an Italian game position\n";
+    double singleThreadRate = 0;
+    for (unsigned threadCount : {1u, 2u, 4u}) {
+        MonteCarloSearch search(1 << 20);
+        search.setPosition(position);
+        MonteCarloStatistics statistics = search.search(playouts, threadCount);
+        double rate = statistics.playouts / statistics.seconds;
+        if (threadCount == 1) {
+            singleThreadRate = rate;
+        }
+        cout << "  " << threadCount << " thread(s):    " << static_cast<uint64_t>(rate) << " playouts/s (x"
+             << rate / singleThreadRate << "), " << statistics.nodesUsed << " nodes, best "
+             << moveText(search.bestMove()) << "\n";
+    }
+
+    MonteCarloSearch captures(1 << 20, capturePreferringPlayouts);
+    captures.setPosition(position);
+    MonteCarloStatistics statistics = captures.search(playouts, 1);
+    cout << "  capture-preferring playouts: " << static_cast<uint64_t>(statistics.playouts / statistics.seconds)
+         << " playouts/s, best " << moveText(captures.bestMove()) << "\n";
+
+    // Tree reuse: advance by the best move, keeping its subtree, and search on from there
+    Move best = captures.bestMove();
+    captures.advance(best);
+    uint32_t keptVisits = captures.getRootVisits();
+    captures.search(playouts, 1);
+    cout << "  after " << moveText(best) << ": " << keptVisits << " of " << playouts << " root visits kept, "
+         << captures.getRootVisits() << " after searching on\n";
+}
+
+
+/****************************** BENCHMARK: RANDOM GAMES ******************************/
+
+/*
+ * Measures the throughput of generating random legal games on 1 and 2 threads, and checks that
+ * every game read back from the record stream is legal and reproduced by its seed.
+ */
+static void benchmarkRandomGames() {
+    const uint64_t gameCount = 200;
+    cout << "Random games: " << gameCount << " games from the starting position\n";
+
+    for (unsigned threadCount : {1u, 2u}) {
+        stringstream stream;
+        RandomGameStatistics statistics = generateRandomGames(startingPosition, gameCount, 1, stream, threadCount);
+
+        // Read the games back, replaying each through the validated move path and again from its seed
+        GameRecordReader reader(stream);
+        ChessGame replay, generator;
+        replay.setConsoleOutput(false);
+        generator.setConsoleOutput(false);
+        generator.loadState(startingPosition);
+        RandomGame randomGame;
+        int games = 0, wrong = 0;
+        while (reader.beginGame()) {
+            games++;
+            Move move;
+            size_t ply = 0;
+            playRandomGame(generator, reader.getSeed(), randomGame);
+            replay.loadState(reader.getStartFen().c_str());
+            while (reader.nextMove(move)) {
+                wrong += (!replay.submitMove(move) || ply >= randomGame.moves.size() || randomGame.moves[ply] != move);
+                ply++;
+            }
+            wrong += (ply != randomGame.moves.size() || reader.getResult() != randomGame.result);
+        }
+
+        cout << "  " << threadCount << " thread(s): " << static_cast<uint64_t>(statistics.moves / statistics.seconds)
+             << " moves/s, " << statistics.games / statistics.seconds << " games/s (" << statistics.moves / statistics.games
+             << " moves per game), " << statistics.endings[checkmateEnding] << " checkmates"
+             << (games == static_cast<int>(gameCount) && wrong == 0 ? "" : " (MISMATCH)") << "\n";
+    }
+}
+
+
+/****************************** BENCHMARK: LAZY GAME STATE ******************************/
+
+/*
+ * Compares replaying random games with the game state evaluated after every move, evaluated
+ * lazily (with and without a query after every move) and skipped by bulk application, and
+ * checks that every mode ends each game in the same state.
+ */
+static void benchmarkLazyGameState() {
+    const int gameCount = 50;
+    ChessGame game;
+    game.setConsoleOutput(false);
+    game.loadState(startingPosition);
+    vector<RandomGame> games(gameCount);
+    size_t moveCount = 0;
+    for (int index = 0; index < gameCount; index++) {
+        playRandomGame(game, index + 1, games[index]);
+        moveCount += games[index].moves.size();
+    }
+
+    enum ReplayMode {eagerReplay, lazyReplay, lazyQueriedReplay, bulkReplay};
+    const char* const modeNames[] = {"eager (every move)", "lazy, never queried", "lazy, queried every move", "bulk submitMoves()"};
+    int finalStates[4][gameCount];
+
+    cout << "Lazy game state: replaying " << gameCount << " random games (" << moveCount << " moves)\n";
+    for (int mode = eagerReplay; mode <= bulkReplay; mode++) {
+        game.setLazyGameState(mode == lazyReplay || mode == lazyQueriedReplay);
+        size_t made = 0;
+        Clock::time_point start = Clock::now();
+        for (int index = 0; index < gameCount; index++) {
+            const vector<Move>& moves = games[index].moves;
+            game.loadState(startingPosition);
+            if (mode == bulkReplay) {
+                made += game.submitMoves(moves.data(), moves.size());
+            }
+            for (size_t ply = 0; mode != bulkReplay && ply < moves.size(); ply++) {
+                made += game.submitMove(moves[ply]);
+                if (mode == lazyQueriedReplay) {
+                    game.isInProgress();
+                }
+            }
+            finalStates[mode][index] = game.isInProgress() * 4 + game.isInCheck(white) * 2 + game.isInCheck(black);
+        }
+        double seconds = secondsSince(start);
+
+        bool agrees = (made == moveCount);
+        for (int index = 0; index < gameCount; index++) {
+            agrees = agrees && finalStates[mode][index] == finalStates[eagerReplay][index];
+        }
+        cout << "  " << modeNames[mode] << ": " << static_cast<uint64_t>(made / seconds) << " moves/s"
+             << (agrees ? "" : " (MISMATCH)") << "\n";
+    }
+    game.setLazyGameState(false);
+}
+
+
+/****************************** BENCHMARK: ATTACK MAPS ******************************/
+
+/*
+ * Compares mapping the squares attacked by both colours with attackedSquares() against querying
+ * each of the 64 squares with squareAttacked(), over the positions of random games, and checks
+ * that both give the same maps.
+ */
+static void benchmarkAttackMaps() {
+    const int gameCount = 20, repetitions = 8;
+    ChessGame game;
+    game.setConsoleOutput(false);
+    game.loadState(startingPosition);
+
+    // Collect every position of some random games
+    vector<Position> positions;
+    RandomGame randomGame;
+    for (int index = 0; index < gameCount; index++) {
+        playRandomGame(game, index + 1, randomGame);
+        vector<ChessGame::MoveUndo> undos(randomGame.moves.size());
+        for (size_t ply = 0; ply < randomGame.moves.size(); ply++) {
+            positions.push_back(game.savePosition());
+            game.makeLegalMove(randomGame.moves[ply], undos[ply]);
+        }
+        for (size_t ply = randomGame.moves.size(); ply > 0; ply--) {
+            game.unmakeLegalMove(undos[ply - 1]);
+        }
+    }
+
+    double setwiseSeconds = 0, squareSeconds = 0;
+    SquareSet setwiseMaps[2], squareMaps[2];
+    size_t mismatches = 0;
+    for (const Position& position : positions) {
+        game.restorePosition(position);
+
+        Clock::time_point start = Clock::now();
+        for (int repetition = 0; repetition < repetitions; repetition++) {
+            setwiseMaps[white] = game.attackedSquares(white);
+            setwiseMaps[black] = game.attackedSquares(black);
+        }
+        setwiseSeconds += secondsSince(start);
+
+        start = Clock::now();
+        for (int repetition = 0; repetition < repetitions; repetition++) {
+            squareMaps[white] = squareMaps[black] = 0;
+            for (int square = 0; square < 64; square++) {
+                squareMaps[white] |= SquareSet(game.squareAttacked(square, white)) << square;
+                squareMaps[black] |= SquareSet(game.squareAttacked(square, black)) << square;
+            }
+        }
+        squareSeconds += secondsSince(start);
+        mismatches += (setwiseMaps[white] != squareMaps[white] || setwiseMaps[black] != squareMaps[black]);
+    }
+
+    double maps = static_cast<double>(positions.size()) * repetitions;
+    cout << "Attack maps (both colours): " << positions.size() << " positions from random games"
+         << (mismatches == 0 ? "" : " (MISMATCH)") << "\n";
+    cout << "  attackedSquares():     " << static_cast<uint64_t>(maps / setwiseSeconds) << " maps/s\n";
+    cout << "  64 x squareAttacked(): " << static_cast<uint64_t>(maps / squareSeconds) << " maps/s (x"
+         << squareSeconds / setwiseSeconds << " slower)\n";
+}
+
+
+/****************************** BENCHMARK: PIECE POOL ******************************/
+
+// Unrelated positions: openings, middlegames and endgames
+static const char* const mixedPositions[] = {
+    startingPosition,
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+    "4k3/8/8/8/8/8/4P3/4K3 w - - 0 1",
+    "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1"
+};
+
+/*
+ * Measures loadState() throughput over a small FEN corpus, and the heap allocations made per
+ * load and per capture or promotion, now that pieces are constructed in each game's piece pool.
+ */
+static void benchmarkPiecePool() {
+    const char* const* corpus = mixedPositions;
+    const int corpusSize = sizeof(mixedPositions) / sizeof(mixedPositions[0]), loads = 20000;
+
+    ChessGame game;
+    game.setConsoleOutput(false);
+    uint64_t allocationsBefore = getAllocationCount();
+    Clock::time_point start = Clock::now();
+    for (int index = 0; index < loads; index++) {
+        game.loadState(corpus[index % corpusSize]);
+    }
+    double seconds = secondsSince(start);
+    double allocationsPerLoad = static_cast<double>(getAllocationCount() - allocationsBefore) / loads;
+
+    game.loadState("4k3/1P6/8/3p4/4P3/8/8/4K3 w - - 0 1");
+    allocationsBefore = getAllocationCount();
+    game.submitMove("E4", "D5");
+    uint64_t captureAllocations = getAllocationCount() - allocationsBefore;
+    game.submitMove("E8", "D7");
+    allocationsBefore = getAllocationCount();
+    game.submitMove("B7", "B8");
+    uint64_t promotionAllocations = getAllocationCount() - allocationsBefore;
+
+    cout << "Piece pool: " << loads << " loads of " << corpusSize << " FEN strings\n";
+    cout << "  " << static_cast<uint64_t>(loads / seconds) << " loads/s, " << allocationsPerLoad << " allocations per load\n";
+    cout << "  allocations per submitMove(): " << captureAllocations << " for a capture, " << promotionAllocations
+         << " for a promotion\n";
+}
+
+
+/****************************** BENCHMARK: IN-PLACE RESET ******************************/
+
+/*
+ * Measures loads/s of one reused game over two FEN corpora: the successive positions of a game,
+ * as a batch worker reading game records sees them, and the unrelated positions of the piece
+ * pool benchmark. loadState() and resetState() both rebuild only the squares that change;
+ * resetState() also skips the output stream and, with lazy evaluation, the game state detection.
+ */
+static void benchmarkReset() {
+    static const char* const gamePositions[] = {
+        startingPosition,
+        "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1",
+        "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq e6 0 2",
+        "rnbqkbnr/pppp1ppp/8/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq - 1 2",
+        "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+        "r1bqkbnr/pppp1ppp/2n5/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R b KQkq - 3 3",
+        "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+        "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQ1RK1 b kq - 5 4"
+    };
+    struct Corpus {
+        const char* name;
+        const char* const* fens;
+        int size;
+    };
+    const Corpus corpora[] = {{"successive positions of a game", gamePositions, sizeof(gamePositions) / sizeof(gamePositions[0])},
+                              {"unrelated positions", mixedPositions, sizeof(mixedPositions) / sizeof(mixedPositions[0])}};
+    const int loads = 40000;
+
+    cout << "In-place reset: " << loads << " loads into one game\n";
+    for (const Corpus& corpus : corpora) {
+        ChessGame game;
+        game.setConsoleOutput(false);
+
+        Clock::time_point start = Clock::now();
+        for (int index = 0; index < loads; index++) {
+            game.loadState(corpus.fens[index % corpus.size]);
+        }
+        double loadSeconds = secondsSince(start);
+
+        start = Clock::now();
+        for (int index = 0; index < loads; index++) {
+            game.resetState(corpus.fens[index % corpus.size]);
+        }
+        double resetSeconds = secondsSince(start);
+
+        game.setLazyGameState(true);
+        start = Clock::now();
+        for (int index = 0; index < loads; index++) {
+            game.resetState(corpus.fens[index % corpus.size]);
+        }
+        double lazySeconds = secondsSince(start);
+
+        cout << "  " << corpus.name << " (" << corpus.size << " FEN strings):\n";
+        cout << "    loadState():          " << static_cast<uint64_t>(loads / loadSeconds) << " loads/s\n";
+        cout << "    resetState():         " << static_cast<uint64_t>(loads / resetSeconds) << " loads/s\n";
+        cout << "    resetState() (lazy):  " << static_cast<uint64_t>(loads / lazySeconds) << " loads/s\n";
+    }
+}
+
+
+/****************************** BENCHMARK: PAWN HASH TABLE ******************************/
+
+/*
+ * How a tree walk scores the pawn structure of each position it visits.
+ */
+enum PawnScoring {noPawnScoring, cachedPawnScoring, uncachedPawnScoring, pawnHashCheck};
+
+/* WALKS EVERY POSITION OF A TREE OF LEGAL MOVES, SCORING THE PAWNS OF EACH AND CHECKING ITS PAWN HASH */
+static void walkPawnStructures(ChessGame& game, int depth, PawnScoring scoring, PawnHashTable& table, int64_t& scoreSum, uint64_t& mismatches) {
+    if (scoring == cachedPawnScoring) {
+        scoreSum += table.evaluate(game);
+    }
+    else if (scoring == uncachedPawnScoring) {
+        PawnEntry entry = evaluatePawnStructure(game.pieceSquares(white, pawn), game.pieceSquares(black, pawn));
+        scoreSum += entry.score;
+    }
+    else if (scoring == pawnHashCheck) { // Check the incrementally updated pawn hash against one computed from scratch
+        uint64_t hash = 0;
+        for (PieceColour colour : {white, black}) {
+            SquareSet pawns = game.pieceSquares(colour, pawn);
+            while (pawns != 0) {
+                hash ^= zobristKeys.pieces[colour][pawn][popSquare(pawns)];
+            }
+        }
+        mismatches += (hash != game.pawnHash());
+    }
+    if (depth == 0) {
+        return;
+    }
+
+    Move moveList[256];
+    int count = game.generateLegalMoves(moveList);
+    ChessGame::MoveUndo undo;
+    for (int index = 0; index < count; index++) {
+        game.makeLegalMove(moveList[index], undo);
+        walkPawnStructures(game, depth - 1, scoring, table, scoreSum, mismatches);
+        game.unmakeLegalMove(undo);
+    }
+}
+
+/*
+ * Measures the cost of scoring pawn structures with and without the pawn hash table over every
+ * position of some trees of legal moves (walked depth first, as a search visits them), checking
+ * the incrementally updated pawn hash against one computed from scratch, and reports the hit rate
+ * of the table in the alpha-beta search.
+ */
+static void benchmarkPawnHashTable() {
+    const int depth = 3, searchDepth = 4;
+    const char* const fens[] = {startingPosition,
+                                "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                                "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4"};
+
+    ChessGame game;
+    game.setConsoleOutput(false);
+    PawnHashTable table(4096);
+    double seconds[3] = {0, 0, 0}; // Indexed by PawnScoring
+    int64_t scoreSum = 0;
+    uint64_t mismatches = 0, positions = 0;
+    for (const char* fen : fens) {
+        game.loadState(fen);
+        positions += 1;
+        for (int level = 1; level <= depth; level++) {
+            positions += game.perft(level);
+        }
+        for (PawnScoring scoring : {noPawnScoring, cachedPawnScoring, uncachedPawnScoring}) {
+            Clock::time_point start = Clock::now();
+            walkPawnStructures(game, depth, scoring, table, scoreSum, mismatches);
+            seconds[scoring] += secondsSince(start);
+        }
+        walkPawnStructures(game, depth, pawnHashCheck, table, scoreSum, mismatches);
+    }
+    PawnHashStatistics walkStatistics = table.getStatistics();
+
+    // The cost of an evaluation is the time a walk takes beyond that of the walk without scoring
+    double cachedCost = max(seconds[cachedPawnScoring] - seconds[noPawnScoring], 1e-9);
+    double uncachedCost = max(seconds[uncachedPawnScoring] - seconds[noPawnScoring], 1e-9);
+    cout << "Pawn hash table: " << positions << " positions in trees of depth " << depth
+         << (mismatches == 0 ? "" : " (PAWN HASH MISMATCH)") << "\n";
+    cout << "  cached:   " << static_cast<uint64_t>(positions / cachedCost) << " evaluations/s, hit rate "
+         << walkStatistics.hitRate() * 100 << "%\n";
+    cout << "  uncached: " << static_cast<uint64_t>(positions / uncachedCost) << " evaluations/s (pawn terms only)\n";
+
+    uint64_t searchHits = 0, searchMisses = 0, nodes = 0;
+    for (const char* fen : fens) {
+        game.loadState(fen);
+        TranspositionTable transpositionTable(1 << 16);
+        Search search(game, transpositionTable);
+        SearchResult result;
+        for (int iteration = 1; iteration <= searchDepth; iteration++) {
+            search.searchDepth(iteration, result);
+        }
+        searchHits += search.getPawnHashStatistics().hits;
+        searchMisses += search.getPawnHashStatistics().misses;
+        nodes += search.getNodes();
+    }
+    cout << "  search to depth " << searchDepth << ": " << nodes << " nodes, " << searchHits + searchMisses
+         << " pawn evaluations, hit rate " << PawnHashStatistics{searchHits, searchMisses}.hitRate() * 100 << "%\n";
+}
+
+
+/****************************** BENCHMARK: PACKED POSITIONS ******************************/
+
+/*
+ * Compares the packed position format with FEN strings on the positions of some random games:
+ * the space each takes, how fast each loads into a game (both without evaluating the game
+ * state) and how fast each is exported from one. Every position is also checked to survive a
+ * round trip through the packed format unchanged.
+ */
+static void benchmarkPackedPositions() {
+    const int gameCount = 40, repetitions = 4;
+    ChessGame game;
+    game.setConsoleOutput(false);
+    game.loadState(startingPosition);
+
+    // Collect every position of some random games, as FEN strings and packed
+    vector<string> fens;
+    vector<PackedPosition> packedPositions;
+    RandomGame randomGame;
+    char fenString[maxFenLength + 1];
+    for (int index = 0; index < gameCount; index++) {
+        playRandomGame(game, index + 1, randomGame);
+        vector<ChessGame::MoveUndo> undos(randomGame.moves.size());
+        for (size_t ply = 0; ply < randomGame.moves.size(); ply++) {
+            formatFen(game.savePosition(), fenString);
+            fens.push_back(fenString);
+            packedPositions.push_back(game.savePackedPosition());
+            game.makeLegalMove(randomGame.moves[ply], undos[ply]);
+        }
+        for (size_t ply = randomGame.moves.size(); ply > 0; ply--) {
+            game.unmakeLegalMove(undos[ply - 1]);
+        }
+    }
+
+    size_t fenBytes = 0, mismatches = 0;
+    for (size_t index = 0; index < fens.size(); index++) {
+        fenBytes += fens[index].size() + 1; // One per line
+        Position position;
+        mismatches += !unpackPosition(packedPositions[index], position);
+        formatFen(position, fenString);
+        mismatches += (fens[index] != fenString);
+    }
+
+    // Both loads check that the position is playable, so loadPlayableState() is the FEN string load compared
+    game.setLazyGameState(true);
+    Clock::time_point start = Clock::now();
+    for (int repetition = 0; repetition < repetitions; repetition++) {
+        for (const string& fen : fens) {
+            game.loadPlayableState(fen.c_str());
+        }
+    }
+    double fenLoadSeconds = secondsSince(start);
+
+    start = Clock::now();
+    for (int repetition = 0; repetition < repetitions; repetition++) {
+        for (const PackedPosition& packed : packedPositions) {
+            game.loadPackedPosition(packed);
+        }
+    }
+    double packedLoadSeconds = secondsSince(start);
+
+    // Each position is loaded once and then exported repeatedly in each format, timing only the exports
+    double fenExportSeconds = 0, packedExportSeconds = 0;
+    for (const PackedPosition& packed : packedPositions) {
+        game.loadPackedPosition(packed);
+        start = Clock::now();
+        for (int repetition = 0; repetition < repetitions; repetition++) {
+            formatFen(game.savePosition(), fenString);
+        }
+        fenExportSeconds += secondsSince(start);
+        start = Clock::now();
+        for (int repetition = 0; repetition < repetitions; repetition++) {
+            mismatches += (memcmp(game.savePackedPosition().bytes, packed.bytes, packedPositionSize) != 0);
+        }
+        packedExportSeconds += secondsSince(start);
+    }
+
+    double loads = static_cast<double>(fens.size()) * repetitions;
+    cout << "Packed positions: " << fens.size() << " positions from random games"
+         << (mismatches == 0 ? "" : " (ROUND TRIP MISMATCH)") << "\n";
+    cout << "  size:   FEN " << static_cast<double>(fenBytes) / fens.size() << " bytes/position, packed "
+         << packedPositionSize << " (x" << static_cast<double>(fenBytes) / (fens.size() * packedPositionSize) << " smaller)\n";
+    cout << "  load:   loadPlayableState() " << static_cast<uint64_t>(loads / fenLoadSeconds) << " positions/s, loadPackedPosition() "
+         << static_cast<uint64_t>(loads / packedLoadSeconds) << " positions/s (x" << fenLoadSeconds / packedLoadSeconds << ")\n";
+    cout << "  export: formatFen() " << static_cast<uint64_t>(loads / fenExportSeconds) << " positions/s, savePackedPosition() "
+         << static_cast<uint64_t>(loads / packedExportSeconds) << " positions/s (x" << fenExportSeconds / packedExportSeconds << ")\n";
+}
+
+
+/****************************** BENCHMARK: C API ******************************/
+
+/*
+ * Measures what the batch entry points of the C API save over one call per item, on the
+ * positions of some random games: checking candidate moves (each position's legal moves plus as
+ * many arbitrary moves) one per call, which generates the legal moves for every candidate,
+ * against one call per position; and checking positions one per call against one call for all.
+ */
+static void benchmarkCApi() {
+    const int gameCount = 10;
+    ChessGame game;
+    game.setConsoleOutput(false);
+    game.loadState(startingPosition);
+
+    // Collect the positions of some random games, packed, with their candidate moves
+    vector<uint8_t> packedPositions;
+    vector<vector<ChessMove>> candidates;
+    RandomGame randomGame;
+    Move moveList[maxLegalMoves];
+    uint64_t randomState = 1;
+    for (int index = 0; index < gameCount; index++) {
+        playRandomGame(game, index + 1, randomGame);
+        vector<ChessGame::MoveUndo> undos(randomGame.moves.size());
+        for (size_t ply = 0; ply < randomGame.moves.size(); ply++) {
+            PackedPosition packed = game.savePackedPosition();
+            packedPositions.insert(packedPositions.end(), packed.bytes, packed.bytes + packedPositionSize);
+            int count = game.generateLegalMoves(moveList);
+            vector<ChessMove> positionCandidates;
+            for (int move = 0; move < count; move++) {
+                positionCandidates.push_back(moveList[move].getRaw());
+                randomState = randomState * 6364136223846793005ull + 1442695040888963407ull;
+                positionCandidates.push_back(static_cast<ChessMove>((randomState >> 40) & 0xFFF)); // Without promotion
+            }
+            candidates.push_back(positionCandidates);
+            game.makeLegalMove(randomGame.moves[ply], undos[ply]);
+        }
+        for (size_t ply = randomGame.moves.size(); ply > 0; ply--) {
+            game.unmakeLegalMove(undos[ply - 1]);
+        }
+    }
+    size_t positionCount = candidates.size(), candidateCount = 0;
+    for (const vector<ChessMove>& positionCandidates : candidates) {
+        candidateCount += positionCandidates.size();
+    }
+
+    ChessGameHandle* handle = chess_game_create();
+    uint8_t legal[2 * maxLegalMoves];
+    size_t singleLegal = 0, batchLegal = 0;
+    double singleSeconds = 0, batchSeconds = 0;
+    for (size_t index = 0; index < positionCount; index++) {
+        chess_game_load_packed(handle, packedPositions.data() + index * packedPositionSize);
+        const vector<ChessMove>& positionCandidates = candidates[index];
+        Clock::time_point start = Clock::now();
+        for (ChessMove move : positionCandidates) {
+            singleLegal += chess_game_check_moves(handle, &move, 1, legal);
+        }
+        singleSeconds += secondsSince(start);
+        start = Clock::now();
+        batchLegal += chess_game_check_moves(handle, positionCandidates.data(), positionCandidates.size(), legal);
+        batchSeconds += secondsSince(start);
+    }
+
+    vector<uint8_t> statuses(positionCount);
+    Clock::time_point start = Clock::now();
+    for (size_t index = 0; index < positionCount; index++) {
+        chess_game_check_packed(handle, packedPositions.data() + index * packedPositionSize, 1, &statuses[index]);
+    }
+    double singlePositionSeconds = secondsSince(start);
+    start = Clock::now();
+    int playable = chess_game_check_packed(handle, packedPositions.data(), positionCount, statuses.data());
+    double batchPositionSeconds = secondsSince(start);
+    chess_game_destroy(handle);
+
+    cout << "C API: " << positionCount << " positions from random games, " << candidateCount << " candidate moves\n";
+    cout << "  moves:     one per call " << static_cast<uint64_t>(candidateCount / singleSeconds) << " moves/s, batched "
+         << static_cast<uint64_t>(candidateCount / batchSeconds) << " moves/s (x" << singleSeconds / batchSeconds << "), "
+         << batchLegal << " legal" << (singleLegal == batchLegal ? "" : " (MISMATCH)") << "\n";
+    cout << "  positions: one per call " << static_cast<uint64_t>(positionCount / singlePositionSeconds)
+         << " positions/s, batched " << static_cast<uint64_t>(positionCount / batchPositionSeconds) << " positions/s (x"
+         << singlePositionSeconds / batchPositionSeconds << "), " << playable << " playable\n";
+}
+
+
+/****************************** BENCHMARK: TAKEBACKS ******************************/
+
+/*
+ * Compares taking back moves from the history of random games with undoMoves() against
+ * rebuilding each game without them, by loading the starting position and submitting the moves
+ * that remain, and checks that both give the same position.
+ */
+static void benchmarkTakebacks() {
+    const int gameCount = 50;
+    const int takebackCounts[] = {1, 10, 50};
+    ChessGame game;
+    game.setConsoleOutput(false);
+    game.loadState(startingPosition);
+    vector<RandomGame> games(gameCount);
+    for (int index = 0; index < gameCount; index++) {
+        playRandomGame(game, index + 1, games[index]);
+    }
+
+    cout << "Takebacks: " << gameCount << " random games\n";
+    for (int takebacks : takebackCounts) {
+        uint64_t measured = 0, mismatches = 0;
+        double undoSeconds = 0, rebuildSeconds = 0;
+        for (const RandomGame& randomGame : games) {
+            const vector<Move>& moves = randomGame.moves;
+            if (moves.size() < static_cast<size_t>(takebacks)) {
+                continue;
+            }
+            game.loadState(startingPosition);
+            game.setHistoryLimit(moves.size());
+            game.submitMoves(moves.data(), moves.size());
+            Clock::time_point start = Clock::now();
+            game.undoMoves(takebacks);
+            game.isInProgress();
+            undoSeconds += secondsSince(start);
+            PackedPosition undonePosition = game.savePackedPosition();
+
+            start = Clock::now();
+            game.loadState(startingPosition);
+            for (size_t ply = 0; ply + takebacks < moves.size(); ply++) {
+                game.submitMove(moves[ply]);
+            }
+            game.isInProgress();
+            rebuildSeconds += secondsSince(start);
+            PackedPosition rebuiltPosition = game.savePackedPosition();
+            mismatches += (memcmp(undonePosition.bytes, rebuiltPosition.bytes, packedPositionSize) != 0);
+            measured++;
+        }
+        cout << "  " << takebacks << " move(s) in " << measured << " games: undoMoves() " << undoSeconds * 1e6 / measured
+             << " us, rebuild " << rebuildSeconds * 1e6 / measured << " us per takeback (x" << rebuildSeconds / undoSeconds
+             << ")" << (mismatches == 0 ? "" : " (MISMATCH)") << "\n";
+    }
+    game.setHistoryLimit(0);
+}
+
+
+/****************************** MAIN ******************************/
+
+struct BenchmarkSection {
+    const char* name;
+    void (*run)();
+};
+
+static const BenchmarkSection sections[] = {
+    {"records", benchmarkGameRecords},
+    {"movecache", benchmarkMoveCache},
+    {"perft", benchmarkPerft},
+    {"snapshot", benchmarkSnapshots},
+    {"classify", benchmarkClassification},
+    {"analysis", benchmarkAnalysis},
+    {"multipv", benchmarkMultiPV},
+    {"mate", benchmarkMateSolver},
+    {"mcts", benchmarkMonteCarlo},
+    {"randomgames", benchmarkRandomGames},
+    {"lazystate", benchmarkLazyGameState},
+    {"attacks", benchmarkAttackMaps},
+    {"pool", benchmarkPiecePool},
+    {"reset", benchmarkReset},
+    {"pawnhash", benchmarkPawnHashTable},
+    {"packed", benchmarkPackedPositions},
+    {"capi", benchmarkCApi},
+    {"takeback", benchmarkTakebacks}
+};
+
+int main(int argc, char** argv) {
+    for (const BenchmarkSection& section : sections) {
+        bool selected = (argc == 1);
+        for (int arg = 1; arg < argc; arg++) {
+            if (strcmp(argv[arg], section.name) == 0) {
+                selected = true;
+            }
+        }
+        if (selected) {
+            section.run();
+        }
+    }
+    return 0;
+}
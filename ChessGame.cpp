@@ -10,8 +10,13 @@
   */
 
 #include <iostream>
+#include "AttackTables.h"
 #include "ChessGame.h"
 #include "ChessPiece.h"
+#include "ColourTraits.h"
+#include "MoveCache.h"
+#include "Zobrist.h"
+#include <algorithm>
 #include <cmath>
 #include <map>
 #include <stdint.h>
@@ -23,7 +28,8 @@ using namespace std;
 /****************************** ChessGame - Member Function Definitions ******************************/
 
 /* DEFAULT CONSTRUCTOR */
-ChessGame::ChessGame() : pieceAtDestinationSquare(false), whiteInCheck(false), blackInCheck(false), blackKing(nullptr), whiteKing(nullptr) {
+ChessGame::ChessGame() : pieceAtDestinationSquare(false), whiteInCheck(false), blackInCheck(false), blackKing(nullptr), whiteKing(nullptr), 
+                         silentStream(nullptr), output(&cout) {
     for (int rank = 0; rank < 8; rank++) {
         for (int file = 0; file < 8; file++) {
             chessBoard[rank][file] = nullptr;
@@ -39,11 +45,61 @@ ChessGame::~ChessGame() {
 /* DECODES A FEN STRING AND LOADS THE STATE OF A NEW CHESS GAME */
 void ChessGame::loadState(const char* fenString) {
 
-    cleanChessBoard(); // Clear any previously loaded chess game
+    decodeFenString(fenString);
+    console() << "A new board state is loaded!\n";
+    //printBoard();
+
+    // Simulate the opponent finishing their turn to detect if board loaded in a state of check/checkmate/stalemate/draw
+    turn = (turn == white ? black : white); 
+    detectGameState();
+    turn = (turn == white ? black : white);
+}
+
+/* LOADS A FEN STRING WITHOUT OUTPUT AND CLASSIFIES THE POSITION FOR THE SIDE TO MOVE */
+uint8_t ChessGame::classifyPosition(const char* fenString) {
+
+    if (!loadPlayableState(fenString)) {
+        return positionInvalid;
+    }
+    return computeGameState();
+}
+
+/* CLASSIFIES THE CURRENT POSITION FOR THE SIDE TO MOVE */
+uint8_t ChessGame::classifyCurrentPosition() {
+    return computeGameState();
+}
+
+/* LOADS A FEN STRING WITHOUT OUTPUT, FOR LOADING POSITIONS IN BULK */
+void ChessGame::resetState(const char* fenString) {
+
+    decodeFenString(fenString);
+    if (lazyGameState) {
+        gameStateCurrent = false; // Evaluated when it is first queried
+    }
+    else {
+        computeGameState();
+    }
+}
+
+/* DECODES A FEN STRING INTO THE STATE OF A NEW CHESS GAME, WITHOUT OUTPUT OR GAME STATE DETECTION */
+void ChessGame::decodeFenString(const char* fenString) {
+
     endGame = false; // Indicates that a game is in progress
+    gameStateCurrent = true; // The caller evaluates the game state of the position loaded
+    cachedPositionCurrent = false;
+
+    // Reset the state that a short notation FEN string does not describe
+    enPassantSquare[0] = -1;
+    halfMoveCounter = 0;
+    fullMoveCounter = 1;
+
+    // Clear the per-move state of any previously loaded game
+    castlingStatus = regularMove;
+    enPassantCapture = false;
 
     /* DECODE FEN STRING */
     int i = 0;
+    clearHistory(); // The moves recorded were made in the previous game
     decodePartOne(fenString, i); // PART 1: BOARD ARRANGEMENT
     decodePartTwo(fenString, i); // PART 2: ACTIVE COLOUR
     decodePartThree(fenString, i); // PART 3: CASTLING RIGHTS
@@ -57,32 +113,37 @@ void ChessGame::loadState(const char* fenString) {
     }
 
     gameLoaded = true;
-    cout << "A new board state is loaded!\n";
-    //printBoard();
-
-    // Simulate the opponent finishing their turn to detect if board loaded in a state of check/checkmate/stalemate/draw
-    turn = (turn == white ? black : white); 
-    detectGameState();
-    turn = (turn == white ? black : white);
 }
 
-/* CLEARS THE CHESS BAORD AND DEALLOCATES ANY HEAP MEMORY */
+/* CLEARS THE CHESS BAORD AND FREES EVERY PIECE */
 void ChessGame::cleanChessBoard() {
-    for (int rank = 0; rank < 8; rank++) {
-        for (int file = 0; file < 8; file++) {
+    for (int colour = 0; colour < 2; colour++) {
+        for (int index = 0; index < pieceCounts[colour]; index++) {
 
-            if (chessBoard[rank][file] != nullptr) {
-                delete chessBoard[rank][file];
-                chessBoard[rank][file] = nullptr;
-            }
+            ChessPiece* piece = pieceLists[colour][index];
+            chessBoard[piece->getRankIndex()][piece->getFileIndex()] = nullptr;
         }
+        pieceCounts[colour] = 0;
     }
+    pawnKey = 0;
+    piecePool.reset(); // Also frees any pieces captured by makeLegalMove() whose moves were never taken back
 }
 
-/* DECODES PART 1 OF A FEN STRING: BOARD ARRANGEMENT */
+/* DECODES PART 1 OF A FEN STRING: BOARD ARRANGEMENT, KEEPING THE PIECES ALREADY ON THE RIGHT SQUARES */
 void ChessGame::decodePartOne(const char* fenString, int& i) {
     int rank = 7, file = 0; // Start at 8th rank and the A-file
-    
+
+    // Pieces captured by makeLegalMove() whose moves were never taken back are only freed by clearing the board
+    if (piecePool.getPiecesInUse() != pieceCounts[white] + pieceCounts[black]) {
+        cleanChessBoard();
+    }
+
+    // The squares whose pieces differ from any previously loaded game, in the order the FEN string lists them.
+    // They are placed once every out-of-place piece is removed, so the piece lists never overfill.
+    int changedSquares[64][2];
+    char changedPieces[64];
+    int changeCount = 0;
+
     while (fenString[i] != ' ') { // Iterate through the FEN string until first blank space (end of part 1)
         
         char currentCharacter = fenString[i];
@@ -91,17 +152,33 @@ void ChessGame::decodePartOne(const char* fenString, int& i) {
             rank--;
             file = 0;
         }
-        else if (currentCharacter > '0' && currentCharacter < '9') { // Skip empty squares
+        else if (currentCharacter > '0' && currentCharacter < '9') { // Empty squares
             for (int empty = 0; empty < (currentCharacter - '0'); empty++) {
+                if (chessBoard[rank][file] != nullptr) {
+                    deletePiece(chessBoard[rank][file]);
+                }
                 file++;
             }
         }
         else { // Must be a piece as we are told that only valid FEN strings will be received as inputs
-            chessBoard[rank][file] = createChessPiece(currentCharacter, rank, file);
+            ChessPiece*& piece = chessBoard[rank][file];
+            if (piece == nullptr || piece->getAbbrName() != currentCharacter) {
+                if (piece != nullptr) {
+                    deletePiece(piece);
+                }
+                changedSquares[changeCount][0] = rank;
+                changedSquares[changeCount][1] = file;
+                changedPieces[changeCount++] = currentCharacter;
+            }
             file++;
         }
         i++; // At the end of the loop, i will hold the position of the first blank space
     }
+
+    for (int change = 0; change < changeCount; change++) {
+        int changedRank = changedSquares[change][0], changedFile = changedSquares[change][1];
+        chessBoard[changedRank][changedFile] = createChessPiece(changedPieces[change], changedRank, changedFile);
+    }
 }
 
 /* DECODES PART 2 OF A FEN STRING: ACTIVE COLOUR */
@@ -145,14 +222,8 @@ void ChessGame::decodePartFour(const char* fenString, int& i) {
     else { // Only one en passant square can exist at any one time
         const char enPassantCoord[2] = {(static_cast<char>(toupper(fenString[i]))), fenString[i+1]};
 
-        int* temporaryEnPassantSquare = coordToIndex(enPassantCoord);
-
         // Store as an attribute of ChessGame
-        enPassantSquare[0] = temporaryEnPassantSquare[0];
-        enPassantSquare[1] = temporaryEnPassantSquare[1];
-
-        delete [] temporaryEnPassantSquare;
-        temporaryEnPassantSquare = nullptr;
+        coordToIndex(enPassantCoord, enPassantSquare);
 
         i += 2; // i will hold the position of the fourth blank space
     }
@@ -161,8 +232,9 @@ void ChessGame::decodePartFour(const char* fenString, int& i) {
 /* DECODES PART 5 OF A FEN STRING: HALF MOVE COUNTER */
 void ChessGame::decodePartFive(const char* fenString, int& i) {
     i++;
-    for (int count = 0; fenString[i] != ' '; count++) {
-        halfMoveCounter += (fenString[i]-'0') * pow(10, count); // string -> base 10 integer
+    halfMoveCounter = 0;
+    while (fenString[i] != ' ') {
+        halfMoveCounter = halfMoveCounter * 10 + (fenString[i]-'0'); // string -> base 10 integer
         i++; // At the end of the loop, i will hold the position of the fifth blank space
     }
 }
@@ -170,80 +242,130 @@ void ChessGame::decodePartFive(const char* fenString, int& i) {
 /* DECODES PART 6 OF A FEN STRING: FULL MOVE COUNTER */
 void ChessGame::decodePartSix(const char* fenString, int& i) {
     i++;
-    for (int count = 0; fenString[i] != '\0'; count++) { // Loop until end of FEN string
-        fullMoveCounter += (fenString[i]-'0') * pow(10, count); // string -> base 10 integer
+    fullMoveCounter = 0;
+    while (fenString[i] != '\0') { // Loop until end of FEN string
+        fullMoveCounter = fullMoveCounter * 10 + (fenString[i]-'0'); // string -> base 10 integer
         i++;
     }
 }
 
-/* CREATES A SPECIFIED CHESS PIECE ON THE HEAP */
+/* CREATES A SPECIFIED CHESS PIECE IN THE GAME'S PIECE POOL */
 ChessPiece* ChessGame::createChessPiece(const char& abbrName, const int& rank, const int& file) {
 
     ChessPiece* newPiece = nullptr;
 
     switch(abbrName) {
         case 'p':
-            newPiece = new Pawn(black, rank, file, *this);
+            newPiece = piecePool.create<Pawn>(black, rank, file, *this);
             break;
         case 'P':
-            newPiece = new Pawn(white, rank, file, *this);
+            newPiece = piecePool.create<Pawn>(white, rank, file, *this);
             break;
         case 'r':
-            newPiece = new Rook(black, rank, file, *this);
+            newPiece = piecePool.create<Rook>(black, rank, file, *this);
             break;
         case 'R':
-            newPiece = new Rook(white, rank, file, *this);
+            newPiece = piecePool.create<Rook>(white, rank, file, *this);
             break;
         case 'n':
-            newPiece = new Knight(black, rank, file, *this);
+            newPiece = piecePool.create<Knight>(black, rank, file, *this);
             break;
         case 'N':
-            newPiece = new Knight(white, rank, file, *this);
+            newPiece = piecePool.create<Knight>(white, rank, file, *this);
             break;
         case 'b':
-            newPiece = new Bishop(black, rank, file, *this);
+            newPiece = piecePool.create<Bishop>(black, rank, file, *this);
             break;
         case 'B':
-            newPiece = new Bishop(white, rank, file, *this);
+            newPiece = piecePool.create<Bishop>(white, rank, file, *this);
             break;
         case 'q':
-            newPiece = new Queen(black, rank, file, *this);
+            newPiece = piecePool.create<Queen>(black, rank, file, *this);
             break;
         case 'Q':
-            newPiece = new Queen(white, rank, file, *this);
+            newPiece = piecePool.create<Queen>(white, rank, file, *this);
             break;
         case 'k':
-            newPiece = new King(black, rank, file, *this);
+            newPiece = piecePool.create<King>(black, rank, file, *this);
             blackKing = newPiece;
             break;
         case 'K':
-            newPiece = new King(white, rank, file, *this);
+            newPiece = piecePool.create<King>(white, rank, file, *this);
             whiteKing = newPiece;
             break;
         default:
-            cout << "ERROR: Invalid chess piece - could not instantiate game.\n";
+            console() << "ERROR: Invalid chess piece - could not instantiate game.\n";
             exit(1);
     }
+    if (newPiece == nullptr) {
+        console() << "ERROR: Too many chess pieces - could not instantiate game.\n";
+        exit(1);
+    }
+    addToPieceList(newPiece);
     return newPiece;
 }
 
 /* ACCEPTS A MOVE IN A CHESS GAME - PERFORMS GAME LOGIC AND OUTPUTS THE RELEVANT MESSAGE TO THE CONSOLE */
-void ChessGame::submitMove(const char* stringCoord1, const char* stringCoord2) {
+bool ChessGame::submitMove(const char* stringCoord1, const char* stringCoord2) {
+
+    // CONVERT STRING LITERAL CHESS COORDINATES TO INTEGERS (ZERO INDEXED), ONCE
+    int originCoord[2], destinationCoord[2];
+    coordToIndex(stringCoord1, originCoord);
+    coordToIndex(stringCoord2, destinationCoord);
+    if (!checkCoordinatesValid(originCoord, destinationCoord)) {
+        return false;
+    }
+    return playMove(Move(originCoord[0] * 8 + originCoord[1], destinationCoord[0] * 8 + destinationCoord[1]));
+}
+
+/* ACCEPTS A MOVE IN ITS COMPACT 16-BIT ENCODING */
+bool ChessGame::submitMove(Move move) {
+    return playMove(move);
+}
+
+/* MAKES A SEQUENCE OF MOVES, EVALUATING THE GAME STATE ONLY WHEN IT IS NEXT QUERIED */
+int ChessGame::submitMoves(const Move* moves, int count) {
+    bool wasLazy = lazyGameState;
+    lazyGameState = true;
+
+    int made = 0;
+    while (made < count && submitMove(moves[made])) {
+        made++;
+    }
+    lazyGameState = wasLazy;
+    return made;
+}
+
+/* PERFORMS GAME LOGIC FOR A SUBMITTED MOVE AND OUTPUTS THE RELEVANT MESSAGE TO THE CONSOLE */
+bool ChessGame::playMove(Move move) {
 
     // DEFENSIVE PROGRAMMING
+    if (!gameStateCurrent && (!lazyGameState || halfMoveCounter >= 100)) { // Lazily, only the 50-move rule is tested before a move
+        updateGameState();
+    }
     if (endGame) { // Detect whether game is still in progress
-        cout << "\nGame is already over\n";
+        console() << "\nGame is already over\n";
         gameLoaded = false;
-        return;
+        return false;
     }
     if (!gameLoaded) { // Detect whether a game has been loaded
-        cout << "\nA game has not been loaded\n";
-        return;
+        console() << "\nA game has not been loaded\n";
+        return false;
     }
 
-    // CONVERT STRING LITERAL CHESS COORDINATES TO INTEGERS (ZERO INDEXED)
-    int* originCoord = coordToIndex(stringCoord1);
-    int* destinationCoord = coordToIndex(stringCoord2);
+    // Dispatch once on the active colour; the rest of the move is specialised on it
+    return (turn == white ? playMove<white>(move) : playMove<black>(move));
+}
+
+/* PERFORMS GAME LOGIC FOR A MOVE BY THE GIVEN ACTIVE COLOUR */
+template <PieceColour colour>
+bool ChessGame::playMove(Move move) {
+    using Traits = ColourTraits<colour>;
+
+    // SPLIT THE SQUARE INDICES INTO ZERO-INDEXED COORDINATES
+    int originCoord[2] = {move.getOrigin() / 8, move.getOrigin() % 8};
+    int destinationCoord[2] = {move.getDestination() / 8, move.getDestination() % 8};
+    Promotion promotion = move.getPromotion();
 
     // OBTAIN POINTERS TO THE PIECES AT THE ORIGIN AND DESTINATION SQUARES
     ChessPiece* pieceAtOrigin = getPiece(originCoord);
@@ -257,39 +379,61 @@ void ChessGame::submitMove(const char* stringCoord1, const char* stringCoord2) {
         pieceAtDestinationSquare = false;
     }
 
-    // FIRST DETERMINE WHETHER MOVE IS VALID DISREGARDING STATE OF CHECK
-    if (checkMoveValid(originCoord, destinationCoord, stringCoord1, stringCoord2)) {
+    bool moveAccepted = false;
+
+    // FIRST DETERMINE WHETHER MOVE IS VALID DISREGARDING STATE OF CHECK (OR, WITH A MOVE CACHE, WHETHER IT IS LEGAL)
+    bool moveValid = (moveCache != nullptr ? checkMoveCached(originCoord, destinationCoord, promotion)
+                                           : checkMoveValid(originCoord, destinationCoord));
+    if (moveValid) {
+
+        // RECORD THE STATE THE MOVE CHANGES, KEPT IN THE HISTORY ONLY IF THE MOVE IS MADE
+        HistoryEntry entry;
+        if (!history.empty()) {
+            bool promoting = (pieceAtOrigin->getType() == pawn && destinationCoord[0] == Traits::promotionRank);
+            entry.move = Move(originCoord[0] * 8 + originCoord[1], destinationCoord[0] * 8 + destinationCoord[1],
+                              !promoting ? noPromotion : (promotion == noPromotion ? promoteToQueen : promotion));
+            entry.capturedPiece = (pieceAtDestination != nullptr ? pieceAtDestination->getAbbrName()
+                                                                 : (enPassantCapture ? (colour == white ? 'p' : 'P') : '\0'));
+            entry.capturedSquare = static_cast<int8_t>((enPassantCapture ? Traits::enPassantRank : destinationCoord[0]) * 8 + destinationCoord[1]);
+            saveHistoryState(entry, 0);
+        }
 
         // VALIDATE CASTLING
-        if (castlingStatus != regularMove) { // castlingStatus is assigned in checkMoveValid()
-            castle(originCoord, destinationCoord);
-            cout << turn << " castles " << castlingStatus << "\n";
+        if (castlingStatus != regularMove) { // castlingStatus is assigned in checkMoveValid() or checkMoveCached()
+            castle<colour>(originCoord, destinationCoord);
+            console() << colour << " castles " << castlingStatus << "\n";
             castlingStatus = regularMove; // Reset castlingStatus
         }
-        // VALIDATE REGULAR MOVE
-        else if (!regularMoveLogic(originCoord, destinationCoord)) {
-            cout << "Move " << stringCoord1 << " to " << stringCoord2 << " is not valid\n";
-            return;
+        // VALIDATE REGULAR MOVE (A MOVE FOUND IN THE MOVE CACHE IS ALREADY KNOWN TO BE LEGAL)
+        else if (moveCache != nullptr) {
+            makeMove(originCoord, destinationCoord);
+            console() << colour << "'s " << getPiece(destinationCoord)->getType() << " moves from " << SquareName(originCoord) << " to " << SquareName(destinationCoord);
+        }
+        else if (!regularMoveLogic<colour>(originCoord, destinationCoord)) {
+            console() << "Move " << SquareName(originCoord) << " to " << SquareName(destinationCoord) << " is not valid\n";
+            enPassantCapture = false;
+            return false;
         }
         // REGULAR MOVE HAS BEEN VALIDATED
         else {
-            cout << turn << "'s " << getPiece(destinationCoord)->getType() << " moves from " << stringCoord1 << " to " << stringCoord2;
+            console() << colour << "'s " << getPiece(destinationCoord)->getType() << " moves from " << SquareName(originCoord) << " to " << SquareName(destinationCoord);
         }
 
-        toggleCastlingFlags(pieceAtOrigin, originCoord);
+        toggleCastlingFlags<colour>(pieceAtOrigin, originCoord, destinationCoord);
+        bool captureMade = pieceAtDestinationSquare || enPassantCapture;
 
         // CAPTURE LOGIC
         if (pieceAtDestinationSquare) { // This will never be true for castling or en passant
             doCapture(pieceAtDestination);
         }
         else if (enPassantCapture) {
-            int pawnCapturedRank = (turn == white ? 4 : 3);
+            int pawnCapturedRank = Traits::enPassantRank;
             doCapture(chessBoard[pawnCapturedRank][destinationCoord[1]]);
         }
 
         // SET EN PASSANT SQUARE FOR NEXT TURN
         if (pieceAtOrigin->getType() == pawn && (abs(originCoord[0]-destinationCoord[0]) == 2)) {
-            int offset = (turn == white ? -1 : 1);
+            int offset = Traits::forward; // The square the pawn passed over
             enPassantSquare[0] = originCoord[0] + offset;
             enPassantSquare[1] = originCoord[1];
         }
@@ -297,42 +441,55 @@ void ChessGame::submitMove(const char* stringCoord1, const char* stringCoord2) {
             enPassantSquare[0] = -1; // Indicates no en passant square present
         }
 
-        if (pieceAtOrigin->getType() == pawn || pieceAtDestinationSquare) {
+        if (pieceAtOrigin->getType() == pawn || captureMade) {
             // Reset half move counter if capture or pawn advance occured this turn
             halfMoveCounter = -1; // This will be incremented to zero just below
         }
         halfMoveCounter++;
 
-        detectGameState();
+        // PROMOTE A PAWN THAT HAS REACHED THE FINAL RANK
+        if (pieceAtOrigin->getType() == pawn && destinationCoord[0] == Traits::promotionRank) {
+            promotePawn<colour>(destinationCoord, promotion);
+        }
+
+        if (lazyGameState) { // Leave the game state to be evaluated when it is queried
+            (colour == white ? whiteInCheck : blackInCheck) = false; // A legal move never leaves the mover in check
+            cachedPositionCurrent = false;
+            gameStateCurrent = false;
+        }
+        else if (moveCache != nullptr) {
+            applyCachedGameState();
+        }
+        else {
+            detectGameState<colour>();
+        }
         switchTurn();
 
-        if (turn == white) {
+        if (colour == black) { // White begins a new turn
             fullMoveCounter++;
         }
+        if (!history.empty()) {
+            saveHistoryState(entry, 1);
+            recordHistory(entry);
+        }
+        moveAccepted = true;
     }
     else {
-        cout << "Move " << stringCoord1 << " to " << stringCoord2 << " is not valid\n";
+        console() << "Move " << SquareName(originCoord) << " to " << SquareName(destinationCoord) << " is not valid\n";
+        castlingStatus = regularMove; // A rejected castling attempt must not carry over to the next move
     }
 
-    delete [] originCoord;
-    originCoord = nullptr;
-    delete [] destinationCoord;
-    destinationCoord = nullptr;
-
-    // cout << "\n\n";
+    // console() << "\n\n";
     // printBoard();
-    // cout << "\n\n";
+    // console() << "\n\n";
+
+    return moveAccepted;
 }
 
 /* CONVERTS STRING COORDINATES (e.g. "A1") TO ZERO-INDEXED INTEGER COORDINATES */
-int* ChessGame::coordToIndex(const char* stringCoord) {
-
-    int* indexArray = new int[2];
-
+void ChessGame::coordToIndex(const char* stringCoord, int* indexArray) {
     indexArray[1] = stringCoord[0] - 'A'; // files are denoted by letters
     indexArray[0] = stringCoord[1] - '1'; // ranks are deonated by numbers
-
-    return indexArray;
 }
 
 /* RETURNS A POINTER TO A PIECE AT A GIVEN SQUARE */
@@ -341,12 +498,12 @@ ChessPiece* ChessGame::getPiece(const int* coord) {
 }
 
 /* DETERMINES WHETHER A GIVEN MOVE IS LOGICAL REGARDLESS OF CHECK */
-bool ChessGame::checkMoveValid(const int* originCoord, const int* destinationCoord, const char* stringCoord1, const char* stringCoord2) {
+bool ChessGame::checkMoveValid(const int* originCoord, const int* destinationCoord) {
 
     ChessPiece* pieceAtOrigin = getPiece(originCoord);
     ChessPiece* pieceAtDestination = getPiece(destinationCoord);
 
-    if (!checkCoordinatesValid(originCoord, destinationCoord) || !checkPieceExists(pieceAtOrigin, stringCoord1)) {
+    if (!checkPieceExists(pieceAtOrigin, originCoord)) {
         return false;
     }
     if (!checkCorrectTurn(pieceAtOrigin) || !checkPieceMoves(originCoord, destinationCoord)) {
@@ -357,12 +514,13 @@ bool ChessGame::checkMoveValid(const int* originCoord, const int* destinationCoo
     }
     // Check whether the player is attempting to castle (before checking the movement pattern)
     if ((pieceAtOrigin->getType() == king) && (originCoord[0] - destinationCoord[0] == 0) && (abs(originCoord[1] - destinationCoord[1]) == 2)) {
-        return checkCastlingValid(castlingStatus, originCoord, destinationCoord);
+        return (turn == white ? checkCastlingValid<white>(castlingStatus, originCoord, destinationCoord)
+                              : checkCastlingValid<black>(castlingStatus, originCoord, destinationCoord));
     }
-    if(!pieceAtOrigin->checkMovementPattern(originCoord, destinationCoord, stringCoord2)) {
+    if(!pieceAtOrigin->checkMovementPattern(originCoord, destinationCoord)) {
         return false;
     }
-    if ((pieceAtOrigin->getType() != knight) && !checkPathClear(originCoord, destinationCoord, stringCoord2)) {
+    if ((pieceAtOrigin->getType() != knight) && !checkPathClear(originCoord, destinationCoord)) {
         return false;
     }
 
@@ -373,7 +531,7 @@ bool ChessGame::checkMoveValid(const int* originCoord, const int* destinationCoo
 bool ChessGame::checkCoordinatesValid(const int* originCoord, const int* destinationCoord) {
     for (int i = 0; i < 2; i++) {
         if (originCoord[i] < 0 || originCoord[i] > 7 || destinationCoord[i] < 0 || destinationCoord[i] > 7) {
-            cout << "Cannot make move - Coordinate out of bounds\n";
+            console() << "Cannot make move - Coordinate out of bounds\n";
             return false;
         }
     }
@@ -381,9 +539,9 @@ bool ChessGame::checkCoordinatesValid(const int* originCoord, const int* destina
 }
 
 /* DETERMINES WHETHER A PIECE EXISTS AT THE ORIGIN SQUARE FOR A MOVE */
-bool ChessGame::checkPieceExists(ChessPiece* pieceAtOrigin, const char* stringCoord1) {
+bool ChessGame::checkPieceExists(ChessPiece* pieceAtOrigin, const int* originCoord) {
     if (pieceAtOrigin == nullptr) {
-        cout << "There is no piece at position " << stringCoord1 << "!\n";
+        console() << "There is no piece at position " << SquareName(originCoord) << "!\n";
         return false;
     }
     return true;
@@ -392,7 +550,7 @@ bool ChessGame::checkPieceExists(ChessPiece* pieceAtOrigin, const char* stringCo
 /* DETERMINES WHETHER THE PIECE BEING MOVED BELONGS TO THE ACTIVE COLOUR */
 bool ChessGame::checkCorrectTurn(ChessPiece* pieceAtOrigin) {
     if (pieceAtOrigin->getColour() != turn) {
-        cout << "It is not " << pieceAtOrigin->getColour() << "'s turn to move!\n";
+        console() << "It is not " << pieceAtOrigin->getColour() << "'s turn to move!\n";
         return false;
     }
     return true;
@@ -401,7 +559,7 @@ bool ChessGame::checkCorrectTurn(ChessPiece* pieceAtOrigin) {
 /* DETERMINES WHETHER THE PIECE IS ACTUALLY MOVING */
 bool ChessGame::checkPieceMoves(const int* originCoord, const int* destinationCoord) {
     if (originCoord[0] == destinationCoord[0] && originCoord[1] == destinationCoord[1]) {
-        cout << "Cannot make move - piece must move from current square\n";
+        console() << "Cannot make move - piece must move from current square\n";
         return false;
     }
     return true;
@@ -410,35 +568,30 @@ bool ChessGame::checkPieceMoves(const int* originCoord, const int* destinationCo
 /* DETERMINES WHETHER THE DESTINATION SQUARE FOR A MOVE IS OCCUPIED BY A FRIENDLY PIECE */
 bool ChessGame::checkNoFriendlyCapture(ChessPiece* pieceAtDestination) {
     if (pieceAtDestination->getColour() == turn) {
-        cout << "Cannot make move - you cannot move to a square already occupied by one of your pieces.\n";
+        console() << "Cannot make move - you cannot move to a square already occupied by one of your pieces.\n";
         return false;
     }
     return true;
 }
 
 /* DETERMINES WHETHER AN ATTEMPT TO CASTLE IS LEGAL */
+template <PieceColour colour>
 bool ChessGame::checkCastlingValid(CastlingStatus& castlingStatus, const int* originCoord, const int* destinationCoord) {
 
     // Set enum to kingside or queenside castle
     castlingStatus = (originCoord[1] < destinationCoord[1]) ? kingsideCastle : queensideCastle;
 
     // Player can castle by default. This is toggled elsewhere if respective rook or king have moved
-    if (turn == white) {
-        if ((castlingStatus == kingsideCastle && !whiteCanCastleKingside) || (castlingStatus == queensideCastle && !whiteCanCastleQueenside)) {
-            cout << "You cannot castle if you have moved your king or rook\n"; 
-            return false;
-        }
-    }
-    if (turn == black) {
-        if ((castlingStatus == kingsideCastle && !blackCanCastleKingside) || (castlingStatus == queensideCastle && !blackCanCastleQueenside)) {
-            cout << "You cannot castle if you have moved your king or rook\n";
-            return false;
-        }
+    bool canCastleKingside = (colour == white ? whiteCanCastleKingside : blackCanCastleKingside);
+    bool canCastleQueenside = (colour == white ? whiteCanCastleQueenside : blackCanCastleQueenside);
+    if ((castlingStatus == kingsideCastle && !canCastleKingside) || (castlingStatus == queensideCastle && !canCastleQueenside)) {
+        console() << "You cannot castle if you have moved your king or rook\n";
+        return false;
     }
     
-    // Cannot castle out of check
-    if ((turn == white && whiteInCheck) || (turn == black && blackInCheck)) {
-        cout << "Cannot castle - " << turn << " is in check\n";
+    // Cannot castle out of check (tested directly if the check flags have not been evaluated since the last move)
+    if (gameStateCurrent ? (colour == white ? whiteInCheck : blackInCheck) : activeColourInCheck()) {
+        console() << "Cannot castle - " << colour << " is in check\n";
         return false;
     }
     
@@ -451,14 +604,14 @@ bool ChessGame::checkCastlingValid(CastlingStatus& castlingStatus, const int* or
     int count = 0;
     while (chessBoard[rank][file] == nullptr) {
         count++;
-        if (detectCheck(rank, file, turn, false)) { // Check if square in check
-            cout << "You cannot castle through check\n";
+        if (count <= 2 && isSquareAttacked<colour>(rank, file)) { // Check if a square the king crosses is in check
+            console() << "You cannot castle through check\n";
             return false;
         }
         file += jump;
     }    
     if (count != (castlingStatus == kingsideCastle ? 2 : 3)) {
-        cout << "You cannot castle - there are pieces in the way\n";
+        console() << "You cannot castle - there are pieces in the way\n";
         return false;
     }
 
@@ -466,94 +619,37 @@ bool ChessGame::checkCastlingValid(CastlingStatus& castlingStatus, const int* or
 }
 
 /* DETERMINES WHETHER THERE ARE ANY PIECES BETWEEN THE ORIGIN AND DESTINATION SQUARES OF A MOVE */
-bool ChessGame::checkPathClear(const int* originCoord, const int* destinationCoord, const char* stringCoord2) {
+bool ChessGame::checkPathClear(const int* originCoord, const int* destinationCoord) {
     // NB: No boundary checks necessary as originCoord and destinationCoord will
     //     already have been validated when this function is called.
     // NB: This function is not used for knights.
 
-    if (originCoord[0] == destinationCoord[0]) { // If travelling along the same rank
-
-        for (int i=1; i < abs(destinationCoord[1]-originCoord[1]); i++) { // Excludes destination square
-            // Check path clear to the right
-            if ((destinationCoord[1] > originCoord[1]) && (chessBoard[originCoord[0]][originCoord[1] + i] != nullptr)) {
-                cout << "Path is not clear - ";
-                generalCannotMoveOutput(getPiece(originCoord)->getType(), stringCoord2);
-                return false;
-            }
-            // Check path clear to the left
-            if ((destinationCoord[1] < originCoord[1]) && (chessBoard[originCoord[0]][originCoord[1] - i] != nullptr)) {
-                cout << "Path is not clear - ";
-                generalCannotMoveOutput(getPiece(originCoord)->getType(), stringCoord2);
-                    return false;
-            }
-        }
-    }
-
-    else if (originCoord[1] == destinationCoord[1]) { // If travelling along the same file
-            
-        for (int i=1; i < abs(destinationCoord[0]-originCoord[0]); i++) { // Excludes destination square
-            // Check path clear upwards
-            if ((destinationCoord[0] > originCoord[0]) && (chessBoard[originCoord[0] + i][originCoord[1]] != nullptr)) {
-                cout << "Path is not clear - ";
-                generalCannotMoveOutput(getPiece(originCoord)->getType(), stringCoord2);
-                return false;
-            }
-            // Check path clear downwards
-            if ((destinationCoord[0] < originCoord[0]) && (chessBoard[originCoord[0] - i][originCoord[1]] != nullptr)) {
-                cout << "Path is not clear - ";
-                generalCannotMoveOutput(getPiece(originCoord)->getType(), stringCoord2);
-                return false;
-            }
-        }
-    }
-
-    else if (abs(destinationCoord[0] - originCoord[0]) == abs(destinationCoord[1] - originCoord[1])) { // If travelling along a diagonal
+    // Look up the squares along the rank, file or diagonal between the two squares (excludes both)
+    SquareSet path = attackTables.between[originCoord[0] * 8 + originCoord[1]][destinationCoord[0] * 8 + destinationCoord[1]];
 
-        for (int i=1; i < abs(destinationCoord[0]-originCoord[0]); i++) {
-            if ((destinationCoord[0] > originCoord[0]) && (destinationCoord[1] > originCoord[1])) { // (rank,file) = (+,+)
-                if (chessBoard[originCoord[0]+i][originCoord[1]+i] != nullptr) {
-                    cout << "Path is not clear - ";
-                    generalCannotMoveOutput(getPiece(originCoord)->getType(), stringCoord2);
-                    return false;
-                }
-            }
-            if ((destinationCoord[0] < originCoord[0]) && (destinationCoord[1] < originCoord[1])) { // (rank,file) = (-,-)
-                if (chessBoard[originCoord[0]-i][originCoord[1]-i] != nullptr) {
-                    cout << "Path is not clear - ";
-                    generalCannotMoveOutput(getPiece(originCoord)->getType(), stringCoord2);
-                    return false;
-                }
-            }
-            if ((destinationCoord[0] > originCoord[0]) && (destinationCoord[1] < originCoord[1])) { // (rank,file) = (+,-)
-                if (chessBoard[originCoord[0]+i][originCoord[1]-i] != nullptr) {
-                    cout << "Path is not clear - ";
-                    generalCannotMoveOutput(getPiece(originCoord)->getType(), stringCoord2);
-                    return false;
-                }
-            }
-            if ((destinationCoord[0] < originCoord[0]) && (destinationCoord[1] > originCoord[1])) { // (rank,file) = (-,+)
-                if (chessBoard[originCoord[0]-i][originCoord[1]+i] != nullptr) {
-                    cout << "Path is not clear - ";
-                    generalCannotMoveOutput(getPiece(originCoord)->getType(), stringCoord2);
-                    return false;
-                }
-            }
+    while (path != 0) {
+        int square = popSquare(path);
+        if (chessBoard[square / 8][square % 8] != nullptr) {
+            console() << "Path is not clear - ";
+            generalCannotMoveOutput(getPiece(originCoord)->getType(), destinationCoord);
+            return false;
         }
     }
     return true;
 }
 
 /* GENERAL OUTPUT MESSAGE FOR A FAILED MOVE */
-void ChessGame::generalCannotMoveOutput(const PieceType pieceType, const char* stringCoord2) {
-    cout << turn << "'s " << pieceType << " cannot move to " << stringCoord2 << "!\n";
+void ChessGame::generalCannotMoveOutput(const PieceType pieceType, const int* destinationCoord) {
+    console() << turn << "'s " << pieceType << " cannot move to " << SquareName(destinationCoord) << "!\n";
 }
 
 /* CASTLES */
+template <PieceColour colour>
 void ChessGame::castle(const int* originCoord, const int* destinationCoord) {
 
     makeMove(originCoord, destinationCoord); // Move the king
 
-    int rookRank = (turn == white) ? 0 : 7;
+    int rookRank = ColourTraits<colour>::homeRank;
     int rookFile = (castlingStatus == kingsideCastle) ? 7 : 0;
     int rookOriginCoord[2] = {rookRank, rookFile};
             
@@ -570,7 +666,13 @@ void ChessGame::makeMove(const int* originCoord, const int* destinationCoord) {
 
         chessBoard[destinationCoord[0]][destinationCoord[1]] = chessBoard[originCoord[0]][originCoord[1]]; // Make the move
         chessBoard[originCoord[0]][originCoord[1]] = nullptr;
+        chessBoard[destinationCoord[0]][destinationCoord[1]]->setPosition(destinationCoord[0], destinationCoord[1]);
 
+        if (chessBoard[destinationCoord[0]][destinationCoord[1]]->getType() == pawn) {
+            PieceColour colour = chessBoard[destinationCoord[0]][destinationCoord[1]]->getColour();
+            pawnKey ^= zobristKeys.pieces[colour][pawn][originCoord[0] * 8 + originCoord[1]] ^
+                       zobristKeys.pieces[colour][pawn][destinationCoord[0] * 8 + destinationCoord[1]];
+        }
         if (chessBoard[destinationCoord[0]][destinationCoord[1]]->getType() == king) {
             (turn == white ? whiteKing : blackKing) = chessBoard[destinationCoord[0]][destinationCoord[1]];
         }
@@ -578,50 +680,48 @@ void ChessGame::makeMove(const int* originCoord, const int* destinationCoord) {
 }
 
 /* DETERMINES WHETHER A MOVE IS LEGAL WITH REGARD TO CHECK STATUS */
+template <PieceColour colour>
 bool ChessGame::regularMoveLogic(const int* originCoord, const int* destinationCoord) {
 
+    ChessPiece* capturedPiece = getPiece(destinationCoord); // Restored if the move has to be undone
+
+    // Lift a pawn captured en passant off the board while testing for check
+    ChessPiece* enPassantPawn = nullptr;
+    if (enPassantCapture) {
+        enPassantPawn = chessBoard[originCoord[0]][destinationCoord[1]];
+        chessBoard[originCoord[0]][destinationCoord[1]] = nullptr;
+    }
+
     makeMove(originCoord, destinationCoord);
-    ChessPiece* currentKing = ((turn == white) ? whiteKing : blackKing);
+    ChessPiece* currentKing = (colour == white ? whiteKing : blackKing);
+    bool& inCheck = (colour == white ? whiteInCheck : blackInCheck);
+    bool wasInCheck = inCheck;
+    bool legal = true;
 
     // IF IN CHECK, THE MOVE MUST TAKE YOU OUT OF CHECK
-    if ((turn == white && whiteInCheck) || (turn == black && blackInCheck)) {
-        if (detectCheck(currentKing->getRankIndex(), currentKing->getFileIndex(), currentKing->getColour(), true)) {
-            makeMove(destinationCoord, originCoord); // UNDO MOVE
-            cout << "Cannot make move - you are in check.";
-            return false;
-        }
-        else {
-            turn == white ? whiteInCheck = false : blackInCheck = false;
-        }
-    }
     // IF NOT IN CHECK, YOU MUST NOT BE MOVING INTO CHECK
-    else {
-        if (detectCheck(currentKing->getRankIndex(), currentKing->getFileIndex(), currentKing->getColour(), true)) {
-            makeMove(destinationCoord, originCoord); // UNDO MOVE
-            cout << "Cannot make move - you cannot move into check";
-            return false;
+    inCheck = isSquareAttacked<colour>(currentKing->getRankIndex(), currentKing->getFileIndex());
+    if (inCheck) {
+        makeMove(destinationCoord, originCoord); // UNDO MOVE
+        chessBoard[destinationCoord[0]][destinationCoord[1]] = capturedPiece;
+        if (!gameStateCurrent) { // The flag was not evaluated before the move
+            wasInCheck = isSquareAttacked<colour>(currentKing->getRankIndex(), currentKing->getFileIndex());
         }
-    } 
-    return true;
+        inCheck = wasInCheck; // The position is unchanged
+        console() << (wasInCheck ? "Cannot make move - you are in check." : "Cannot make move - you cannot move into check");
+        legal = false;
+    }
+
+    if (enPassantPawn != nullptr) { // The pawn is removed properly by doCapture() if the move stands
+        chessBoard[originCoord[0]][destinationCoord[1]] = enPassantPawn;
+    }
+    return legal;
 }
 
 /* DETECTS WHETHER A GIVEN SQUARE/KING IS UNDER THREAT/IN CHECK */
 bool ChessGame::detectCheck(const int &rank, const int &file, const PieceColour &colour, const bool lookingAtKing) {
 
-    bool detected = false;
-    
-    if (detectKnightInRange(rank, file, colour)) {
-        detected = true;
-    }
-
-    Directions directions[] = {leftRank, rightRank, upFile, downFile, plusplus, minusminus, plusminus, minusplus};
-
-    for (const Directions& direction : directions) {
-        if (doesPieceSeeSquare(rank, file, colour, findNearestNeighbour(rank, file, direction), direction)) {
-            detected = true;
-            break;
-        }
-    }
+    bool detected = (colour == white ? isSquareAttacked<white>(rank, file) : isSquareAttacked<black>(rank, file));
 
     if (lookingAtKing) {
         if (detected) {
@@ -635,27 +735,44 @@ bool ChessGame::detectCheck(const int &rank, const int &file, const PieceColour
     return detected;
 }
 
-/* DETECTS WHETHER AN ENEMY KNIGHT IS IN RANGE OF A GIVEN SQUARE */
-bool ChessGame::detectKnightInRange(const int &rank, const int &file, const PieceColour &colour) {
+/* DETECTS WHETHER A SQUARE IS ATTACKED BY ANY PIECE OF THE OPPOSITE COLOUR */
+template <PieceColour colour>
+bool ChessGame::isSquareAttacked(const int &rank, const int &file) {
 
-    int knightMoves[8][2] = {{1, 2}, {-1, 2}, {1, -2}, {-1, -2}, {2, 1}, {-2, 1}, {2, -1}, {-2, -1}};
+    if (detectKnightInRange<colour>(rank, file)) {
+        return true;
+    }
 
-    for (int move = 0; move < 8; move++) {
-        int newRank = rank + knightMoves[move][0];
-        int newFile = file + knightMoves[move][1];
+    static constexpr Directions directions[] = {leftRank, rightRank, upFile, downFile, plusplus, minusminus, plusminus, minusplus};
 
-        if ((newRank >= 0) && (newRank < 8) && (newFile >= 0) && (newFile < 8)) { // Boundary checks
-            ChessPiece* possibleKnight = chessBoard[newRank][newFile];
-            if ((possibleKnight != nullptr) && (possibleKnight->getType() == knight) && (possibleKnight->getColour() != colour)) {
-                return true;
-            }
+    for (const Directions& direction : directions) {
+        if (doesPieceSeeSquare<colour>(rank, file, findNearestNeighbour(rank, file, direction), direction)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* DETECTS WHETHER AN ENEMY KNIGHT IS IN RANGE OF A GIVEN SQUARE */
+template <PieceColour colour>
+bool ChessGame::detectKnightInRange(const int &rank, const int &file) {
+
+    // A knight attacks this square from exactly the squares a knight here would attack
+    SquareSet knightSquares = attackTables.knightAttacks[rank * 8 + file];
+
+    while (knightSquares != 0) {
+        int square = popSquare(knightSquares);
+        ChessPiece* possibleKnight = chessBoard[square / 8][square % 8];
+        if ((possibleKnight != nullptr) && (possibleKnight->getType() == knight) && (possibleKnight->getColour() != colour)) {
+            return true;
         }
     }
     return false;
 }
 
 /* DETECTS WHETHER A NEAREST NEIGHBOUR PIECE TO A SQUARE CAN 'SEE' THE SQUARE */
-bool ChessGame::doesPieceSeeSquare(const int &rank, const int &file, const PieceColour &colour, const ChessPiece* nearestNeighbour, const Directions& direction) {
+template <PieceColour colour>
+bool ChessGame::doesPieceSeeSquare(const int &rank, const int &file, const ChessPiece* nearestNeighbour, const Directions& direction) {
 
     if (nearestNeighbour != nullptr) {
         if (colour == nearestNeighbour->getColour()) { // Check if piece is friendly
@@ -669,19 +786,16 @@ bool ChessGame::doesPieceSeeSquare(const int &rank, const int &file, const Piece
             return true;
         }
 
+        int neighbourSquare = nearestNeighbour->getRankIndex() * 8 + nearestNeighbour->getFileIndex();
+
         // A king can see one square in any direction
-        if ((pieceName == king) && (min(abs(nearestNeighbour->getRankIndex() - rank), abs(nearestNeighbour->getFileIndex() - file)) == 1)) {
+        if ((pieceName == king) && containsSquare(attackTables.kingAttacks[rank * 8 + file], neighbourSquare)) {
             return true;
         }
 
-        // A pawn can see one square diagonally
-        if ((pieceName == pawn)) {
-            if (((colour == white) && (nearestNeighbour->getRankIndex() == rank + 1)) ||
-                ((colour == black) && (nearestNeighbour->getRankIndex() == rank - 1))) {
-                if (abs(nearestNeighbour->getFileIndex() - file) == 1) {
-                    return true;
-                }
-            }
+        // A pawn can see one square diagonally (forwards), i.e. from the squares a friendly pawn here would attack
+        if ((pieceName == pawn) && containsSquare(attackTables.pawnAttacks[colour][rank * 8 + file], neighbourSquare)) {
+            return true;
         }
 
         switch (direction) {
@@ -809,57 +923,51 @@ ChessPiece* ChessGame::findNearestNeighbour(const int &rank, const int &file, co
             break;
 
         default:
-            cout << "ERROR: Tried to search for nearest neighbour in an invalid direction.\n";
+            console() << "ERROR: Tried to search for nearest neighbour in an invalid direction.\n";
             return nullptr;
     }
     return nullptr;
 }
 
 /* TOGGLES CASTLING FLAGS BASED ON KING AND ROOK MOVEMENT */
-void ChessGame::toggleCastlingFlags(const ChessPiece* pieceAtOrigin, const int* originCoord) {
+template <PieceColour colour>
+void ChessGame::toggleCastlingFlags(const ChessPiece* pieceAtOrigin, const int* originCoord, const int* destinationCoord) {
 
     if (pieceAtOrigin->getType() == king) {
-        if (turn == white) {
-            whiteCanCastleKingside = false;
-            whiteCanCastleQueenside = false;
-        }
-        else {
-            blackCanCastleKingside = false;
-            blackCanCastleQueenside = false;
-        }
+        (colour == white ? whiteCanCastleKingside : blackCanCastleKingside) = false;
+        (colour == white ? whiteCanCastleQueenside : blackCanCastleQueenside) = false;
     }
-    else if (pieceAtOrigin->getType() == rook) {
-        if (turn == white && originCoord[1] == 0) {
-            whiteCanCastleKingside = false;                    
-        }
-        else if (turn == white && originCoord[1] == 7) {
+
+    // A move from or to a corner square means that the rook which started there has moved or been captured
+    const int* coords[2] = {originCoord, destinationCoord};
+    for (const int* coord : coords) {
+        if (coord[0] == 0 && coord[1] == 0) {
             whiteCanCastleQueenside = false;
         }
-        else if (turn == black && originCoord[1] == 0) {
-            blackCanCastleKingside = false;
+        else if (coord[0] == 0 && coord[1] == 7) {
+            whiteCanCastleKingside = false;
         }
-        else if (turn == black && originCoord[1] == 7) {
+        else if (coord[0] == 7 && coord[1] == 0) {
             blackCanCastleQueenside = false;
         }
+        else if (coord[0] == 7 && coord[1] == 7) {
+            blackCanCastleKingside = false;
+        }
     }
 }
 
 /* OUTPUTS PIECE CAPTURE MESSAGE AND MANAGES HEAP MEMORY */
 void ChessGame::doCapture(ChessPiece* pieceToCapture) {
-    cout << " taking " << pieceToCapture->getColour() << "'s " << pieceToCapture->getType();
+    console() << " taking " << pieceToCapture->getColour() << "'s " << pieceToCapture->getType();
 
-    // Avoid dangling pointer in chessBoard in case of en passant
-    for (int i = 0; i < 8; ++i) {
-        for (int j = 0; j < 8; ++j) {
-            if (chessBoard[i][j] == pieceToCapture) {
-                chessBoard[i][j] = nullptr;
-                break;
-            }
-        }
+    // Avoid dangling pointer in chessBoard in case of en passant (otherwise the capturing piece already stands there)
+    ChessPiece*& capturedSquare = chessBoard[pieceToCapture->getRankIndex()][pieceToCapture->getFileIndex()];
+    if (capturedSquare == pieceToCapture) {
+        capturedSquare = nullptr;
     }
 
     if (enPassantCapture) {
-        cout << " via en passant";
+        console() << " via en passant";
         enPassantCapture = false;
     }
     else {
@@ -869,189 +977,998 @@ void ChessGame::doCapture(ChessPiece* pieceToCapture) {
     deletePiece(pieceToCapture);
 }
 
-/* DELETES A CHESS PIECE AND DEALLOCATES HEAP MEMORY */
+/* REPLACES A PAWN ON THE FINAL RANK WITH THE PIECE IT PROMOTES TO */
+template <PieceColour colour>
+void ChessGame::promotePawn(const int* coord, Promotion promotion) {
+    PieceType promotedType = promotionPieceType(promotion);
+    deletePiece(chessBoard[coord[0]][coord[1]]);
+    chessBoard[coord[0]][coord[1]] = createChessPiece(pieceAbbrName(colour, promotedType), coord[0], coord[1]);
+    console() << " and is promoted to a " << promotedType;
+}
+
+/* DELETES A CHESS PIECE AND RETURNS ITS STORAGE TO THE PIECE POOL */
 void ChessGame::deletePiece(ChessPiece* &pieceToDelete) {
-    delete pieceToDelete;
+    removeFromPieceList(pieceToDelete);
+    piecePool.destroy(pieceToDelete);
     pieceToDelete = nullptr;
 }
 
+/* ADDS A PIECE TO ITS COLOUR'S PIECE LIST */
+void ChessGame::addToPieceList(ChessPiece* piece) {
+    PieceColour colour = piece->getColour();
+    if (pieceCounts[colour] == maxPiecesPerColour) {
+        console() << "ERROR: Too many " << colour << " pieces - could not instantiate game.\n";
+        exit(1);
+    }
+    piece->setListIndex(pieceCounts[colour]);
+    pieceLists[colour][pieceCounts[colour]++] = piece;
+
+    if (piece->getType() == pawn) {
+        pawnKey ^= zobristKeys.pieces[colour][pawn][piece->getRankIndex() * 8 + piece->getFileIndex()];
+    }
+}
+
+/* REMOVES A PIECE FROM ITS COLOUR'S PIECE LIST, FILLING THE GAP WITH THE LAST PIECE */
+void ChessGame::removeFromPieceList(ChessPiece* piece) {
+    PieceColour colour = piece->getColour();
+    ChessPiece* lastPiece = pieceLists[colour][--pieceCounts[colour]];
+
+    pieceLists[colour][piece->getListIndex()] = lastPiece;
+    lastPiece->setListIndex(piece->getListIndex());
+    piece->setListIndex(-1);
+
+    if (piece->getType() == pawn) {
+        pawnKey ^= zobristKeys.pieces[colour][pawn][piece->getRankIndex() * 8 + piece->getFileIndex()];
+    }
+}
+
 /* DETERMINES THE CURRENT STATE OF A CHESS GAME (DETECTS: CHECK/CHECKMATE/STALEMATE/DRAW) */
+void ChessGame::detectGameState() {
+    turn == white ? detectGameState<white>() : detectGameState<black>();
+}
+
+/* DETERMINES THE STATE OF A CHESS GAME AFTER A MOVE BY THE GIVEN ACTIVE COLOUR */
+template <PieceColour colour>
 void ChessGame::detectGameState() {
 
+    constexpr PieceColour opponent = ColourTraits<colour>::opponent;
     bool checkDetected = false;
 
     // DETECT CHECK
     if (detectCheck(blackKing->getRankIndex(), blackKing->getFileIndex(), black, true) || detectCheck(whiteKing->getRankIndex(), whiteKing->getFileIndex(), white, true)) {
         checkDetected = true;
     }
-    
+    bool opponentInCheck = (opponent == white ? whiteInCheck : blackInCheck);
+    bool opponentCanMove = anyLegalMoves<opponent>(); // Checkmate and stalemate both leave the opponent no legal move
+
     // DETECT CHECKMATE
-    if (turn == black && whiteInCheck && detectCheckmate(whiteKing)) {
-        cout << "\nWhite is in checkmate";
-        endGame = true;
-    }
-    if (turn == white && blackInCheck && detectCheckmate(blackKing)) {
-        cout << "\nBlack is in checkmate";
+    if (opponentInCheck && !opponentCanMove) {
+        console() << "\n" << opponent << " is in checkmate";
         endGame = true;
     }
 
     // DETECT STALEMATE
-    if (turn == white && !blackInCheck && !anySafeSquares(blackKing) && !anyPiecesCanMove()) { // If no black pieces can move
-        cout << "\nEnd of game - Stalemate";
-        endGame = true;
-    }
-    if (turn == black && !whiteInCheck && !anySafeSquares(whiteKing) && !anyPiecesCanMove()) { // If no white pieces can move
-        cout << "\nEnd of game - Stalemate";
+    if (!opponentInCheck && !opponentCanMove) {
+        console() << "\nEnd of game - Stalemate";
         endGame = true;
     }
 
     // DETECT DRAW BY 50-MOVE RULE
-    if (!endGame && halfMoveCounter == 100) {
-        cout << "\nEnd of game - draw by 50-move rule\n";
+    if (!endGame && halfMoveCounter >= 100) {
+        console() << "\nEnd of game - draw by 50-move rule\n";
         endGame = true;
     }
 
     // DETECT DRAW BY REPETITION
 
     if (!endGame && checkDetected) { // If game continues then output check message
-        PieceColour oppositeTurn = ((turn == white) ? black : white);
-        cout << "\n" << oppositeTurn << " is in check";
+        console() << "\n" << opponent << " is in check";
     }
 }
 
-/* DETERMINES IF A KING IS IN CHECKMATE */
-bool ChessGame::detectCheckmate(ChessPiece* king) { // This function is only called if in check
-
-    if(!anySafeSquares(king)) {
-        return !pieceCanBlock(king);
+/* EVALUATES THE GAME STATE IF A MOVE HAS BEEN MADE SINCE IT WAS LAST EVALUATED */
+void ChessGame::updateGameState() {
+    if (!gameStateCurrent && gameLoaded) {
+        computeGameState();
     }
-    return false;
 }
 
-/* DETERMINES IF THERE ARE ANY SAFE SQUARES FOR A KING THAT IS IN CHECK TO MOVE TO */
-bool ChessGame::anySafeSquares(ChessPiece* king) {
-    // Get coordinates of king
-    int rank = king->getRankIndex();
-    int file = king->getFileIndex();
+/* EVALUATES THE GAME STATE OF THE SIDE TO MOVE FROM ITS LEGAL MOVES, WITHOUT OUTPUT */
+uint8_t ChessGame::computeGameState() {
+    ChessPiece* currentKing = (turn == white ? whiteKing : blackKing);
+    bool inCheck = detectCheck(currentKing->getRankIndex(), currentKing->getFileIndex(), turn, false);
+    (turn == white ? whiteInCheck : blackInCheck) = inCheck;
+    (turn == white ? blackInCheck : whiteInCheck) = false;
 
-    // Iterate through all possible king moves
-    for (int move = 0; move < 8; move++) {
-        int newRank = rank + king->getUnitMoves()[move][0];
-        int newFile = file + king->getUnitMoves()[move][1];
+    uint8_t stateFlags = (inCheck ? sideInCheck : 0);
+    if (!anyLegalMoves()) {
+        stateFlags |= (inCheck ? sideCheckmated : sideStalemated);
+    }
+    else if (halfMoveCounter >= 100) {
+        stateFlags |= sideDrawnByFiftyMoves;
+    }
 
-        if (newRank >= 0 && newRank < 8 && newFile >= 0 && newFile < 8) { // Boundary checks
+    endGame = (stateFlags & (sideCheckmated | sideStalemated | sideDrawnByFiftyMoves));
+    gameStateCurrent = true;
+    return stateFlags;
+}
 
-            // Check destination square not in check, and is either empty or occupied by an enemy piece
-            if (!detectCheck(newRank, newFile, king->getColour(), false) && (chessBoard[newRank][newFile] == nullptr || chessBoard[newRank][newFile]->getColour() != king->getColour())) {
-                return true;
-            }
-        }
-    }
-    return false;
+/* SWITCHES THE ACTIVE COLOUR FROM WHITE TO BLACK */
+void ChessGame::switchTurn() {
+    console() << "\n";
+    turn = (turn == white) ? black : white;
+}
+
+/* GETTER FUNCTION FOR EN PASSANT SQUARE */
+int* ChessGame::getEnPassantSquare() {
+    return enPassantSquare;
 }
 
-/* DETERMINES WHETHER THERE EXISTS A PIECE THAT CAN BLOCK A CHECK ON ITS KING */
-bool ChessGame::pieceCanBlock(ChessPiece* king) {
+/* ENABLES OR SILENCES CONSOLE OUTPUT */
+void ChessGame::setConsoleOutput(bool enabled) {
+    output = (enabled ? &cout : &silentStream);
+}
 
-    for (int rank = 0; rank < 8; rank++) {
-        for (int file = 0; file < 8; file++) {
-            if ((chessBoard[rank][file] != nullptr) && (chessBoard[rank][file]->getType() != king->getType()) && (chessBoard[rank][file]->getColour() == king->getColour())) {
-                if (attemptBlockCheck(chessBoard[rank][file])) {
-                    return true;
-                }
-            }
-        }
-    }
-    return false;
+/* RETURNS THE STREAM THAT GAME MESSAGES ARE WRITTEN TO */
+std::ostream& ChessGame::console() {
+    return *output;
 }
 
-/* ATTEMPTS EVERY MOVE FOR A GIVEN PIECE TO DETERMINE WHETHER IT CAN BLOCK A CHECK */
-bool ChessGame::attemptBlockCheck(ChessPiece* piece) {
-    // Try all the moves for that piece, test if blocking was succesful and undo
+/* GETTER FUNCTION FOR THE ACTIVE COLOUR */
+PieceColour ChessGame::getTurn() const {
+    return turn;
+}
 
-    int rank = piece->getRankIndex();
-    int file = piece->getFileIndex();
-    int originCoords[2] = {rank, file};
+/* DETERMINES WHETHER A GAME IS LOADED AND STILL IN PROGRESS */
+bool ChessGame::isInProgress() {
+    updateGameState();
+    return gameLoaded && !endGame;
+}
 
-    for (uint32_t move = 0; move < piece->getUnitMoves().size(); move++) { // Iterate through all possible moves for the piece
+/* ENABLES OR DISABLES LAZY EVALUATION OF THE GAME STATE */
+void ChessGame::setLazyGameState(bool enabled) {
+    lazyGameState = enabled;
+}
 
-        if (piece->getType() == rook || piece->getType() == bishop || piece->getType() == queen) {
-            for (int multiplier = 1; multiplier <= 8; multiplier++) { // For pieces that can move any multiple of squares in their allowed directions
+/* DETERMINES WHETHER A GIVEN COLOUR IS CURRENTLY IN CHECK */
+bool ChessGame::isInCheck(PieceColour colour) {
+    updateGameState();
+    return (colour == white ? whiteInCheck : blackInCheck);
+}
 
-                int newRank = rank + multiplier*piece->getUnitMoves()[move][0];
-                int newFile = file + multiplier*piece->getUnitMoves()[move][1];
-                int destinationCoords[2] = {newRank, newFile};
+/* COMPUTES THE ZOBRIST HASH OF THE CURRENT POSITION */
+uint64_t ChessGame::positionHash() const {
+    uint64_t hash = 0;
 
-                if (newRank >= 0 && newRank < 8 && newFile >= 0 && newFile < 8) { // Boundary checks
-                    if (chessBoard[newRank][newFile] == nullptr) { // If square empty
-                        makeMove(originCoords, destinationCoords);
-                        if ((turn == black && !detectCheck(whiteKing->getRankIndex(), whiteKing->getFileIndex(), whiteKing->getColour(), true)) || (turn == white && !detectCheck(blackKing->getRankIndex(), blackKing->getFileIndex(), blackKing->getColour(), true))) {
-                            makeMove(destinationCoords, originCoords);
-                            return true;
-                        }
-                        makeMove(destinationCoords, originCoords);
-                    }
-                }
+    for (int rank = 0; rank < 8; rank++) {
+        for (int file = 0; file < 8; file++) {
+            const ChessPiece* piece = chessBoard[rank][file];
+            if (piece != nullptr) {
+                hash ^= zobristKeys.pieces[piece->getColour()][piece->getType()][rank * 8 + file];
             }
         }
-        else { // pawn, knight, king
-            int newRank = rank + piece->getUnitMoves()[move][0];
-            int newFile = file + piece->getUnitMoves()[move][1];
-            int destinationCoords[2] = {newRank, newFile};
-
-            if (newRank >= 0 && newRank < 8 && newFile >= 0 && newFile < 8) { // Boundary checks
-                if (chessBoard[newRank][newFile] == nullptr) {
-                    makeMove(originCoords, destinationCoords);
-                    if ((turn == black && !detectCheck(whiteKing->getRankIndex(), whiteKing->getFileIndex(), whiteKing->getColour(), true)) || (turn == white && !detectCheck(blackKing->getRankIndex(), blackKing->getFileIndex(), blackKing->getColour(), true))) {
-                        makeMove(destinationCoords, originCoords);
-                        return true;
-                    } 
-                    makeMove(destinationCoords, originCoords);    
-                }      
-            }
+    }
+
+    if (turn == black) {
+        hash ^= zobristKeys.blackToMove;
+    }
+    const bool castlingRights[4] = {whiteCanCastleKingside, whiteCanCastleQueenside, blackCanCastleKingside, blackCanCastleQueenside};
+    for (int right = 0; right < 4; right++) {
+        if (castlingRights[right]) {
+            hash ^= zobristKeys.castling[right];
         }
     }
-    return false;
+    if (enPassantSquare[0] != -1) {
+        hash ^= zobristKeys.enPassantFile[enPassantSquare[1]];
+    }
+    return hash;
 }
 
-/* DETERMINES WHETHER THE COLOUR NEXT TO MOVE HAS ANY LEGAL MOVES */
-bool ChessGame::anyPiecesCanMove() {
-
-    // Iterate through the chess board
-    for (int ranks = 0; ranks < 8; ranks++) {
-        for (int files = 0; files < 8; files++) {
-
-            ChessPiece* pieceToMove = chessBoard[ranks][files];
-
-            // If (non-king) piece belongs to opponent
-            if ((pieceToMove != nullptr) && (pieceToMove->getColour() != turn) && (pieceToMove->getType() != king)) {
+/* COUNTS THE OCCURRENCES OF THE CURRENT POSITION AMONG THOSE SINCE THE LAST CAPTURE OR PAWN ADVANCE */
+int ChessGame::countRepetitions(const vector<uint64_t>& hashes, int halfMoveCounter) {
+    int repetitions = 1;
+    size_t current = hashes.size() - 1;
+    size_t earliest = current - min<size_t>(halfMoveCounter, current);
+    for (size_t index = current; index >= earliest + 2; index -= 2) {
+        repetitions += (hashes[index - 2] == hashes[current]);
+    }
+    return repetitions;
+}
 
-                // Iterate through unit moves
-                for (uint32_t move = 0; move < pieceToMove->getUnitMoves().size(); move++) {
-                    int newRank = ranks + pieceToMove->getUnitMoves()[move][0];
-                    int newFile = files + pieceToMove->getUnitMoves()[move][1];
+/* GENERATES EVERY LEGAL MOVE FOR THE ACTIVE COLOUR */
+int ChessGame::generateLegalMoves(Move* moveList) {
+    return (turn == white ? generateLegalMoves<white>(moveList) : generateLegalMoves<black>(moveList));
+}
 
-                    int originCoord[2] = {ranks, files};
-                    int destinationCoord[2] = {newRank, newFile};
-                    if(pieceToMove->isValidMovePattern(originCoord, destinationCoord)) {
-                        return true;
-                    }
-                }
-            }
-        }
+/* GENERATES EVERY LEGAL MOVE FOR THE GIVEN ACTIVE COLOUR */
+template <PieceColour colour>
+int ChessGame::generateLegalMoves(Move* moveList) {
+    int count = 0;
+    for (int index = 0; index < pieceCounts[colour]; index++) {
+        addPieceMoves<colour>(moveList, count, pieceLists[colour][index]);
     }
-    return false;
+    addCastlingMoves<colour>(moveList, count);
+    return count;
 }
 
-/* SWITCHES THE ACTIVE COLOUR FROM WHITE TO BLACK */
-void ChessGame::switchTurn() {
-    cout << "\n";
-    turn = (turn == white) ? black : white;
+/* DETERMINES WHETHER THE ACTIVE COLOUR HAS ANY LEGAL MOVE */
+bool ChessGame::anyLegalMoves() {
+    return (turn == white ? anyLegalMoves<white>() : anyLegalMoves<black>());
 }
 
-/* GETTER FUNCTION FOR EN PASSANT SQUARE */
-int* ChessGame::getEnPassantSquare() {
-    return enPassantSquare;
+/* DETERMINES WHETHER THE GIVEN ACTIVE COLOUR HAS ANY LEGAL MOVE, STOPPING AT THE FIRST PIECE THAT CAN MOVE */
+template <PieceColour colour>
+bool ChessGame::anyLegalMoves() {
+    Move moveList[maxLegalMoves];
+    int count = 0;
+    for (int index = 0; index < pieceCounts[colour] && count == 0; index++) {
+        addPieceMoves<colour>(moveList, count, pieceLists[colour][index]);
+    }
+    return count != 0; // Castling is only legal if the king can also move one square, so it need not be tried
+}
+
+/* ADDS THE LEGAL MOVES OF ONE PIECE OF THE GIVEN ACTIVE COLOUR */
+template <PieceColour colour>
+void ChessGame::addPieceMoves(Move* moveList, int& count, const ChessPiece* piece) {
+    using Traits = ColourTraits<colour>;
+    int rank = piece->getRankIndex();
+    int file = piece->getFileIndex();
+    int origin = rank * 8 + file;
+
+    switch (piece->getType()) {
+        case pawn: {
+            int newRank = rank + Traits::forward; // A pawn is never on its final rank
+            if (chessBoard[newRank][file] == nullptr) { // Advance one or two squares
+                addPawnMove<colour>(moveList, count, origin, newRank * 8 + file);
+                if (rank == Traits::pawnStartRank && chessBoard[newRank + Traits::forward][file] == nullptr) {
+                    addLegalMove<colour>(moveList, count, Move(origin, (newRank + Traits::forward) * 8 + file));
+                }
+            }
+            for (int newFile = file - 1; newFile <= file + 1; newFile += 2) { // Capture diagonally
+                if (newFile < 0 || newFile > 7) {
+                    continue;
+                }
+                ChessPiece* target = chessBoard[newRank][newFile];
+                if ((target != nullptr && target->getColour() != colour) ||
+                    (target == nullptr && enPassantSquare[0] == newRank && enPassantSquare[1] == newFile)) {
+                    addPawnMove<colour>(moveList, count, origin, newRank * 8 + newFile);
+                }
+            }
+            break;
+        }
+        case knight:
+        case king: {
+            SquareSet targets = (piece->getType() == knight ? attackTables.knightAttacks[origin] : attackTables.kingAttacks[origin]);
+            while (targets != 0) {
+                int destination = popSquare(targets);
+                ChessPiece* target = chessBoard[destination / 8][destination % 8];
+                if (target == nullptr || target->getColour() != colour) {
+                    addLegalMove<colour>(moveList, count, Move(origin, destination));
+                }
+            }
+            break;
+        }
+        default: { // Rooks, bishops and queens slide until blocked
+            const UnitMoves& unitMoves = piece->getUnitMoves();
+            for (int move = 0; move < unitMoves.count; move++) {
+                const int* unitMove = unitMoves.moves[move];
+                int newRank = rank + unitMove[0];
+                int newFile = file + unitMove[1];
+                while (newRank >= 0 && newRank < 8 && newFile >= 0 && newFile < 8) {
+                    ChessPiece* target = chessBoard[newRank][newFile];
+                    if (target == nullptr || target->getColour() != colour) {
+                        addLegalMove<colour>(moveList, count, Move(origin, newRank * 8 + newFile));
+                    }
+                    if (target != nullptr) {
+                        break;
+                    }
+                    newRank += unitMove[0];
+                    newFile += unitMove[1];
+                }
+            }
+            break;
+        }
+    }
+}
+
+/* ADDS A PAWN MOVE, EXPANDING A MOVE TO THE FINAL RANK INTO ITS FOUR PROMOTIONS */
+template <PieceColour colour>
+void ChessGame::addPawnMove(Move* moveList, int& count, int origin, int destination) {
+    if (destination / 8 == ColourTraits<colour>::promotionRank) {
+        const Promotion promotions[] = {promoteToQueen, promoteToRook, promoteToBishop, promoteToKnight};
+        for (Promotion promotion : promotions) {
+            addLegalMove<colour>(moveList, count, Move(origin, destination, promotion));
+        }
+    }
+    else {
+        addLegalMove<colour>(moveList, count, Move(origin, destination));
+    }
+}
+
+/* ADDS A MOVE TO THE LIST IF IT DOES NOT LEAVE THE ACTIVE COLOUR'S KING IN CHECK */
+template <PieceColour colour>
+void ChessGame::addLegalMove(Move* moveList, int& count, Move move) {
+    int originRank = move.getOrigin() / 8, originFile = move.getOrigin() % 8;
+    int destinationRank = move.getDestination() / 8, destinationFile = move.getDestination() % 8;
+
+    ChessPiece* movingPiece = chessBoard[originRank][originFile];
+    ChessPiece* capturedPiece = chessBoard[destinationRank][destinationFile];
+
+    // An en passant capture removes a pawn from beside the origin square
+    ChessPiece* enPassantPawn = nullptr;
+    if (movingPiece->getType() == pawn && originFile != destinationFile && capturedPiece == nullptr) {
+        enPassantPawn = chessBoard[originRank][destinationFile];
+        chessBoard[originRank][destinationFile] = nullptr;
+    }
+
+    // Trial the move directly on the board, then test the king's square
+    chessBoard[destinationRank][destinationFile] = movingPiece;
+    chessBoard[originRank][originFile] = nullptr;
+    movingPiece->setPosition(destinationRank, destinationFile);
+
+    const ChessPiece* currentKing = (colour == white ? whiteKing : blackKing);
+    bool leavesKingInCheck = isSquareAttacked<colour>(currentKing->getRankIndex(), currentKing->getFileIndex());
+
+    movingPiece->setPosition(originRank, originFile);
+    chessBoard[originRank][originFile] = movingPiece;
+    chessBoard[destinationRank][destinationFile] = capturedPiece;
+    if (enPassantPawn != nullptr) {
+        chessBoard[originRank][destinationFile] = enPassantPawn;
+    }
+
+    if (!leavesKingInCheck) {
+        moveList[count++] = move;
+    }
+}
+
+/* ADDS THE CASTLING MOVES AVAILABLE TO THE ACTIVE COLOUR */
+template <PieceColour colour>
+void ChessGame::addCastlingMoves(Move* moveList, int& count) {
+    constexpr int homeRank = ColourTraits<colour>::homeRank;
+    bool canCastleKingside = (colour == white ? whiteCanCastleKingside : blackCanCastleKingside);
+    bool canCastleQueenside = (colour == white ? whiteCanCastleQueenside : blackCanCastleQueenside);
+    const ChessPiece* currentKing = (colour == white ? whiteKing : blackKing);
+
+    if ((!canCastleKingside && !canCastleQueenside) || chessBoard[homeRank][4] != currentKing) {
+        return;
+    }
+    if (isSquareAttacked<colour>(homeRank, 4)) { // Cannot castle out of check
+        return;
+    }
+
+    const ChessPiece* kingsideRook = chessBoard[homeRank][7];
+    if (canCastleKingside && kingsideRook != nullptr && kingsideRook->getType() == rook && kingsideRook->getColour() == colour &&
+        chessBoard[homeRank][5] == nullptr && chessBoard[homeRank][6] == nullptr &&
+        !isSquareAttacked<colour>(homeRank, 5) && !isSquareAttacked<colour>(homeRank, 6)) {
+        moveList[count++] = Move(homeRank * 8 + 4, homeRank * 8 + 6);
+    }
+
+    const ChessPiece* queensideRook = chessBoard[homeRank][0];
+    if (canCastleQueenside && queensideRook != nullptr && queensideRook->getType() == rook && queensideRook->getColour() == colour &&
+        chessBoard[homeRank][1] == nullptr && chessBoard[homeRank][2] == nullptr && chessBoard[homeRank][3] == nullptr &&
+        !isSquareAttacked<colour>(homeRank, 3) && !isSquareAttacked<colour>(homeRank, 2)) {
+        moveList[count++] = Move(homeRank * 8 + 4, homeRank * 8 + 2);
+    }
+}
+
+/* COUNTS THE LEAF NODES OF THE LEGAL MOVE TREE TO A GIVEN DEPTH */
+uint64_t ChessGame::perft(int depth) {
+    return (turn == white ? perft<white>(depth) : perft<black>(depth));
+}
+
+/* COUNTS THE LEAF NODES OF THE LEGAL MOVE TREE TO A GIVEN DEPTH, WITH THE GIVEN COLOUR TO MOVE */
+template <PieceColour colour>
+uint64_t ChessGame::perft(int depth) {
+    Move moveList[maxLegalMoves];
+    int count = generateLegalMoves<colour>(moveList);
+
+    if (depth <= 1) { // Count the final ply without making the moves
+        return count;
+    }
+
+    uint64_t nodes = 0;
+    MoveUndo undo;
+    for (int index = 0; index < count; index++) {
+        makeLegalMove<colour>(moveList[index], undo);
+        nodes += perft<ColourTraits<colour>::opponent>(depth - 1);
+        unmakeLegalMove<colour>(undo);
+    }
+    return nodes;
+}
+
+/* MAKES A LEGAL MOVE FOR THE ACTIVE COLOUR WITHOUT VALIDATION OR OUTPUT */
+void ChessGame::makeLegalMove(Move move, MoveUndo& undo) {
+    turn == white ? makeLegalMove<white>(move, undo) : makeLegalMove<black>(move, undo);
+}
+
+/* TAKES BACK A MOVE MADE BY makeLegalMove() BY THE PREVIOUS ACTIVE COLOUR */
+void ChessGame::unmakeLegalMove(const MoveUndo& undo) {
+    turn == white ? unmakeLegalMove<black>(undo) : unmakeLegalMove<white>(undo);
+}
+
+/* DETERMINES WHETHER THE ACTIVE COLOUR'S KING IS ATTACKED */
+bool ChessGame::activeColourInCheck() {
+    const ChessPiece* currentKing = (turn == white ? whiteKing : blackKing);
+    return (turn == white ? isSquareAttacked<white>(currentKing->getRankIndex(), currentKing->getFileIndex())
+                          : isSquareAttacked<black>(currentKing->getRankIndex(), currentKing->getFileIndex()));
+}
+
+/* OBTAINS EVERY SQUARE ATTACKED BY A COLOUR WITH SET-WISE SHIFTS */
+SquareSet ChessGame::attackedSquares(PieceColour colour) const {
+    SquareSet occupied = 0;
+    SquareSet pieces[6] = {0, 0, 0, 0, 0, 0}; // The squares of the attacking pieces, indexed by PieceType
+    for (PieceColour side : {white, black}) {
+        for (int index = 0; index < pieceCounts[side]; index++) {
+            const ChessPiece* piece = pieceLists[side][index];
+            SquareSet square = SquareSet(1) << (piece->getRankIndex() * 8 + piece->getFileIndex());
+            occupied |= square;
+            if (side == colour) {
+                pieces[piece->getType()] |= square;
+            }
+        }
+    }
+
+    SquareSet empty = ~occupied;
+    SquareSet straightSliders = pieces[rook] | pieces[queen];
+    SquareSet diagonalSliders = pieces[bishop] | pieces[queen];
+
+    SquareSet attacks = pawnAttackSet(pieces[pawn], colour) | knightAttackSet(pieces[knight]);
+    if (pieces[king] != 0) {
+        attacks |= attackTables.kingAttacks[__builtin_ctzll(pieces[king])];
+    }
+    attacks |= slidingAttackSet(straightSliders, empty, 8, ~SquareSet(0)) | slidingAttackSet(straightSliders, empty, -8, ~SquareSet(0)) |
+               slidingAttackSet(straightSliders, empty, 1, notFileA) | slidingAttackSet(straightSliders, empty, -1, notFileH);
+    attacks |= slidingAttackSet(diagonalSliders, empty, 9, notFileA) | slidingAttackSet(diagonalSliders, empty, -7, notFileA) |
+               slidingAttackSet(diagonalSliders, empty, 7, notFileH) | slidingAttackSet(diagonalSliders, empty, -9, notFileH);
+    return attacks;
+}
+
+/* DETERMINES WHETHER A SQUARE IS ATTACKED BY A COLOUR, ONE SQUARE AT A TIME */
+bool ChessGame::squareAttacked(int square, PieceColour colour) {
+    // isSquareAttacked() is specialised on the colour being attacked
+    return (colour == white ? isSquareAttacked<black>(square / 8, square % 8) : isSquareAttacked<white>(square / 8, square % 8));
+}
+
+/* GETTER FOR THE ZOBRIST HASH OF THE PAWNS */
+uint64_t ChessGame::pawnHash() const {
+    return pawnKey;
+}
+
+/* OBTAINS THE SQUARES OF EVERY PIECE OF ONE COLOUR AND TYPE */
+SquareSet ChessGame::pieceSquares(PieceColour colour, PieceType type) const {
+    SquareSet squares = 0;
+    for (int index = 0; index < pieceCounts[colour]; index++) {
+        const ChessPiece* piece = pieceLists[colour][index];
+        if (piece->getType() == type) {
+            squares |= SquareSet(1) << (piece->getRankIndex() * 8 + piece->getFileIndex());
+        }
+    }
+    return squares;
+}
+
+/* GETTER FOR THE HALF-MOVE COUNTER */
+int ChessGame::getHalfMoveCounter() const {
+    return halfMoveCounter;
+}
+
+/* SUMS THE MATERIAL OF EACH SIDE FROM THE ACTIVE COLOUR'S PERSPECTIVE */
+int ChessGame::materialBalance() const {
+    static const int pieceValues[] = {100, 500, 320, 330, 900, 0}; // Indexed by PieceType
+
+    int balance = 0;
+    for (int colour = 0; colour < 2; colour++) {
+        int material = 0;
+        for (int index = 0; index < pieceCounts[colour]; index++) {
+            material += pieceValues[pieceLists[colour][index]->getType()];
+        }
+        balance += (colour == turn ? material : -material);
+    }
+    return balance;
+}
+
+/* MAKES A LEGAL MOVE ON THE BOARD WITHOUT VALIDATION OR OUTPUT */
+template <PieceColour colour>
+void ChessGame::makeLegalMove(Move move, MoveUndo& undo) {
+    int originRank = move.getOrigin() / 8, originFile = move.getOrigin() % 8;
+    int destinationRank = move.getDestination() / 8, destinationFile = move.getDestination() % 8;
+    ChessPiece* movingPiece = chessBoard[originRank][originFile];
+
+    undo.move = move;
+    undo.movedPiece = movingPiece;
+    undo.capturedPiece = chessBoard[destinationRank][destinationFile];
+    undo.capturedSquare = move.getDestination();
+    undo.promotedPiece = nullptr;
+    undo.castlingRights[0] = whiteCanCastleKingside;
+    undo.castlingRights[1] = whiteCanCastleQueenside;
+    undo.castlingRights[2] = blackCanCastleKingside;
+    undo.castlingRights[3] = blackCanCastleQueenside;
+    undo.enPassantSquare[0] = enPassantSquare[0];
+    undo.enPassantSquare[1] = enPassantSquare[1];
+    undo.halfMoveCounter = halfMoveCounter;
+    undo.fullMoveCounter = fullMoveCounter;
+
+    // An en passant capture removes a pawn from beside the origin square
+    if (movingPiece->getType() == pawn && originFile != destinationFile && undo.capturedPiece == nullptr) {
+        undo.capturedPiece = chessBoard[originRank][destinationFile];
+        undo.capturedSquare = originRank * 8 + destinationFile;
+        chessBoard[originRank][destinationFile] = nullptr;
+    }
+
+    if (undo.capturedPiece != nullptr) {
+        removeFromPieceList(undo.capturedPiece);
+    }
+
+    int originCoord[2] = {originRank, originFile};
+    int destinationCoord[2] = {destinationRank, destinationFile};
+    chessBoard[destinationRank][destinationFile] = nullptr;
+    makeMove(originCoord, destinationCoord);
+
+    // Castling also moves the rook
+    if (movingPiece->getType() == king && abs(destinationFile - originFile) == 2) {
+        int rookOriginCoord[2] = {originRank, (destinationFile > originFile ? 7 : 0)};
+        int rookDestinationCoord[2] = {originRank, (destinationFile > originFile ? 5 : 3)};
+        makeMove(rookOriginCoord, rookDestinationCoord);
+    }
+
+    toggleCastlingFlags<colour>(movingPiece, originCoord, destinationCoord);
+
+    // Set the en passant square for the next turn
+    if (movingPiece->getType() == pawn && abs(destinationRank - originRank) == 2) {
+        enPassantSquare[0] = originRank + ColourTraits<colour>::forward;
+        enPassantSquare[1] = originFile;
+    }
+    else {
+        enPassantSquare[0] = -1;
+    }
+
+    // Promote a pawn that has reached the final rank, keeping the pawn to restore on takeback
+    if (movingPiece->getType() == pawn && destinationRank == ColourTraits<colour>::promotionRank) {
+        removeFromPieceList(movingPiece);
+        undo.promotedPiece = createChessPiece(pieceAbbrName(colour, promotionPieceType(move.getPromotion())), destinationRank, destinationFile);
+        chessBoard[destinationRank][destinationFile] = undo.promotedPiece;
+    }
+
+    halfMoveCounter = ((movingPiece->getType() == pawn || undo.capturedPiece != nullptr) ? 0 : halfMoveCounter + 1);
+    if (colour == black) {
+        fullMoveCounter++;
+    }
+    turn = ColourTraits<colour>::opponent;
+}
+
+/* TAKES BACK A MOVE MADE BY makeLegalMove() */
+template <PieceColour colour>
+void ChessGame::unmakeLegalMove(const MoveUndo& undo) {
+    turn = colour;
+
+    int originRank = undo.move.getOrigin() / 8, originFile = undo.move.getOrigin() % 8;
+    int destinationRank = undo.move.getDestination() / 8, destinationFile = undo.move.getDestination() % 8;
+
+    if (undo.promotedPiece != nullptr) {
+        ChessPiece* promotedPiece = undo.promotedPiece;
+        deletePiece(promotedPiece);
+        addToPieceList(undo.movedPiece);
+    }
+    chessBoard[destinationRank][destinationFile] = nullptr;
+    chessBoard[originRank][originFile] = undo.movedPiece;
+    undo.movedPiece->setPosition(originRank, originFile);
+    if (undo.movedPiece->getType() == pawn) {
+        pawnKey ^= zobristKeys.pieces[colour][pawn][undo.move.getOrigin()] ^ zobristKeys.pieces[colour][pawn][undo.move.getDestination()];
+    }
+
+    if (undo.movedPiece->getType() == king && abs(destinationFile - originFile) == 2) { // Move the castled rook back
+        int rookOriginCoord[2] = {originRank, (destinationFile > originFile ? 5 : 3)};
+        int rookDestinationCoord[2] = {originRank, (destinationFile > originFile ? 7 : 0)};
+        makeMove(rookOriginCoord, rookDestinationCoord);
+    }
+
+    if (undo.capturedPiece != nullptr) {
+        chessBoard[undo.capturedSquare / 8][undo.capturedSquare % 8] = undo.capturedPiece;
+        addToPieceList(undo.capturedPiece);
+    }
+
+    whiteCanCastleKingside = undo.castlingRights[0];
+    whiteCanCastleQueenside = undo.castlingRights[1];
+    blackCanCastleKingside = undo.castlingRights[2];
+    blackCanCastleQueenside = undo.castlingRights[3];
+    enPassantSquare[0] = undo.enPassantSquare[0];
+    enPassantSquare[1] = undo.enPassantSquare[1];
+    halfMoveCounter = undo.halfMoveCounter;
+    fullMoveCounter = undo.fullMoveCounter;
+}
+
+/* TAKES A SNAPSHOT OF THE FULL STATE OF THE GAME */
+Position ChessGame::savePosition() const {
+    Position position;
+    for (int rank = 0; rank < 8; rank++) {
+        for (int file = 0; file < 8; file++) {
+            const ChessPiece* piece = chessBoard[rank][file];
+            position.squares[rank * 8 + file] = (piece != nullptr ? piece->getAbbrName() : '\0');
+        }
+    }
+
+    position.turn = turn;
+    position.castlingRights = packCastlingRights();
+    position.enPassantSquare = (enPassantSquare[0] == -1 ? -1 : enPassantSquare[0] * 8 + enPassantSquare[1]);
+    position.statusFlags = packStatusFlags();
+    position.halfMoveCounter = halfMoveCounter;
+    position.fullMoveCounter = fullMoveCounter;
+    return position;
+}
+
+/* RESTORES THE GAME TO A SNAPSHOT, REBUILDING ONLY THE SQUARES THAT DIFFER */
+void ChessGame::restorePosition(const Position& position) {
+    Position current = savePosition();
+
+    // Remove every piece that is out of place before placing any, so the piece lists never overfill
+    for (int square = 0; square < 64; square++) {
+        ChessPiece*& piece = chessBoard[square / 8][square % 8];
+        if (current.squares[square] != position.squares[square] && piece != nullptr) {
+            deletePiece(piece);
+        }
+    }
+    for (int square = 0; square < 64; square++) {
+        if (current.squares[square] != position.squares[square] && position.squares[square] != '\0') {
+            chessBoard[square / 8][square % 8] = createChessPiece(position.squares[square], square / 8, square % 8);
+        }
+    }
+
+    turn = static_cast<PieceColour>(position.turn);
+    unpackCastlingRights(position.castlingRights);
+    enPassantSquare[0] = (position.enPassantSquare == -1 ? -1 : position.enPassantSquare / 8);
+    enPassantSquare[1] = (position.enPassantSquare == -1 ? -1 : position.enPassantSquare % 8);
+    unpackStatusFlags(position.statusFlags);
+    halfMoveCounter = position.halfMoveCounter;
+    fullMoveCounter = position.fullMoveCounter;
+
+    // Clear the per-move state, which a snapshot never holds, and the moves made before it
+    castlingStatus = regularMove;
+    enPassantCapture = false;
+    cachedPositionCurrent = false;
+    clearHistory();
+}
+
+/* DETERMINES WHETHER A COLOUR ATTACKS A SQUARE OF A SNAPSHOT, WITHOUT PLACING ITS PIECES ON A BOARD */
+static bool snapshotSquareAttacked(const Position& position, int square, PieceColour colour) {
+    // Looks outwards from the square for each kind of attacker, rather than at every piece of the colour
+    const SquareSet stepperSquares[3] = {attackTables.pawnAttacks[colour == white ? black : white][square],
+                                         attackTables.knightAttacks[square], attackTables.kingAttacks[square]};
+    const PieceType stepperTypes[3] = {pawn, knight, king};
+    for (int kind = 0; kind < 3; kind++) {
+        char attacker = pieceAbbrName(colour, stepperTypes[kind]);
+        for (SquareSet from = stepperSquares[kind]; from != 0;) {
+            if (position.squares[popSquare(from)] == attacker) {
+                return true;
+            }
+        }
+    }
+
+    char queenName = pieceAbbrName(colour, queen);
+    for (int direction = 0; direction < queenUnitMoves.count; direction++) {
+        int rankStep = queenUnitMoves.moves[direction][0], fileStep = queenUnitMoves.moves[direction][1];
+        char slider = pieceAbbrName(colour, rankStep == 0 || fileStep == 0 ? rook : bishop);
+        int rank = square / 8 + rankStep, file = square % 8 + fileStep;
+        for (; rank >= 0 && rank < 8 && file >= 0 && file < 8; rank += rankStep, file += fileStep) {
+            char piece = position.squares[rank * 8 + file];
+            if (piece != '\0') {
+                if (piece == slider || piece == queenName) {
+                    return true;
+                }
+                break;
+            }
+        }
+    }
+    return false;
+}
+
+/* DETERMINES WHETHER A SNAPSHOT IS A POSITION THE RULES ENGINE CAN PLAY FROM */
+static bool isPlayablePosition(const Position& position) {
+    int pieces[2] = {0, 0}, kings[2] = {0, 0}, kingSquares[2] = {0, 0};
+    for (int square = 0; square < 64; square++) {
+        char piece = position.squares[square];
+        if (piece == '\0') {
+            continue;
+        }
+        if (pieceTypeOf(piece) < 0) {
+            return false;
+        }
+        int colour = (piece >= 'a' ? black : white);
+        pieces[colour]++;
+        if ((piece | 0x20) == 'k') {
+            kings[colour]++;
+            kingSquares[colour] = square;
+        }
+        if ((piece | 0x20) == 'p' && (square < 8 || square >= 56)) { // Move generation never looks beyond a pawn's final rank
+            return false;
+        }
+    }
+    if (pieces[white] > maxPiecesPerColour || pieces[black] > maxPiecesPerColour || kings[white] != 1 || kings[black] != 1
+        || position.turn > black || position.castlingRights > 15) {
+        return false;
+    }
+
+    // Each castling right needs its king and rook (bit 0 K, bit 1 Q, bit 2 k, bit 3 q), as castling moves them blindly
+    static const int rookSquares[4] = {7, 0, 63, 56};
+    for (int right = 0; right < 4; right++) {
+        int kingSquare = (right < 2 ? 4 : 60);
+        if ((position.castlingRights >> right & 1) && (position.squares[kingSquare] != (right < 2 ? 'K' : 'k')
+                                                       || position.squares[rookSquares[right]] != (right < 2 ? 'R' : 'r'))) {
+            return false;
+        }
+    }
+
+    // An en passant capture removes the pawn behind the en passant square
+    if (position.enPassantSquare != -1) {
+        int square = position.enPassantSquare;
+        int forward = (position.turn == white ? 8 : -8); // From the en passant square towards the pawn's origin
+        char pawn = (position.turn == white ? 'p' : 'P');
+        if (square < 0 || square >= 64 || square / 8 != (position.turn == white ? 5 : 2) || position.squares[square] != '\0'
+            || position.squares[square + forward] != '\0' || position.squares[square - forward] != pawn) {
+            return false;
+        }
+    }
+
+    // The king of the side not to move cannot be in check (tested on the snapshot, without placing its pieces)
+    PieceColour mover = static_cast<PieceColour>(position.turn);
+    return !snapshotSquareAttacked(position, kingSquares[mover == white ? black : white], mover);
+}
+
+/* RESTORES THE GAME TO A SNAPSHOT IF ITS POSITION IS PLAYABLE */
+bool ChessGame::restorePlayablePosition(const Position& position) {
+    if (!isPlayablePosition(position)) {
+        return false;
+    }
+    restorePosition(position);
+    return true;
+}
+
+/* LOADS A FEN STRING FROM OUTSIDE THE ENGINE IF IT IS WELL FORMED AND PLAYABLE */
+bool ChessGame::loadPlayableState(const char* fenString) {
+    Position position;
+    return parseFen(fenString, position) && restorePlayablePosition(position);
+}
+
+/* PACKS THE CURRENT POSITION, DIRECTLY FROM THE BOARD */
+PackedPosition ChessGame::savePackedPosition() const {
+    PackedPosition packed = {};
+    uint8_t* bytes = packed.bytes;
+
+    uint64_t occupancy = 0;
+    int pieceIndex = 0;
+    for (int square = 0; square < 64; square++) {
+        const ChessPiece* piece = chessBoard[square / 8][square % 8];
+        if (piece != nullptr) {
+            occupancy |= uint64_t(1) << square;
+            bytes[8 + pieceIndex / 2] |= static_cast<uint8_t>((piece->getType() | (piece->getColour() << 3)) << (4 * (pieceIndex % 2)));
+            pieceIndex++;
+        }
+    }
+    for (int index = 0; index < 8; index++) {
+        bytes[index] = static_cast<uint8_t>(occupancy >> (8 * index));
+    }
+
+    bytes[24] = static_cast<uint8_t>(turn | (whiteCanCastleKingside ? 2 : 0) | (whiteCanCastleQueenside ? 4 : 0) |
+                                     (blackCanCastleKingside ? 8 : 0) | (blackCanCastleQueenside ? 16 : 0));
+    bytes[25] = static_cast<uint8_t>(enPassantSquare[0] == -1 ? 0xFF : enPassantSquare[0] * 8 + enPassantSquare[1]);
+    bytes[26] = static_cast<uint8_t>(min(halfMoveCounter, 255));
+    bytes[30] = static_cast<uint8_t>(fullMoveCounter & 0xFF);
+    bytes[31] = static_cast<uint8_t>(fullMoveCounter >> 8);
+    return packed;
+}
+
+/* OBTAINS THE FEN CHARACTER OF A PACKED PIECE CODE (TYPE | COLOUR << 3), OR '\0' FOR AN UNUSED CODE */
+static char packedCodeAbbrName(uint8_t code) {
+    return ((code & 7) <= king ? pieceAbbrName(static_cast<PieceColour>(code >> 3), static_cast<PieceType>(code & 7)) : '\0');
+}
+
+/* LOADS A PACKED POSITION WITHOUT OUTPUT, REBUILDING ONLY THE SQUARES THAT DIFFER */
+bool ChessGame::loadPackedPosition(const PackedPosition& packed) {
+    const uint8_t* bytes = packed.bytes;
+
+    // Check the whole packing, and that its position is playable, before changing anything, so that a rejected one
+    // leaves the game unchanged. The snapshot is only checked; the board is rebuilt from the packing itself.
+    Position position;
+    if (!unpackPosition(packed, position) || !isPlayablePosition(position)) {
+        return false;
+    }
+    uint64_t occupancy = 0;
+    for (int index = 0; index < 8; index++) {
+        occupancy |= static_cast<uint64_t>(bytes[index]) << (8 * index);
+    }
+
+    // Pieces captured by makeLegalMove() whose moves were never taken back are only freed by clearing the board
+    if (piecePool.getPiecesInUse() != pieceCounts[white] + pieceCounts[black]) {
+        cleanChessBoard();
+    }
+
+    // As in decodePartOne(), out-of-place pieces are all removed before the changed squares are filled. Only the
+    // pieces in the lists and the occupied squares of the packing are visited, rather than every square. The lists
+    // are walked backwards, as removing a piece moves the last piece of its list (already visited) into its place.
+    for (int colour = 0; colour < 2; colour++) {
+        for (int index = pieceCounts[colour] - 1; index >= 0; index--) {
+            ChessPiece* piece = pieceLists[colour][index];
+            int square = piece->getRankIndex() * 8 + piece->getFileIndex();
+            if ((occupancy >> square) & 1) {
+                int pieceIndex = __builtin_popcountll(occupancy & ((uint64_t(1) << square) - 1));
+                if (piece->getAbbrName() == packedCodeAbbrName((bytes[8 + pieceIndex / 2] >> (4 * (pieceIndex % 2))) & 0xF)) {
+                    continue;
+                }
+            }
+            deletePiece(chessBoard[square / 8][square % 8]);
+        }
+    }
+    for (int pieceIndex = 0; occupancy != 0; pieceIndex++, occupancy &= occupancy - 1) {
+        int square = __builtin_ctzll(occupancy);
+        ChessPiece*& piece = chessBoard[square / 8][square % 8];
+        if (piece == nullptr) {
+            piece = createChessPiece(packedCodeAbbrName((bytes[8 + pieceIndex / 2] >> (4 * (pieceIndex % 2))) & 0xF), square / 8, square % 8);
+        }
+    }
+
+    turn = (bytes[24] & 1 ? black : white);
+    whiteCanCastleKingside = bytes[24] & 2;
+    whiteCanCastleQueenside = bytes[24] & 4;
+    blackCanCastleKingside = bytes[24] & 8;
+    blackCanCastleQueenside = bytes[24] & 16;
+    enPassantSquare[0] = (bytes[25] == 0xFF ? -1 : bytes[25] / 8);
+    enPassantSquare[1] = (bytes[25] == 0xFF ? -1 : bytes[25] % 8);
+    halfMoveCounter = bytes[26];
+    fullMoveCounter = bytes[30] | (bytes[31] << 8);
+
+    // Clear the state of any previously loaded game, as decodeFenString() does
+    castlingStatus = regularMove;
+    enPassantCapture = false;
+    cachedPositionCurrent = false;
+    clearHistory();
+    endGame = false;
+    gameLoaded = true;
+    if (lazyGameState) {
+        gameStateCurrent = false; // Evaluated when it is first queried
+    }
+    else {
+        computeGameState();
+    }
+    return true;
+}
+
+/* SETS THE NUMBER OF MOVES KEPT IN THE HISTORY, ALLOCATING IT ONCE */
+void ChessGame::setHistoryLimit(int plies) {
+    history.assign(max(plies, 0), HistoryEntry());
+    history.shrink_to_fit();
+    clearHistory();
+}
+
+/* TAKES BACK THE MOST RECENT MOVES, NEWEST FIRST */
+int ChessGame::undoMoves(int count) {
+    int undone = 0;
+    for (; undone < count && undoableMoves > 0; undone++) {
+        undoableMoves--;
+        redoableMoves++;
+        undoHistoryEntry(history[(historyStart + undoableMoves) % history.size()]);
+    }
+    castlingStatus = regularMove;
+    enPassantCapture = false;
+    cachedPositionCurrent = false;
+    return undone;
+}
+
+/* MAKES AGAIN THE MOVES MOST RECENTLY TAKEN BACK, OLDEST FIRST */
+int ChessGame::redoMoves(int count) {
+    int redone = 0;
+    for (; redone < count && redoableMoves > 0; redone++) {
+        redoHistoryEntry(history[(historyStart + undoableMoves) % history.size()]);
+        undoableMoves++;
+        redoableMoves--;
+    }
+    castlingStatus = regularMove;
+    enPassantCapture = false;
+    cachedPositionCurrent = false;
+    return redone;
+}
+
+/* GETTER FOR THE NUMBER OF MOVES THAT CAN BE TAKEN BACK */
+int ChessGame::getUndoableMoves() const {
+    return undoableMoves;
+}
+
+/* GETTER FOR THE NUMBER OF MOVES THAT CAN BE REDONE */
+int ChessGame::getRedoableMoves() const {
+    return redoableMoves;
+}
+
+/* ATTACHES A SHARED MOVE CACHE TO THE GAME */
+void ChessGame::setMoveCache(MoveCache* cache) {
+    moveCache = cache;
+    cachedPositionCurrent = false;
+}
+
+/* DETERMINES WHETHER A MOVE IS LEGAL BY LOOKING IT UP IN THE CACHED LEGAL MOVES OF THE CURRENT POSITION */
+bool ChessGame::checkMoveCached(const int* originCoord, const int* destinationCoord, Promotion promotion) {
+    if (!cachedPositionCurrent) {
+        lookupCachedPosition(positionHash());
+    }
+
+    // Moves to the final rank by a pawn are cached with their promotion (a queen unless specified)
+    ChessPiece* pieceAtOrigin = getPiece(originCoord);
+    bool promoting = (pieceAtOrigin != nullptr && pieceAtOrigin->getType() == pawn && (destinationCoord[0] == 0 || destinationCoord[0] == 7));
+    Promotion flag = (!promoting ? noPromotion : (promotion == noPromotion ? promoteToQueen : promotion));
+    Move move(originCoord[0] * 8 + originCoord[1], destinationCoord[0] * 8 + destinationCoord[1], flag);
+
+    if (pieceAtOrigin == nullptr || !cachedPosition.containsMove(move)) {
+        // Illegal moves are rare, so explain why using the full validation
+        checkMoveValid(originCoord, destinationCoord);
+        castlingStatus = regularMove;
+        enPassantCapture = false;
+        return false;
+    }
+
+    // Identify castling and en passant as checkMoveValid() would
+    if (pieceAtOrigin->getType() == king && abs(originCoord[1] - destinationCoord[1]) == 2) {
+        castlingStatus = (originCoord[1] < destinationCoord[1]) ? kingsideCastle : queensideCastle;
+    }
+    if (pieceAtOrigin->getType() == pawn && originCoord[1] != destinationCoord[1] && getPiece(destinationCoord) == nullptr) {
+        enPassantCapture = true;
+    }
+    return true;
+}
+
+/* LOADS THE CURRENT POSITION FROM THE MOVE CACHE, COMPUTING AND INSERTING IT ON A MISS */
+void ChessGame::lookupCachedPosition(uint64_t hash) {
+    if (!moveCache->find(hash, cachedPosition)) {
+        computePositionState(cachedPosition, hash);
+        moveCache->insert(cachedPosition);
+    }
+    cachedPositionCurrent = true;
+}
+
+/* COMPUTES THE LEGAL MOVES AND GAME STATE OF THE CURRENT POSITION FOR THE ACTIVE COLOUR */
+void ChessGame::computePositionState(CachedPosition& position, uint64_t hash) {
+    position.hash = hash;
+    position.moveCount = generateLegalMoves(position.moves);
+    sort(position.moves, position.moves + position.moveCount, [](const Move& move1, const Move& move2) { return move1.getRaw() < move2.getRaw(); });
+
+    const ChessPiece* currentKing = (turn == white ? whiteKing : blackKing);
+    bool inCheck = detectCheck(currentKing->getRankIndex(), currentKing->getFileIndex(), turn, false);
+
+    position.stateFlags = (inCheck ? sideInCheck : 0);
+    if (position.moveCount == 0) {
+        position.stateFlags |= (inCheck ? sideCheckmated : sideStalemated);
+    }
+}
+
+/* SETS THE GAME STATE AFTER A MOVE FROM THE CACHED STATE OF THE RESULTING POSITION */
+void ChessGame::applyCachedGameState() {
+    PieceColour oppositeTurn = ((turn == white) ? black : white);
+
+    // Look up the resulting position from the perspective of the player to move next
+    turn = oppositeTurn;
+    lookupCachedPosition(positionHash());
+    turn = ((oppositeTurn == white) ? black : white);
+
+    bool checkDetected = (cachedPosition.stateFlags & sideInCheck);
+    (turn == white ? whiteInCheck : blackInCheck) = false; // A legal move never leaves the mover in check
+    (oppositeTurn == white ? whiteInCheck : blackInCheck) = checkDetected;
+
+    // DETECT CHECKMATE
+    if (cachedPosition.stateFlags & sideCheckmated) {
+        console() << "\n" << oppositeTurn << " is in checkmate";
+        endGame = true;
+    }
+
+    // DETECT STALEMATE
+    if (cachedPosition.stateFlags & sideStalemated) {
+        console() << "\nEnd of game - Stalemate";
+        endGame = true;
+    }
+
+    // DETECT DRAW BY 50-MOVE RULE
+    if (!endGame && halfMoveCounter >= 100) {
+        console() << "\nEnd of game - draw by 50-move rule\n";
+        endGame = true;
+    }
+
+    if (!endGame && checkDetected) { // If game continues then output check message
+        console() << "\n" << oppositeTurn << " is in check";
+    }
 }
 
 /* PRINTS THE CHESS BOARD TO THE CONSOLE */
@@ -1084,4 +2001,126 @@ int* ChessGame::getEnPassantSquare() {
 //     }
 
 //     std::cout << "   a  b  c  d  e  f  g  h\n"; // Column labels again
-// }
\ No newline at end of file
+// }
+
+
+/************************** HELPER FUNCTIONS FOR SNAPSHOTS AND THE HISTORY **************************/
+
+/* PACKS THE CASTLING RIGHTS */
+uint8_t ChessGame::packCastlingRights() const {
+    return (whiteCanCastleKingside ? 1 : 0) | (whiteCanCastleQueenside ? 2 : 0) |
+           (blackCanCastleKingside ? 4 : 0) | (blackCanCastleQueenside ? 8 : 0);
+}
+
+/* SETS THE CASTLING RIGHTS FROM THEIR PACKED FORM */
+void ChessGame::unpackCastlingRights(uint8_t castlingRights) {
+    whiteCanCastleKingside = castlingRights & 1;
+    whiteCanCastleQueenside = castlingRights & 2;
+    blackCanCastleKingside = castlingRights & 4;
+    blackCanCastleQueenside = castlingRights & 8;
+}
+
+/* PACKS THE LOADED, GAME OVER, CHECK AND STALE FLAGS */
+uint8_t ChessGame::packStatusFlags() const {
+    return (gameLoaded ? positionLoaded : 0) | (endGame ? positionGameOver : 0) |
+           (whiteInCheck ? positionWhiteInCheck : 0) | (blackInCheck ? positionBlackInCheck : 0) |
+           (gameStateCurrent ? 0 : positionStateStale);
+}
+
+/* SETS THE LOADED, GAME OVER, CHECK AND STALE FLAGS FROM THEIR PACKED FORM */
+void ChessGame::unpackStatusFlags(uint8_t statusFlags) {
+    gameLoaded = statusFlags & positionLoaded;
+    endGame = statusFlags & positionGameOver;
+    whiteInCheck = statusFlags & positionWhiteInCheck;
+    blackInCheck = statusFlags & positionBlackInCheck;
+    gameStateCurrent = !(statusFlags & positionStateStale);
+}
+
+/* STORES THE STATE A MOVE CHANGES IN A HISTORY ENTRY */
+void ChessGame::saveHistoryState(HistoryEntry& entry, int after) const {
+    entry.castlingRights[after] = packCastlingRights();
+    entry.enPassantSquare[after] = static_cast<int8_t>(enPassantSquare[0] == -1 ? -1 : enPassantSquare[0] * 8 + enPassantSquare[1]);
+    entry.statusFlags[after] = packStatusFlags();
+    entry.halfMoveCounter[after] = static_cast<uint16_t>(halfMoveCounter);
+    entry.fullMoveCounter[after] = static_cast<uint16_t>(fullMoveCounter);
+}
+
+/* RESTORES THE STATE A MOVE CHANGES FROM A HISTORY ENTRY */
+void ChessGame::restoreHistoryState(const HistoryEntry& entry, int after) {
+    unpackCastlingRights(entry.castlingRights[after]);
+    enPassantSquare[0] = (entry.enPassantSquare[after] == -1 ? -1 : entry.enPassantSquare[after] / 8);
+    enPassantSquare[1] = (entry.enPassantSquare[after] == -1 ? -1 : entry.enPassantSquare[after] % 8);
+    unpackStatusFlags(entry.statusFlags[after]);
+    halfMoveCounter = entry.halfMoveCounter[after];
+    fullMoveCounter = entry.fullMoveCounter[after];
+}
+
+/* ADDS A MOVE JUST MADE TO THE HISTORY */
+void ChessGame::recordHistory(const HistoryEntry& entry) {
+    redoableMoves = 0; // A new move replaces the moves taken back
+    if (undoableMoves == static_cast<int>(history.size())) { // Drop the oldest move
+        historyStart = (historyStart + 1) % history.size();
+        undoableMoves--;
+    }
+    history[(historyStart + undoableMoves) % history.size()] = entry;
+    undoableMoves++;
+}
+
+/* CLEARS THE HISTORY */
+void ChessGame::clearHistory() {
+    historyStart = 0;
+    undoableMoves = 0;
+    redoableMoves = 0;
+}
+
+/* TAKES BACK THE MOVE OF A HISTORY ENTRY */
+void ChessGame::undoHistoryEntry(const HistoryEntry& entry) {
+    int originCoord[2] = {entry.move.getOrigin() / 8, entry.move.getOrigin() % 8};
+    int destinationCoord[2] = {entry.move.getDestination() / 8, entry.move.getDestination() % 8};
+    turn = (turn == white ? black : white); // The colour that made the move, whose king makeMove() tracks
+
+    if (entry.move.getPromotion() != noPromotion) { // Replace the promoted piece with the pawn
+        deletePiece(chessBoard[destinationCoord[0]][destinationCoord[1]]);
+        chessBoard[originCoord[0]][originCoord[1]] = createChessPiece(turn == white ? 'P' : 'p', originCoord[0], originCoord[1]);
+    }
+    else {
+        makeMove(destinationCoord, originCoord);
+        const ChessPiece* movedPiece = chessBoard[originCoord[0]][originCoord[1]];
+        if (movedPiece->getType() == king && abs(destinationCoord[1] - originCoord[1]) == 2) { // Move the castled rook back
+            int rookOriginCoord[2] = {originCoord[0], (destinationCoord[1] > originCoord[1] ? 5 : 3)};
+            int rookDestinationCoord[2] = {originCoord[0], (destinationCoord[1] > originCoord[1] ? 7 : 0)};
+            makeMove(rookOriginCoord, rookDestinationCoord);
+        }
+    }
+
+    if (entry.capturedPiece != '\0') {
+        int rank = entry.capturedSquare / 8, file = entry.capturedSquare % 8;
+        chessBoard[rank][file] = createChessPiece(entry.capturedPiece, rank, file);
+    }
+    restoreHistoryState(entry, 0);
+}
+
+/* MAKES AGAIN THE MOVE OF A HISTORY ENTRY */
+void ChessGame::redoHistoryEntry(const HistoryEntry& entry) {
+    int originCoord[2] = {entry.move.getOrigin() / 8, entry.move.getOrigin() % 8};
+    int destinationCoord[2] = {entry.move.getDestination() / 8, entry.move.getDestination() % 8};
+
+    if (entry.capturedPiece != '\0') {
+        deletePiece(chessBoard[entry.capturedSquare / 8][entry.capturedSquare % 8]);
+    }
+    makeMove(originCoord, destinationCoord);
+
+    ChessPiece*& movedPiece = chessBoard[destinationCoord[0]][destinationCoord[1]];
+    if (movedPiece->getType() == king && abs(destinationCoord[1] - originCoord[1]) == 2) { // Castling also moves the rook
+        int rookOriginCoord[2] = {originCoord[0], (destinationCoord[1] > originCoord[1] ? 7 : 0)};
+        int rookDestinationCoord[2] = {originCoord[0], (destinationCoord[1] > originCoord[1] ? 5 : 3)};
+        makeMove(rookOriginCoord, rookDestinationCoord);
+    }
+    if (entry.move.getPromotion() != noPromotion) {
+        deletePiece(movedPiece);
+        movedPiece = createChessPiece(pieceAbbrName(turn, promotionPieceType(entry.move.getPromotion())), destinationCoord[0], destinationCoord[1]);
+    }
+
+    turn = (turn == white ? black : white);
+    restoreHistoryState(entry, 1);
+}
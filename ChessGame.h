@@ -17,10 +17,21 @@ class ChessGame;
 class ChessPiece;
 
 #include "ChessPiece.h"
+#include "Move.h"
+#include "MoveCache.h"
+#include "PiecePool.h"
+#include "PackedPosition.h"
+#include "Position.h"
+#include <cstdint>
+#include <ostream>
+#include <vector>
 
 // Global constants representing the standard size of a chess board
 const int ranks = 8, files = 8;
 
+// The maximum number of pieces of one colour on the board
+const int maxPiecesPerColour = 16;
+
 
 /****************************** Class ChessPiece ******************************/
 
@@ -65,8 +76,66 @@ class ChessGame final {
          * 
          * @param stringCoord1 The string literal letter-integer coordinates (e.g. "A1") of the piece to move.
          * @param stringCoord2 The string literal letter-integer coordinates (e.g. "B2") of the destination square.
+         * 
+         * @return true if the move was legal and has been made; false otherwise.
          */
-        void submitMove(const char* stringCoord1, const char* stringCoord2);
+        bool submitMove(const char* stringCoord1, const char* stringCoord2);
+
+        /* 
+         * Accepts a move in its compact 16-bit encoding. Behaves exactly as submitMove() with 
+         * letter-integer coordinates, additionally promoting a pawn that reaches the final rank 
+         * to the piece given by the move's promotion flag (a queen if none is given).
+         * 
+         * @param move The move to make.
+         * 
+         * @return true if the move was legal and has been made; false otherwise.
+         */
+        bool submitMove(Move move);
+
+        /*
+         * Makes a sequence of moves, as submitMove() would, stopping at the first move that is
+         * illegal. The game state is not evaluated after each move, whether or not lazy evaluation
+         * is enabled (see setLazyGameState()); it is evaluated once, when it is next queried.
+         *
+         * @param moves The moves to make, in order.
+         * @param count The number of moves.
+         *
+         * @return The number of moves made.
+         */
+        int submitMoves(const Move* moves, int count);
+
+        /*
+         * Loads a FEN string without any output, as loadPlayableState() does, and classifies the
+         * position for the side to move. Check, checkmate and stalemate are detected from the legal
+         * moves of the side to move, rather than by simulating the opponent finishing their turn.
+         * Used to classify positions in bulk (see classifyPositions()), where the FEN strings come
+         * from outside the engine, so a malformed or unplayable one is reported rather than loaded.
+         *
+         * @param fenString The FEN string describing the state of the chess game to load.
+         *
+         * @return A combination of PositionStateFlags describing the position for the side to move, or
+         *         positionInvalid (leaving the game unchanged) if the FEN string could not be loaded.
+         */
+        uint8_t classifyPosition(const char* fenString);
+
+        /*
+         * Classifies the current position for the side to move, as classifyPosition() does for a
+         * FEN string, evaluating the game state afresh whether or not it is current.
+         *
+         * @return A combination of PositionStateFlags describing the position for the side to move.
+         */
+        uint8_t classifyCurrentPosition();
+
+        /*
+         * Loads a FEN string as loadState() does, but without any output, for callers that load
+         * positions in bulk into the same game. Like every load, only the squares whose pieces
+         * differ from the current board are rebuilt. The game state is detected from the legal moves
+         * of the side to move, as classifyPosition() does, or left to be evaluated when it is first
+         * queried if lazy evaluation is enabled (see setLazyGameState()).
+         *
+         * @param fenString The FEN string describing the state of the chess game to load.
+         */
+        void resetState(const char* fenString);
 
         ChessPiece* chessBoard[ranks][files];
         
@@ -79,6 +148,318 @@ class ChessGame final {
         int* getEnPassantSquare();
         bool enPassantCapture = false;
 
+        /*
+         * Enables or silences the messages that the game writes to the console. Games hosted
+         * in bulk (e.g. by SessionManager) are silenced so that moves do not contend on stdout.
+         *
+         * @param enabled true to write messages to std::cout; false to discard them.
+         */
+        void setConsoleOutput(bool enabled);
+
+        /*
+         * Obtains the stream that game messages are written to (std::cout, or a discarding
+         * stream if console output has been silenced).
+         *
+         * @return A reference to the output stream for game messages.
+         */
+        std::ostream& console();
+
+        /*
+         * Getter function for the active colour.
+         *
+         * @return The colour of the player whose turn it is.
+         */
+        PieceColour getTurn() const;
+
+        /*
+         * Determines whether a game has been loaded and has not yet ended. Evaluates the game
+         * state first if it has not been evaluated since the last move.
+         *
+         * @return true if moves can currently be submitted; false otherwise.
+         */
+        bool isInProgress();
+
+        /*
+         * Determines whether a given colour is currently in check. Evaluates the game state first
+         * if it has not been evaluated since the last move.
+         *
+         * @param colour The colour of the king to query.
+         * 
+         * @return true if that colour's king is in check; false otherwise.
+         */
+        bool isInCheck(PieceColour colour);
+
+        /*
+         * Computes the Zobrist hash of the current position (piece placement, active colour,
+         * castling rights and en passant square). Move counters are not part of the hash.
+         *
+         * @return The 64-bit hash of the current position.
+         */
+        uint64_t positionHash() const;
+
+        /*
+         * Counts the occurrences of the last position of a game, for the threefold repetition rule.
+         * A position can only recur with the same side to move and no capture or pawn advance
+         * since, so only every other position back to the last such move is compared.
+         *
+         * @param hashes The positionHash() of every position of the game, the current one last.
+         * @param halfMoveCounter The half-move counter of the current position.
+         *
+         * @return The number of times the current position has occurred (at least 1).
+         */
+        static int countRepetitions(const std::vector<uint64_t>& hashes, int halfMoveCounter);
+
+        /*
+         * Obtains the Zobrist hash of the pawns alone, which identifies the pawn structure (e.g. to
+         * cache pawn-structure evaluations). Unlike positionHash(), it is not computed from scratch:
+         * it is kept up to date as pawns are placed, moved, captured and promoted.
+         *
+         * @return The XOR of the Zobrist keys of every pawn on the board (0 if there are none).
+         */
+        uint64_t pawnHash() const;
+
+        /*
+         * Obtains the squares of every piece of one colour and type.
+         *
+         * @param colour The colour of the pieces.
+         * @param type The type of the pieces.
+         *
+         * @return The set of squares occupied by those pieces.
+         */
+        SquareSet pieceSquares(PieceColour colour, PieceType type) const;
+
+        /*
+         * Generates every legal move for the active colour. A pawn move to the final rank is
+         * generated once for each piece it can promote to.
+         *
+         * @param moveList An array of at least maxLegalMoves moves to store the legal moves in.
+         *
+         * @return The number of legal moves stored.
+         */
+        int generateLegalMoves(Move* moveList);
+
+        /*
+         * Counts the leaf nodes of the tree of legal moves from the current position to a given
+         * depth (a "perft" count). Each move is made and taken back directly on the board, without
+         * validation or output. Used to verify and benchmark move generation.
+         *
+         * @param depth The number of plies to search (at least 1).
+         *
+         * @return The number of distinct sequences of legal moves of that length.
+         */
+        uint64_t perft(int depth);
+
+        /*
+         * The state needed to take back a move made by makeLegalMove().
+         */
+        struct MoveUndo {
+            Move move; // The move that was made
+            ChessPiece* movedPiece; // The piece that moved (the pawn, if it was promoted)
+            ChessPiece* capturedPiece; // The piece captured (nullptr if none), kept off the board until the move is taken back
+            int capturedSquare; // The index (rank * 8 + file) of the square the captured piece stood on
+            ChessPiece* promotedPiece; // The piece created by a promotion (nullptr if none)
+            bool castlingRights[4]; // The castling rights before the move (white kingside, white queenside, black kingside, black queenside)
+            int enPassantSquare[2]; // The en passant square before the move
+            int halfMoveCounter; // The half-move counter before the move
+            int fullMoveCounter; // The full-move counter before the move
+        };
+
+        /*
+         * Makes a legal move for the active colour directly on the board, without validation, output
+         * or game state detection, and switches the active colour. Used by searches, which take each
+         * move back with unmakeLegalMove().
+         *
+         * @param move The move to make (one of the moves returned by generateLegalMoves()).
+         * @param undo A reference to store the state needed to take the move back in.
+         */
+        void makeLegalMove(Move move, MoveUndo& undo);
+
+        /*
+         * Takes back the most recent move made by makeLegalMove(), restoring the previous position exactly.
+         *
+         * @param undo The state stored when the move was made.
+         */
+        void unmakeLegalMove(const MoveUndo& undo);
+
+        /*
+         * Determines whether the active colour is in check in the current position. Unlike isInCheck(),
+         * this tests the king's square directly, so it is also correct after makeLegalMove().
+         *
+         * @return true if the active colour's king is attacked; false otherwise.
+         */
+        bool activeColourInCheck();
+
+        /*
+         * Obtains every square attacked by a colour (whether empty, or occupied by either colour),
+         * computed for all pieces of each type at once with set-wise shifts rather than square by
+         * square. A square is in the set exactly when squareAttacked() would report it attacked.
+         *
+         * @param colour The colour of the attacking pieces.
+         *
+         * @return The set of attacked squares.
+         */
+        SquareSet attackedSquares(PieceColour colour) const;
+
+        /*
+         * Determines whether a single square is attacked by a colour, by walking outwards from the
+         * square to the nearest piece in each direction. To map the whole board, attackedSquares()
+         * is much faster than calling this for every square.
+         *
+         * @param square The index (rank * 8 + file) of the square.
+         * @param colour The colour of the attacking pieces.
+         *
+         * @return true if a piece of that colour attacks the square; false otherwise.
+         */
+        bool squareAttacked(int square, PieceColour colour);
+
+        /*
+         * Getter function for the half-move counter.
+         *
+         * @return The number of moves since the last capture or pawn advance.
+         */
+        int getHalfMoveCounter() const;
+
+        /*
+         * Sums the material of each side in centipawns (pawn 100, knight 320, bishop 330, rook 500,
+         * queen 900), using the piece lists rather than scanning the board.
+         *
+         * @return The material of the active colour less that of its opponent.
+         */
+        int materialBalance() const;
+
+        /*
+         * Takes a snapshot of the full state of the game (board, active colour, castling rights,
+         * en passant square, move counters and check/game-over status).
+         *
+         * @return The snapshot, which can be copied freely and shared between threads.
+         */
+        Position savePosition() const;
+
+        /*
+         * Restores the game to a snapshot taken by savePosition() (possibly from another game),
+         * without any output. Pieces already standing on the right squares are kept, so only
+         * the squares that differ from the snapshot are rebuilt.
+         *
+         * @param position The snapshot to restore.
+         */
+        void restorePosition(const Position& position);
+
+        /*
+         * Restores the game to a snapshot, as restorePosition() does, only if the position is
+         * playable: valid piece characters, one king and at most 16 pieces of each colour, no pawn
+         * on the first or last rank, castling rights only with the king and rook on their starting
+         * squares, an en passant square only behind a pawn that has just advanced two squares,
+         * and the side not to move not in check. The other ways of loading a position assume
+         * these hold (and exit on some positions where they do not), so positions from outside
+         * the engine, such as a client's FEN string parsed by parseFen(), are loaded this way.
+         *
+         * @param position The snapshot to restore.
+         *
+         * @return true if the position was restored; false (leaving the game unchanged) if it is not playable.
+         */
+        bool restorePlayablePosition(const Position& position);
+
+        /*
+         * Loads a FEN string read from outside the engine (a file or the command line) without any
+         * output, parsing it strictly with parseFen() and restoring it with restorePlayablePosition().
+         * Unlike loadState(), a malformed or unplayable FEN string is rejected rather than loaded.
+         * The game state is evaluated when it is first queried.
+         *
+         * @param fenString The FEN string describing the state of the chess game to load.
+         *
+         * @return true if the position was loaded; false (leaving the game unchanged) otherwise.
+         */
+        bool loadPlayableState(const char* fenString);
+
+        /*
+         * Packs the current position into the packed position format (see PackedPosition.h).
+         *
+         * @return The packed position.
+         */
+        PackedPosition savePackedPosition() const;
+
+        /*
+         * Loads a position in the packed position format without any output, as resetState()
+         * does for a FEN string: only the squares that differ from the current position are
+         * rebuilt, and the game state is evaluated at once (or when first queried, if it is
+         * evaluated lazily).
+         *
+         * @param packed The packed position.
+         *
+         * @return true if the position was loaded; false (leaving the game unchanged) if the packing
+         *         is malformed or its position is not playable (see restorePlayablePosition()).
+         */
+        bool loadPackedPosition(const PackedPosition& packed);
+
+        /*
+         * Sets the number of moves kept in the game's history for undoMoves() and redoMoves(),
+         * allocating the history once, here, and clearing it. Once it is full, each move made
+         * drops the oldest. No history is kept by default (a limit of zero).
+         *
+         * @param plies The greatest number of moves that can be taken back.
+         */
+        void setHistoryLimit(int plies);
+
+        /*
+         * Takes back the most recent moves made by submitMove(), newest first. Each move is
+         * reversed from the state recorded when it was made, in constant time and without
+         * validation, output or heap allocation, and the game state is restored as it was
+         * before the move. Moves taken back can be redone until another move is submitted or a
+         * position is loaded, either of which discards them. Moves made by makeLegalMove() are
+         * not recorded, so they must all have been taken back first.
+         *
+         * @param count The number of moves to take back.
+         *
+         * @return The number of moves taken back (fewer than count if the history holds fewer).
+         */
+        int undoMoves(int count);
+
+        /*
+         * Makes again the moves most recently taken back by undoMoves(), oldest first, in
+         * constant time each and without validation, output or heap allocation.
+         *
+         * @param count The number of moves to redo.
+         *
+         * @return The number of moves redone (fewer than count if fewer were taken back).
+         */
+        int redoMoves(int count);
+
+        /*
+         * Getter function for the number of moves in the history that can be taken back.
+         *
+         * @return The number of moves undoMoves() can take back.
+         */
+        int getUndoableMoves() const;
+
+        /*
+         * Getter function for the number of moves taken back that can be made again.
+         *
+         * @return The number of moves redoMoves() can redo.
+         */
+        int getRedoableMoves() const;
+
+        /*
+         * Attaches a move cache, which may be shared between games on different threads. While
+         * attached, submitMove() validates a move by looking it up in the cached legal moves of
+         * the current position, and takes the check/checkmate/stalemate state of the resulting
+         * position from the cache, computing and inserting positions that are not yet cached.
+         *
+         * @param cache The move cache to use (nullptr to validate every move from scratch).
+         */
+        void setMoveCache(MoveCache* cache);
+
+        /*
+         * Enables or disables lazy evaluation of the game state. While enabled, submitMove() only
+         * validates and makes moves, without output of check, checkmate or stalemate. The state is
+         * evaluated silently the first time it is queried after a move (by isInProgress() or
+         * isInCheck()) and kept until the next move. Only the 50-move rule is tested before each
+         * move, so a move submitted after checkmate or stalemate is rejected as illegal rather
+         * than because the game is over.
+         *
+         * @param enabled true to evaluate the game state on demand; false to evaluate it after every move.
+         */
+        void setLazyGameState(bool enabled);
+
         //void printBoard();
 
     private:
@@ -105,22 +486,72 @@ class ChessGame final {
         ChessPiece* blackKing; // A pointer to the black king
         ChessPiece* whiteKing; // A pointer to the white king
 
+        ChessPiece* pieceLists[2][maxPiecesPerColour]; // The pieces of each colour on the board (indexed by PieceColour), in no particular order
+        int pieceCounts[2] = {0, 0}; // The number of pieces in each colour's list
+        PiecePool piecePool; // The storage of every piece of the game (freed all at once by cleanChessBoard())
+        uint64_t pawnKey = 0; // The Zobrist hash of the pawns on the board (see pawnHash()), updated with the piece lists
+        // NB: Each piece stores its own index in its list, so that it can be removed in O(1).
+
         bool whiteCanCastleKingside; // Indicates kingside castling rights for white
         bool whiteCanCastleQueenside; // Indicates queenside castling rights for white
         bool blackCanCastleKingside; // Indicates kingside castling rights for black
         bool blackCanCastleQueenside; // Indicates queenside castling rights for black
+
+        std::ostream silentStream; // A stream without a buffer, used to discard messages when console output is silenced
+        std::ostream* output; // The stream that game messages are written to (std::cout by default)
+
+        MoveCache* moveCache = nullptr; // The shared cache of legal moves and game states (nullptr if not in use)
+        CachedPosition cachedPosition; // The cached legal moves and game state of the most recently looked up position
+        bool cachedPositionCurrent = false; // Indicates whether 'cachedPosition' describes the current position
+
+        bool lazyGameState = false; // Indicates that the game state is evaluated when queried rather than after every move
+        bool gameStateCurrent = true; // Indicates that endGame and the check flags describe the current position
+
+        /*
+         * The reversible change made by a move submitted with submitMove(), kept in the history.
+         * Each state the move changes is stored as it was before ([0]) and after ([1]) the move.
+         */
+        struct HistoryEntry {
+            Move move; // The move, with the promotion made (noPromotion if none)
+            char capturedPiece; // The FEN character of the piece captured ('\0' if none)
+            int8_t capturedSquare; // The index (rank * 8 + file) of the square the captured piece stood on
+            uint8_t castlingRights[2]; // The castling rights, as in Position::castlingRights
+            int8_t enPassantSquare[2]; // The index of the en passant square (-1 if none)
+            uint8_t statusFlags[2]; // The loaded, game over, check and stale flags, as in Position::statusFlags
+            uint16_t halfMoveCounter[2]; // The half-move counter
+            uint16_t fullMoveCounter[2]; // The full-move counter
+        };
+
+        std::vector<HistoryEntry> history; // A ring of the moves made and taken back (empty if no history is kept)
+        int historyStart = 0; // The index in 'history' of the oldest move
+        int undoableMoves = 0; // The number of moves from the oldest that have been made
+        int redoableMoves = 0; // The number of moves after those that have been taken back
+
         
 
         /************************** HELPER FUNCTIONS FOR loadState() **************************/
 
         /*
-		 * Iterates through chessBoard (2D array of ChessPiece*). Deletes any memory allocated on the heap and resets all
-         * elements to 'nullptr'.
+         * Replaces any previously loaded game by decoding each part of a FEN string into the state
+         * of a new game, without any output or game state detection. Pieces already standing on
+         * the right squares are kept (see decodePartOne()).
+         *
+         * @param fenString The FEN string describing the state of the chess game to load.
+         */
+        void decodeFenString(const char* fenString);
+
+
+        /*
+		 * Iterates through the piece lists of both colours, resetting the squares of chessBoard (2D array of
+         * ChessPiece*) that held them to 'nullptr', then frees every piece at once by resetting the piece pool.
 		 */
         void cleanChessBoard();
 
         /*
 		 * Decodes part 1 of a FEN string representing the arrangement of pieces on the chess board.
+         * Pieces of any previously loaded game that already stand on the right squares are kept, so
+         * only the squares that differ are rebuilt. If pieces captured by makeLegalMove() are still
+         * held off the board, the board is cleared first, so that their storage is reclaimed.
          *
          * @param fenString The FEN string describing the state of the chess game to load.
          * @param i A reference to the index of the current position being read in the FEN string.
@@ -174,8 +605,9 @@ class ChessGame final {
         void decodePartSix(const char* fenString, int& i);
 
         /*
-         * Creates a chess piece with the relevant attributes using heap memory and intialises a 
-         * pointer to that piece at a given position on the chess board.
+         * Creates a chess piece with the relevant attributes in the piece pool and intialises a 
+         * pointer to that piece at a given position on the chess board. Adds the piece to its
+         * colour's piece list.
          * 
 		 * @param abbrName A const reference to the character representing the chess piece in FEN string notation.
          * @param rank A const reference to the rank occupied by the piece.
@@ -186,14 +618,38 @@ class ChessGame final {
 
         /************************** HELPER FUNCTIONS FOR submitMove() **************************/
 
+        /*
+         * Performs the game logic shared by both forms of submitMove(), on the squares of the move
+         * by index. Letter-integer coordinates are converted to a Move once, by submitMove().
+         *
+         * @param move The move to make, whose promotion flag gives the piece that a pawn reaching the
+         *             final rank promotes to (noPromotion promotes to a queen).
+         * 
+         * @return true if the move was legal and has been made; false otherwise.
+         */
+        bool playMove(Move move);
+
+        /*
+         * Performs the game logic for a move, specialised on the active colour so that pawn directions,
+         * castling squares and the en passant and promotion ranks are compile-time constants.
+         * playMove() dispatches to the specialisation for the active colour once per move.
+         *
+         * @param move The move to make (see playMove()).
+         * 
+         * @return true if the move was legal and has been made; false otherwise.
+         */
+        template <PieceColour colour>
+        bool playMove(Move move);
+
         /*
          * Converts chess board coordinates from letter-integer format to zero-indexed integers.
          *
+         * The coordinates are written to an array supplied by the caller, so no memory is allocated.
+         *
          * @param stringCoord A string literal giving the chess coordinates (e.g. "A1") of a square on the chess board.
-         * 
-         * @return An integer array of length two containing zero-indexed coordinates of a piece on the chess board.
+         * @param indexArray An integer array of length two that receives the zero-indexed coordinates (rank, file) of the square.
          */
-        int* coordToIndex(const char* stringCoord);
+        void coordToIndex(const char* stringCoord, int* indexArray);
 
         /*
          * Obtains a pointer to a chess piece at a given position on the chess board.
@@ -207,23 +663,23 @@ class ChessGame final {
         /*
          * Determines whether a move is valid disregarding state of check.
          *
-         * Checks whether: 1) The coordinates are valid
-         *                 2) A piece exists at the origin square
-         *                 3) The piece belongs to the active colour
-         *                 4) The piece is being moved
-         *                 5) There is a friendly piece at the destination square
-         *                 6) The player is attempting to castle (indicated by moving the king two squares along a rank)
-         *                 7) The movement pattern is valid for the specified piece
-         *                 8) The path is clear (unless the piece is a knight)
+         * Checks whether: 1) A piece exists at the origin square
+         *                 2) The piece belongs to the active colour
+         *                 3) The piece is being moved
+         *                 4) There is a friendly piece at the destination square
+         *                 5) The player is attempting to castle (indicated by moving the king two squares along a rank)
+         *                 6) The movement pattern is valid for the specified piece
+         *                 7) The path is clear (unless the piece is a knight)
+         *
+         * The coordinates are in-bounds: those given as letters and integers are checked when they are
+         * converted (see checkCoordinatesValid()).
          *
          * @param originCoord An integer array of length two containing zero-indexed coordinates of the piece to move.
          * @param destinationCoord An integer array of length two containing zero-indexed coordinates of the destination square.
-         * @param stringCoord1 The string literal letter-integer coordinates (e.g. "A1") of the piece to move.
-         * @param stringCoord2 The string literal letter-integer coordinates (e.g. "B2") of the destination square.
          * 
          * @return true if the move is valid disregarding state of check; false otherwise.
          */
-        bool checkMoveValid(const int* originCoord, const int* destinationCoord, const char* stringCoord1, const char* stringCoord2);
+        bool checkMoveValid(const int* originCoord, const int* destinationCoord);
         
         /* HELPER FUNCTIONS FOR checkMoveValid() within submitMove() */
 
@@ -241,10 +697,10 @@ class ChessGame final {
          * Determines whether a piece exists at the origin square of a move.
          *
          * @param pieceAtOrigin A pointer to the chess piece occupying the origin square (nullptr if square is empty).
-         * @param stringCoord1 The string literal letter-integer coordinates (e.g. "A1") of the piece to move.
+         * @param originCoord An integer array of length two containing zero-indexed coordinates of the piece to move.
          * @return true if the square is occupied; false otherwise.
          */
-        bool checkPieceExists(ChessPiece* pieceAtOrigin, const char* stringCoord1);
+        bool checkPieceExists(ChessPiece* pieceAtOrigin, const int* originCoord);
 
         /*
          * Determines whether the piece being moved belongs to the active colour.
@@ -276,8 +732,8 @@ class ChessGame final {
         bool checkNoFriendlyCapture(ChessPiece* pieceAtDestination);
 
         /*
-         * Determines whether an attempt to castle is valid (identified by movement of the king 
-         * two squares along a file).
+         * Determines whether an attempt to castle by the active colour ('colour') is valid (identified 
+         * by movement of the king two squares along a file).
          *
          * @param castlingStatus A reference to the castling status of a move (in this case, either 
          * kingside or queenside).
@@ -286,6 +742,7 @@ class ChessGame final {
          * 
          * @return true if the attempt to castle is legal; false otherwise.
          */
+        template <PieceColour colour>
         bool checkCastlingValid(CastlingStatus& castlingStatus, const int* originCoord, const int* destinationCoord);
 
         /*
@@ -294,28 +751,28 @@ class ChessGame final {
          *
          * @param originCoord An integer array of length two containing zero-indexed coordinates of the piece to move.
          * @param destinationCoord An integer array of length two containing zero-indexed coordinates of the destination square.
-         * @param stringCoord2 The string literal letter-integer coordinates (e.g. "B2") of the destination square.
          * 
          * @return true if the path between the origin and destination square is clear; false otherwise.
          */
-        bool checkPathClear(const int* originCoord, const int* destinationCoord, const char* stringCoord2);
+        bool checkPathClear(const int* originCoord, const int* destinationCoord);
 
         /*
          * Outputs a generic move to the console stating that the attempted move
          * is not legal.
          * 
          * @param pieceType The type of piece that an attempt was made to move.
-         * @param stringCoord2 The string literal letter-integer coordinates (e.g. "B2") of the destination square.
+         * @param destinationCoord An integer array of length two containing zero-indexed coordinates of the destination square.
          */
-        void generalCannotMoveOutput(const PieceType pieceType, const char* stringCoord2);
+        void generalCannotMoveOutput(const PieceType pieceType, const int* destinationCoord);
 
         /*
-         * Performs a castling move.
+         * Performs a castling move by the active colour ('colour').
          *
          * @param originCoord An integer array of length two containing zero-indexed coordinates of the king to move.
          * @param destinationCoord An integer array of length two containing zero-indexed coordinates of the king's destination square.
          *
          */
+        template <PieceColour colour>
         void castle(const int* originCoord, const int* destinationCoord);
 
         /*
@@ -328,14 +785,15 @@ class ChessGame final {
         void makeMove(const int* originCoord, const int* destinationCoord);
 
         /*
-         * Considers whether the player is currently in check and whether they are moving into check, and determines
-         * whether a submitted move is legal in light of those considerations.
+         * Considers whether the player ('colour') is currently in check and whether they are moving into check, and 
+         * determines whether a submitted move is legal in light of those considerations.
          * 
          * @param originCoord An integer array of length two containing zero-indexed coordinates of the piece to move.
          * @param destinationCoord An integer array of length two containing zero-indexed coordinates of the destination square.
          * 
          * @return true if the move is legal; false otherwise.
          */
+        template <PieceColour colour>
         bool regularMoveLogic(const int* originCoord, const int* destinationCoord);
 
         /* 
@@ -352,23 +810,34 @@ class ChessGame final {
         bool detectCheck(const int &rank, const int &file, const PieceColour &colour, const bool lookingAtKing);
 
         /* 
-         * Detects whether an enemy knight is in range of a given square. 
+         * Detects whether a given square is attacked by any piece of the opposite colour to 'colour' 
+         * (the colour of the player under threat), without altering the check flags.
+         *
+         * @param rank A const reference to the rank of a given square on the chess board.
+         * @param file A const reference to the file of a given square on the chess board.
+         * 
+         * @return true if the square is attacked; false otherwise.
+         */
+        template <PieceColour colour>
+        bool isSquareAttacked(const int &rank, const int &file);
+
+        /* 
+         * Detects whether an enemy knight (of the opposite colour to 'colour') is in range of a given square. 
          *
          * @param rank A const reference to the rank of a given square on the chess board.
          * @param file A const reference to the file of a given square on the chess board.
-         * @param colour A const reference to the colour of the player under threat (opposite to the knight to detect).
          * 
          * @return true if a knight in range of the square is detected; false otherwise.
          */
-        bool detectKnightInRange(const int &rank, const int &file, const PieceColour &colour);
+        template <PieceColour colour>
+        bool detectKnightInRange(const int &rank, const int &file);
 
         /* 
          * Detects whether a nearest neighbour piece can 'see' a square (i.e. would it be able
-         * to capture an enemy piece at that square).
+         * to capture an enemy piece at that square), where 'colour' is the colour of the player under threat.
          *
          * @param rank A const reference to the rank of a given square on the chess board.
          * @param file A const reference to the file of a given square on the chess board.
-         * @param colour A const reference to the colour of the player under threat.
          * @param nearestNeighbour A pointer to the nearest neighbour chess piece relative to 
          * a square along a particular direction.
          * @param direction A const reference to the direction along which the nearest neighbour 
@@ -376,7 +845,8 @@ class ChessGame final {
          * 
          * @return true if the nearest neighbour 'sees' the square; false otherwise.
          */
-        bool doesPieceSeeSquare(const int &rank, const int &file, const PieceColour &colour, const ChessPiece* nearestNeighbour, const Directions &direction);
+        template <PieceColour colour>
+        bool doesPieceSeeSquare(const int &rank, const int &file, const ChessPiece* nearestNeighbour, const Directions &direction);
 
         /* 
          * Finds the nearest neighbouring chess piece relative to a given square in a given direction.
@@ -391,17 +861,20 @@ class ChessGame final {
         ChessPiece* findNearestNeighbour(const int &rank, const int &file, const Directions &direction);
 
         /*
-         * Detects if a king or rook has moved this turn and toggles the flags that 
-         * indicate the castling rights of each colour.
+         * Detects if a king or rook has moved (or a rook has been captured) this turn and toggles 
+         * the flags that indicate the castling rights of each colour.
          *
          * @param pieceAtOrigin A pointer to the chess piece occupying the origin square (nullptr if square is empty).
          * @param originCoord An integer array of length two containing zero-indexed coordinates of the piece to move.
+         * @param destinationCoord An integer array of length two containing zero-indexed coordinates of the destination square.
          */
-        void toggleCastlingFlags(const ChessPiece* pieceAtOrigin, const int* originCoord);
+        template <PieceColour colour>
+        void toggleCastlingFlags(const ChessPiece* pieceAtOrigin, const int* originCoord, const int* destinationCoord);
 
         /*
          * Outputs piece capture message, deallocates heap memory if relevant and
-         * ensures no dangling pointers remain after en passant. This function is only
+         * ensures no dangling pointers remain after en passant (the captured piece's
+         * square is known, so the board is not searched). This function is only
          * ever called when pieceToCapture points to an enemy chess piece.
          *
          * @param pieceToCapture A pointer to the chess piece to capture.
@@ -409,12 +882,36 @@ class ChessGame final {
         void doCapture(ChessPiece* pieceToCapture);
 
         /*
-         * Deallocates heap memory assigned to a piece.
+         * Replaces a pawn of the active colour ('colour') that has reached the final rank with the piece it promotes to.
+         *
+         * @param coord An integer array of length two containing zero-indexed coordinates of the pawn.
+         * @param promotion The piece that the pawn promotes to (noPromotion promotes to a queen).
+         */
+        template <PieceColour colour>
+        void promotePawn(const int* coord, Promotion promotion);
+
+        /*
+         * Removes a piece from its colour's piece list and returns its storage to the piece pool.
          *
-         * @param pieceToDelete A reference to the piece to be deleted from heap memory.
+         * @param pieceToDelete A reference to the piece to be deleted (set to 'nullptr').
          */
         void deletePiece(ChessPiece* &pieceToDelete);
 
+        /*
+         * Adds a piece to the end of its colour's piece list.
+         *
+         * @param piece The piece to add (which must not already be listed).
+         */
+        void addToPieceList(ChessPiece* piece);
+
+        /*
+         * Removes a piece from its colour's piece list in O(1), by moving the last piece in the
+         * list into its place.
+         *
+         * @param piece The piece to remove (which must be listed).
+         */
+        void removeFromPieceList(ChessPiece* piece);
+
         /*
          * Determines the current state of the chess game and detects any occurance of:
          * check, checkmate, stalemate or a draw (by the 50-move draw rule). Outputs an
@@ -423,52 +920,237 @@ class ChessGame final {
         void detectGameState();
 
         /*
-         * Detects whether a given king is in checkmate.
-         * 
-         * @param king The king for which to detect whether it is in checkmate.
-         * 
-         * @return true if the king is in checkmate; false otherwise.
+         * Determines the state of the chess game after a move by the active colour ('colour'), as
+         * detectGameState() does. detectGameState() dispatches to the specialisation for the active colour.
+         */
+        template <PieceColour colour>
+        void detectGameState();
+
+        /*
+         * Evaluates the game state of the current position without output, if it has not been
+         * evaluated since the last move (see setLazyGameState()).
          */
-        bool detectCheckmate(ChessPiece* king);
+        void updateGameState();
 
         /*
-         * Detects whether there are any safe squares that a king (in a state of check) can move to.
+         * Evaluates check, checkmate, stalemate and the 50-move rule for the side to move from its
+         * legal moves, without output, setting endGame and the check flags.
          *
-         * @param king The king for which to detect whether there are any safe squares for it to move to.
-         * 
-         * @return true if there exists at least one safe square for the king to move to; false otherwise.
+         * @return A combination of PositionStateFlags describing the position for the side to move.
+         */
+        uint8_t computeGameState();
+
+        /*
+         * Switches the active colour between white and black.
          */
-        bool anySafeSquares(ChessPiece* king);
+        void switchTurn();
+
+
+        /************************** HELPER FUNCTIONS FOR generateLegalMoves() **************************/
 
         /*
-         * Detects whether there exists any piece that can block a check on its king.
+         * Generates every legal move for the active colour ('colour'). generateLegalMoves() dispatches
+         * to the specialisation for the active colour.
          *
-         * @param king The king for which to detect whether any piece can block a check.
-         * 
-         * @return true if there exists a piece that can block check; false otherwise.
+         * @param moveList An array of at least maxLegalMoves moves to store the legal moves in.
+         *
+         * @return The number of legal moves stored.
          */
-        bool pieceCanBlock(ChessPiece* king);
+        template <PieceColour colour>
+        int generateLegalMoves(Move* moveList);
 
         /*
-         * Attempts every possible move for a given piece to determine if that piece can block a check on its king.
+         * Determines whether the active colour has at least one legal move, generating the moves
+         * of one piece at a time and stopping at the first piece that has any.
          *
-         * @param piece The piece to attempt every move to determine whether it can block check.
+         * @return true if the active colour has a legal move; false otherwise.
+         */
+        bool anyLegalMoves();
+        template <PieceColour colour>
+        bool anyLegalMoves();
+
+        /*
+         * Adds the legal moves of a single piece belonging to the active colour ('colour') to a list
+         * of moves. Castling moves are added separately by addCastlingMoves().
+         *
+         * @param moveList The list of moves to add to.
+         * @param count A reference to the number of moves in the list.
+         * @param piece The piece whose moves to add.
+         */
+        template <PieceColour colour>
+        void addPieceMoves(Move* moveList, int& count, const ChessPiece* piece);
+
+        /*
+         * Adds a pawn move to a list of moves (if legal), adding one move per promotion if the 
+         * destination is on the final rank.
+         *
+         * @param moveList The list of moves to add to.
+         * @param count A reference to the number of moves in the list.
+         * @param origin The index (rank * 8 + file) of the square occupied by the pawn.
+         * @param destination The index (rank * 8 + file) of the destination square.
+         */
+        template <PieceColour colour>
+        void addPawnMove(Move* moveList, int& count, int origin, int destination);
+
+        /*
+         * Adds a move to a list of moves if it does not leave the active colour's king in check.
+         * The move is trialled directly on the chess board and undone, without any output.
+         *
+         * @param moveList The list of moves to add to.
+         * @param count A reference to the number of moves in the list.
+         * @param move The move (geometrically valid, with a clear path) to test.
+         */
+        template <PieceColour colour>
+        void addLegalMove(Move* moveList, int& count, Move move);
+
+        /*
+         * Adds the castling moves available to the active colour to a list of moves.
+         *
+         * @param moveList The list of moves to add to.
+         * @param count A reference to the number of moves in the list.
+         */
+        template <PieceColour colour>
+        void addCastlingMoves(Move* moveList, int& count);
+
+        /*
+         * Counts the leaf nodes of the tree of legal moves to a given depth with 'colour' to move.
+         * perft() dispatches to the specialisation for the active colour.
+         *
+         * @param depth The number of plies to search (at least 1).
+         *
+         * @return The number of distinct sequences of legal moves of that length.
+         */
+        template <PieceColour colour>
+        uint64_t perft(int depth);
+
+        /*
+         * Makes a legal move for the active colour ('colour') directly on the board, without validation or
+         * output, and switches the active colour. The move must be taken back by unmakeLegalMove().
+         *
+         * @param move The move to make (one of the moves returned by generateLegalMoves()).
+         * @param undo A reference to store the state needed to take the move back in.
+         */
+        template <PieceColour colour>
+        void makeLegalMove(Move move, MoveUndo& undo);
+
+        /*
+         * Takes back the most recent move made by makeLegalMove() for 'colour', restoring the previous position exactly.
+         *
+         * @param undo The state stored when the move was made.
+         */
+        template <PieceColour colour>
+        void unmakeLegalMove(const MoveUndo& undo);
+
+
+        /************************** HELPER FUNCTIONS FOR THE MOVE CACHE **************************/
+
+        /*
+         * Determines whether a move is legal by looking it up in the cached legal moves of the current 
+         * position. Sets 'castlingStatus' and 'enPassantCapture' as checkMoveValid() does.
+         *
+         * @param originCoord An integer array of length two containing zero-indexed coordinates of the piece to move.
+         * @param destinationCoord An integer array of length two containing zero-indexed coordinates of the destination square.
+         * @param promotion The piece that a pawn reaching the final rank promotes to (noPromotion promotes to a queen).
          * 
-         * @return true if a given piece can block check; false otherwise.
+         * @return true if the move is legal; false otherwise.
          */
-        bool attemptBlockCheck(ChessPiece* piece);
+        bool checkMoveCached(const int* originCoord, const int* destinationCoord, Promotion promotion);
 
         /*
-         * Determines whether the colour next to move has any legal moves.
+         * Loads a position into 'cachedPosition' from the move cache, computing it and inserting it
+         * into the cache if it is not found.
          *
-         * @return true if there exists a piece with a legal move; false otherwise.
+         * @param hash The Zobrist hash of the current position.
          */
-        bool anyPiecesCanMove();
+        void lookupCachedPosition(uint64_t hash);
 
         /*
-         * Switches the active colour between white and black.
+         * Computes the legal moves and game state of the current position for the active colour.
+         *
+         * @param position A reference to store the legal moves and game state in.
+         * @param hash The Zobrist hash of the current position.
          */
-        void switchTurn();
+        void computePositionState(CachedPosition& position, uint64_t hash);
+
+        /*
+         * Sets the check flags and detects checkmate, stalemate or a draw after a move from the
+         * cached game state of the resulting position, in place of detectGameState().
+         */
+        void applyCachedGameState();
+
+
+        /************************** HELPER FUNCTIONS FOR SNAPSHOTS AND THE HISTORY **************************/
+
+        /*
+         * Packs the castling rights, as in Position::castlingRights.
+         *
+         * @return Bit 0: white kingside, bit 1: white queenside, bit 2: black kingside, bit 3: black queenside.
+         */
+        uint8_t packCastlingRights() const;
+
+        /*
+         * Sets the castling rights from their packed form (see packCastlingRights()).
+         *
+         * @param castlingRights The packed castling rights.
+         */
+        void unpackCastlingRights(uint8_t castlingRights);
+
+        /*
+         * Packs the loaded, game over, check and stale flags, as in Position::statusFlags.
+         *
+         * @return A combination of PositionStatusFlags.
+         */
+        uint8_t packStatusFlags() const;
+
+        /*
+         * Sets the loaded, game over, check and stale flags from their packed form (see packStatusFlags()).
+         *
+         * @param statusFlags A combination of PositionStatusFlags.
+         */
+        void unpackStatusFlags(uint8_t statusFlags);
+
+        /*
+         * Stores the state that a move changes in a history entry.
+         *
+         * @param entry The history entry.
+         * @param after 0 to store the state before the move; 1 to store the state after it.
+         */
+        void saveHistoryState(HistoryEntry& entry, int after) const;
+
+        /*
+         * Restores the state that a move changes from a history entry.
+         *
+         * @param entry The history entry.
+         * @param after 0 to restore the state before the move; 1 to restore the state after it.
+         */
+        void restoreHistoryState(const HistoryEntry& entry, int after);
+
+        /*
+         * Adds a move just made to the history, discarding any moves taken back (which can no
+         * longer be redone) and, if the history is full, the oldest move.
+         *
+         * @param entry The history entry of the move.
+         */
+        void recordHistory(const HistoryEntry& entry);
+
+        /*
+         * Clears the history, as when a position is loaded.
+         */
+        void clearHistory();
+
+        /*
+         * Takes back the move of a history entry, which must be the last move made.
+         *
+         * @param entry The history entry of the move.
+         */
+        void undoHistoryEntry(const HistoryEntry& entry);
+
+        /*
+         * Makes again the move of a history entry, which must be the first move taken back.
+         *
+         * @param entry The history entry of the move.
+         */
+        void redoHistoryEntry(const HistoryEntry& entry);
 };
 
 #endif
\ No newline at end of file
@@ -13,7 +13,6 @@
 #include "ChessGame.h"
 #include <iostream>
 #include <cmath>
-#include <vector>
 
 using namespace std;
 
@@ -22,7 +21,7 @@ using namespace std;
 
 /* CONSTRUCTOR */
 ChessPiece::ChessPiece(PieceColour colour, PieceType type, int rank, int file, ChessGame& chessGame) 
-: colour(colour), type(type), rankIndex(rank), fileIndex(file), chessGame(chessGame) {}
+: abbrName(pieceAbbrName(colour, type)), colour(colour), type(type), rankIndex(rank), fileIndex(file), chessGame(chessGame) {}
 
 /* VIRTUAL DEFAULT DESTRUCTOR */
 ChessPiece::~ChessPiece() {}
@@ -57,9 +56,9 @@ std::ostream &operator<<(std::ostream& os, ChessPiece* chessPiece) {
 }
 
 /* DETERMINES IF A MOVE IS GEOMETRICALLY VALID BY CALLING isValidMovementPattern FOR A GIVEN CHESS PIECE */
-bool ChessPiece::checkMovementPattern(const int* originCoord, const int* destinationCoord, const char* stringCoord2) const {
+bool ChessPiece::checkMovementPattern(const int* originCoord, const int* destinationCoord) const {
     if (!isValidMovePattern(originCoord, destinationCoord)) {
-        cout << colour << "'s " << type << " cannot move to " << stringCoord2 << "!\n";
+        chessGame.console() << colour << "'s " << type << " cannot move to " << SquareName(destinationCoord) << "!\n";
         return false;
     }
     return true;
@@ -91,8 +90,24 @@ int ChessPiece::getFileIndex() const {
 }
 
 /* GETTER FOR 'unitMoves' */
-std::vector<std::vector<int>> ChessPiece::getUnitMoves() const {
-    return unitMoves;
+const UnitMoves& ChessPiece::getUnitMoves() const {
+    return *unitMoves;
+}
+
+/* GETTER FOR 'listIndex' */
+int ChessPiece::getListIndex() const {
+    return listIndex;
+}
+
+/* SETTER FOR 'rank' AND 'file' */
+void ChessPiece::setPosition(int rank, int file) {
+    rankIndex = rank;
+    fileIndex = file;
+}
+
+/* SETTER FOR 'listIndex' */
+void ChessPiece::setListIndex(int index) {
+    listIndex = index;
 }
 
 
@@ -100,12 +115,7 @@ std::vector<std::vector<int>> ChessPiece::getUnitMoves() const {
 
 /* CONSTRUCTOR */
 Pawn::Pawn(PieceColour c, int rank, int file, ChessGame& chessGame) : ChessPiece(c, pawn, rank, file, chessGame) {
-    if (c == white) { // Pawn capture logic is dealt with further in ChessGame class
-        unitMoves = {{1, 0}, {1, 1}, {1, -1}};
-    }
-    else {
-        unitMoves = {{-1, 0}, {-1, 1}, {-1, -1}};
-    }
+    unitMoves = &pawnUnitMoves[c]; // Pawn capture logic is dealt with further in ChessGame class
 }
 
 /* DETERMINES IF A MOVE IS GEOMETRICALLY VALID FOR A PAWN */
@@ -118,7 +128,7 @@ bool Pawn::isValidMovePattern(const int* coords1, const int* coords2) const {
 
     int advance = newRank - oldRank;
 
-    if (oldFile == newFile) { // Move without capture
+    if (oldFile == newFile && chessGame.chessBoard[newRank][newFile] == nullptr) { // Move without capture, so only onto an empty square
         if (colour == white && (advance == 1 || (oldRank == 1 && advance == 2))) {
             return true;
         }
@@ -134,7 +144,8 @@ bool Pawn::isValidMovePattern(const int* coords1, const int* coords2) const {
         if ((colour == black) && (advance == -1) && (chessGame.chessBoard[newRank][newFile] != nullptr)) {
             return true;
         }
-        if (chessGame.getEnPassantSquare()[0] != -1 && newRank == chessGame.getEnPassantSquare()[0] && newFile == chessGame.getEnPassantSquare()[1]) {
+        if (advance == (colour == white ? 1 : -1) && chessGame.getEnPassantSquare()[0] != -1 &&
+            newRank == chessGame.getEnPassantSquare()[0] && newFile == chessGame.getEnPassantSquare()[1]) {
             chessGame.enPassantCapture = true;
             return true;
         }
@@ -148,7 +159,7 @@ bool Pawn::isValidMovePattern(const int* coords1, const int* coords2) const {
 
 /* CONSTRUCTOR */
 Rook::Rook(PieceColour c, int rank, int file, ChessGame& chessGame) : ChessPiece(c, rook, rank, file, chessGame) {
-    unitMoves = {{1,0}, {-1,0}, {0,1}, {0,-1}};
+    unitMoves = &rookUnitMoves;
 }
 
 /* DETERMINES IF A MOVE IS GEOMETRICALLY VALID FOR A ROOK */
@@ -165,19 +176,13 @@ bool Rook::isValidMovePattern(const int* coord1, const int* coord2) const {
 
 /* CONSTRUCTOR */
 Knight::Knight(PieceColour c, int rank, int file, ChessGame& chessGame) : ChessPiece(c, knight, rank, file, chessGame) {
-    unitMoves = {{1, 2}, {-1, 2}, {1, -2}, {-1, -2}, {2, 1}, {-2, 1}, {2, -1}, {-2, -1}};
+    unitMoves = &knightUnitMoves;
 }
 
 /* DETERMINES IF A MOVE IS GEOMETRICALLY VALID FOR A KNIGHT */
 bool Knight::isValidMovePattern(const int* coord1, const int* coord2) const {
 
-    if ((abs(coord2[1] - coord1[1]) == 1) && (abs(coord2[0] - coord1[0]) == 2)) {
-        return true;
-    }
-    if ((abs(coord2[1] - coord1[1]) == 2) && (abs(coord2[0] - coord1[0]) == 1)) {
-        return true;
-    }
-    return false;        
+    return containsSquare(attackTables.knightAttacks[coord1[0] * 8 + coord1[1]], coord2[0] * 8 + coord2[1]);
 }
 
 
@@ -185,7 +190,7 @@ bool Knight::isValidMovePattern(const int* coord1, const int* coord2) const {
 
 /* CONSTRUCTOR */
 Bishop::Bishop(PieceColour c, int rank, int file, ChessGame& chessGame) : ChessPiece(c, bishop, rank, file, chessGame) {
-    unitMoves = {{1,1}, {-1,-1}, {1,-1}, {-1,1}};
+    unitMoves = &bishopUnitMoves;
 }
 
 /* DETERMINES IF A MOVE IS GEOMETRICALLY VALID FOR A BISHOP */
@@ -202,7 +207,7 @@ bool Bishop::isValidMovePattern(const int* coord1, const int* coord2) const {
 
 /* CONSTRUCTOR */
 Queen::Queen(PieceColour c, int rank, int file, ChessGame& chessGame) : ChessPiece(c, queen, rank, file, chessGame) {
-    unitMoves = {{1,0}, {-1,0}, {0,1}, {0,-1}, {1,1}, {-1,-1}, {1,-1}, {-1,1}};
+    unitMoves = &queenUnitMoves;
 }
 
 /* DETERMINES IF A MOVE IS GEOMETRICALLY VALID FOR A QUEEN */
@@ -223,14 +228,11 @@ bool Queen::isValidMovePattern(const int* coord1, const int* coord2) const {
 
 /* CONSTRUCTOR */
 King::King(PieceColour c, int rank, int file, ChessGame& chessGame) : ChessPiece(c, king, rank, file, chessGame) {
-    unitMoves = {{1,0}, {-1,0}, {0,1}, {0,-1}, {1,1}, {-1,-1}, {1,-1}, {-1,1}};
+    unitMoves = &kingUnitMoves;
 }
 
 /* DETERMINES IF A MOVE IS GEOMETRICALLY VALID FOR A KING */
 bool King::isValidMovePattern(const int* coord1, const int* coord2) const {
 
-    if ((abs(coord2[0] - coord1[0]) < 2) && (abs(coord2[1] - coord1[1]) < 2)) {
-        return true;
-    }
-    return false;
+    return containsSquare(attackTables.kingAttacks[coord1[0] * 8 + coord1[1]], coord2[0] * 8 + coord2[1]);
 }
\ No newline at end of file
@@ -12,8 +12,8 @@
 #ifndef CHESSPIECE_H
 #define CHESSPIECE_H
 
+#include "AttackTables.h"
 #include "Enums.h"
-#include <vector>
 
 class ChessGame; // Forward declaration to prevent circular dependency
 
@@ -60,11 +60,10 @@ class ChessPiece {
          *
          * @param originCoord The coordinates of the initial square occupied by the piece (zero indexed).
          * @param destinationCoord The coordinates of the destination square (zero indexed).
-         * @param stringCoord2 The string literal coordinate of the destination square (e.g. "A1") .
          * 
          * @return 'true' if the move is geometrically valid, otherwise 'false'. 
          */
-        bool checkMovementPattern(const int* originCoord, const int* destinationCoord, const char* stringCoord2) const;
+        bool checkMovementPattern(const int* originCoord, const int* destinationCoord) const;
 
         /* 
          * Pure virtual function to determine if a move is geometrically valid. Overriden by
@@ -118,9 +117,35 @@ class ChessPiece {
          * Getter function for 'unitMoves' attribute in ChessPiece class.
          * 
          * @return The set of unit moves (the complete set of shortest legal moves 
-         * in a given direction).
+         * in a given direction), held in a compile-time table shared by every piece of this type.
          */
-        std::vector<std::vector<int>> getUnitMoves() const;
+        const UnitMoves& getUnitMoves() const;
+
+        /* 
+         * Getter function for 'listIndex' attribute in ChessPiece class.
+         * 
+         * @return The index of the piece in its colour's piece list in ChessGame.
+         */
+        int getListIndex() const;
+
+        /* SETTER FUNCTIONS: */
+
+        /*
+         * Setter function for the 'rank' and 'file' attributes in ChessPiece class, called
+         * whenever the piece is moved on the chess board.
+         *
+         * @param rank The index of the rank now occupied by the chess piece.
+         * @param file The index of the file now occupied by the chess piece.
+         */
+        void setPosition(int rank, int file);
+
+        /*
+         * Setter function for the 'listIndex' attribute in ChessPiece class, called whenever
+         * the piece is added to (or moved within) its colour's piece list in ChessGame.
+         *
+         * @param index The index of the piece in its colour's piece list.
+         */
+        void setListIndex(int index);
 
     protected:
         /* ATTRIBUTES: */
@@ -130,11 +155,12 @@ class ChessPiece {
         PieceColour colour; // The colour of the chess piece (white or black)
         PieceType type; // The type of the chess piece (pawn, rook, bishop, knight, king or queen)
 
-        std::vector<std::vector<int>> unitMoves; // The complete set of shortest legal moves in a given direction).
+        const UnitMoves* unitMoves; // The complete set of shortest legal moves in a given direction (see AttackTables.h).
         // NB: For knight, pawn and king this is the set of all legal moves.
 
         int rankIndex; // The index of the rank occupied by a chess piece (zero indexed).
         int fileIndex; // The index of the file occupied by a chess piece (zero indexed).
+        int listIndex = -1; // The index of the piece in its colour's piece list in ChessGame (-1 if not listed).
 
         ChessGame& chessGame; // A reference to the chess game that the piece belongs to.
 };
@@ -0,0 +1,25 @@
+/*
+ * ColourTraits.h - Header file for the compile-time properties of each colour, used by the
+ * routines of ChessGame that are specialised on the active colour.
+ */
+
+#ifndef COLOURTRAITS_H
+#define COLOURTRAITS_H
+
+#include "Enums.h"
+
+/*
+ * The ranks and directions that depend on a colour. Code templated on the colour reads
+ * these as constants instead of branching on the active colour at run time.
+ */
+template <PieceColour colour>
+struct ColourTraits {
+    static constexpr PieceColour opponent = (colour == white ? black : white); // The other colour
+    static constexpr int forward = (colour == white ? 1 : -1); // The rank direction in which pawns advance
+    static constexpr int homeRank = (colour == white ? 0 : 7); // The rank the king and rooks start on
+    static constexpr int pawnStartRank = (colour == white ? 1 : 6); // The rank from which pawns may advance two squares
+    static constexpr int promotionRank = (colour == white ? 7 : 0); // The rank on which pawns promote
+    static constexpr int enPassantRank = (colour == white ? 4 : 3); // The rank from which pawns capture en passant
+};
+
+#endif
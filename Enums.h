@@ -22,6 +22,39 @@ enum PieceColour {white, black};
  */
 enum PieceType {pawn, rook, knight, bishop, queen, king};
 
+/*
+ * The FEN characters of white's pieces, indexed by PieceType (black's are the same in lower case).
+ */
+inline constexpr char pieceAbbrNames[] = "PRNBQK";
+
+/*
+ * Obtains the FEN character of a piece.
+ *
+ * @param colour The colour of the piece.
+ * @param type The type of the piece.
+ *
+ * @return The character, upper case for white and lower case for black.
+ */
+constexpr char pieceAbbrName(PieceColour colour, PieceType type) {
+    return (colour == white ? pieceAbbrNames[type] : static_cast<char>(pieceAbbrNames[type] | 0x20));
+}
+
+/*
+ * Finds the type of piece a FEN character stands for, in either case.
+ *
+ * @param abbrName The character.
+ *
+ * @return The PieceType, or -1 if the character is not a piece.
+ */
+constexpr int pieceTypeOf(char abbrName) {
+    for (int type = pawn; type <= king; type++) {
+        if (abbrName == pieceAbbrNames[type] || abbrName == (pieceAbbrNames[type] | 0x20)) {
+            return type;
+        }
+    }
+    return -1;
+}
+
 /* 
  * Enum representing the castling status of a move.
  */
@@ -0,0 +1,64 @@
+/*
+ * Executor.cpp - Implementation file for the Executor class, a fixed pool of
+ * worker threads that runs queued tasks.
+ */
+
+#include "Executor.h"
+
+using namespace std;
+
+
+/****************************** Executor - Member Function Definitions ******************************/
+
+/* CONSTRUCTOR - STARTS THE WORKER THREADS */
+Executor::Executor(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = max(thread::hardware_concurrency(), 1u);
+    }
+    for (unsigned index = 0; index < threadCount; index++) {
+        workers.emplace_back(&Executor::runWorker, this);
+    }
+}
+
+/* DESTRUCTOR - DRAINS THE QUEUE AND STOPS THE WORKER THREADS */
+Executor::~Executor() {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/* QUEUES A TASK AND WAKES A WORKER */
+void Executor::submit(function<void()> task) {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        tasks.push_back(move(task));
+    }
+    queueReady.notify_one();
+}
+
+/* GETTER FOR THE NUMBER OF WORKER THREADS */
+unsigned Executor::getThreadCount() const {
+    return workers.size();
+}
+
+/* WORKER LOOP - RUNS TASKS IN SUBMISSION ORDER */
+void Executor::runWorker() {
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            queueReady.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty()) { // Stopping and fully drained
+                break;
+            }
+            task = move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * Executor.h - Header file for the Executor class, a fixed pool of worker threads
+ * that runs queued tasks. Long-running work (such as analyses) shares one executor
+ * by splitting itself into short tasks, so pending work never holds a thread.
+ */
+
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/****************************** Class Executor ******************************/
+
+class Executor final {
+
+    public:
+        /*
+         * Parameterised constructor which starts a fixed number of worker threads.
+         *
+         * @param threadCount The number of worker threads. Zero selects one per hardware thread.
+         */
+        explicit Executor(unsigned threadCount = 0);
+
+        /*
+         * Destructor runs every queued task (including any that they queue in turn) and then
+         * stops the worker threads.
+         */
+        ~Executor();
+
+        Executor(const Executor&) = delete;
+        Executor& operator=(const Executor&) = delete;
+
+        /*
+         * Queues a task to run on the next free worker thread. Tasks are started in the order
+         * they were queued. May be called from within a task.
+         *
+         * @param task The task to run.
+         */
+        void submit(std::function<void()> task);
+
+        /*
+         * Getter function for the number of worker threads.
+         *
+         * @return The number of worker threads.
+         */
+        unsigned getThreadCount() const;
+
+    private:
+        std::vector<std::thread> workers; // The worker threads
+        std::mutex queueMutex; // Guards 'tasks' and 'stopping'
+        std::condition_variable queueReady; // Signalled when a task is queued or the executor is stopping
+        std::deque<std::function<void()>> tasks; // Tasks waiting to run, in submission order
+        bool stopping = false; // Indicates that the workers should exit once the queue is empty
+
+        /*
+         * Runs queued tasks until the executor is stopped and its queue has been drained.
+         */
+        void runWorker();
+};
+
+#endif
@@ -0,0 +1,185 @@
+/*
+ * GameRecord.cpp - Implementation file for the classes that stream games
+ * to and from the binary game record format.
+ */
+
+#include "GameRecord.h"
+#include <cstring>
+
+using namespace std;
+
+static const char recordMagic[3] = {'C', 'G', 'R'};
+static const char recordVersion = 1;
+static const char seededRecordVersion = 2; // A version 1 header followed by the game's seed
+
+/* WRITES A 16-BIT INTEGER IN LITTLE-ENDIAN ORDER */
+static void writeUint16(ostream& stream, uint16_t value) {
+    char bytes[2] = {static_cast<char>(value & 0xFF), static_cast<char>(value >> 8)};
+    stream.write(bytes, 2);
+}
+
+/* READS A 16-BIT INTEGER IN LITTLE-ENDIAN ORDER */
+static bool readUint16(istream& stream, uint16_t& value) {
+    unsigned char bytes[2];
+    if (!stream.read(reinterpret_cast<char*>(bytes), 2)) {
+        return false;
+    }
+    value = static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+    return true;
+}
+
+/* WRITES A 64-BIT INTEGER IN LITTLE-ENDIAN ORDER */
+static void writeUint64(ostream& stream, uint64_t value) {
+    char bytes[8];
+    for (int index = 0; index < 8; index++) {
+        bytes[index] = static_cast<char>(value >> (8 * index));
+    }
+    stream.write(bytes, 8);
+}
+
+/* READS A 64-BIT INTEGER IN LITTLE-ENDIAN ORDER */
+static bool readUint64(istream& stream, uint64_t& value) {
+    unsigned char bytes[8];
+    if (!stream.read(reinterpret_cast<char*>(bytes), 8)) {
+        return false;
+    }
+    value = 0;
+    for (int index = 0; index < 8; index++) {
+        value |= static_cast<uint64_t>(bytes[index]) << (8 * index);
+    }
+    return true;
+}
+
+
+/****************************** GameRecordWriter - Member Function Definitions ******************************/
+
+/* CONSTRUCTOR */
+GameRecordWriter::GameRecordWriter(ostream& stream) : stream(stream) {}
+
+/* WRITES THE HEADER OF A NEW GAME */
+void GameRecordWriter::beginGame(const char* startFen) {
+    uint16_t fenLength = static_cast<uint16_t>(strlen(startFen));
+
+    stream.write(recordMagic, 3);
+    stream.put(recordVersion);
+    writeUint16(stream, fenLength);
+    stream.write(startFen, fenLength);
+}
+
+/* WRITES THE HEADER OF A NEW GAME, WITH THE SEED IT WAS GENERATED FROM */
+void GameRecordWriter::beginGame(const char* startFen, uint64_t seed) {
+    uint16_t fenLength = static_cast<uint16_t>(strlen(startFen));
+
+    stream.write(recordMagic, 3);
+    stream.put(seededRecordVersion);
+    writeUint16(stream, fenLength);
+    stream.write(startFen, fenLength);
+    writeUint64(stream, seed);
+}
+
+/* APPENDS A MOVE TO THE CURRENT GAME */
+void GameRecordWriter::addMove(Move move) {
+    writeUint16(stream, move.getRaw());
+}
+
+/* TERMINATES THE CURRENT GAME WITH THE NULL MOVE AND ITS RESULT */
+void GameRecordWriter::endGame(GameResult result) {
+    writeUint16(stream, Move().getRaw());
+    stream.put(static_cast<char>(result));
+}
+
+
+/****************************** GameRecordReader - Member Function Definitions ******************************/
+
+/* CONSTRUCTOR */
+GameRecordReader::GameRecordReader(istream& stream) : stream(stream), result(unknownResult), seeded(false), seed(0), skippedGames(0) {}
+
+/* READS THE HEADER OF THE NEXT GAME */
+bool GameRecordReader::beginGame() {
+    char header[4];
+    uint16_t fenLength;
+
+    if (!stream.read(header, 4) || memcmp(header, recordMagic, 3) != 0 ||
+        (header[3] != recordVersion && header[3] != seededRecordVersion)) {
+        return false;
+    }
+    if (!readUint16(stream, fenLength)) {
+        return false;
+    }
+
+    startFen.resize(fenLength);
+    if (!stream.read(&startFen[0], fenLength)) {
+        return false;
+    }
+    seeded = (header[3] == seededRecordVersion);
+    seed = 0;
+    if (seeded && !readUint64(stream, seed)) {
+        return false;
+    }
+    result = unknownResult;
+    return true;
+}
+
+/* READS THE NEXT MOVE OF THE CURRENT GAME */
+bool GameRecordReader::nextMove(Move& move) {
+    uint16_t raw;
+    if (!readUint16(stream, raw)) {
+        return false;
+    }
+
+    move = Move::fromRaw(raw);
+    if (move.isNull()) { // End of game - the result follows the terminator
+        int resultByte = stream.get();
+        result = (resultByte == char_traits<char>::eof() ? unknownResult : static_cast<GameResult>(resultByte));
+        return false;
+    }
+    return true;
+}
+
+/* STREAMS THE NEXT GAME DIRECTLY INTO A CHESS GAME */
+bool GameRecordReader::replayGame(ChessGame& game) {
+    Move move;
+    while (true) {
+        if (!beginGame()) {
+            return false;
+        }
+        if (game.loadPlayableState(startFen.c_str())) {
+            break;
+        }
+        while (nextMove(move)) {} // Skip the moves of a game that cannot be replayed
+        skippedGames++;
+    }
+
+    bool allLegal = true;
+    while (nextMove(move)) {
+        if (!game.submitMove(move)) {
+            allLegal = false;
+        }
+    }
+    return allLegal;
+}
+
+/* GETTER FOR THE STARTING FEN STRING OF THE CURRENT GAME */
+const string& GameRecordReader::getStartFen() const {
+    return startFen;
+}
+
+/* GETTER FOR THE RESULT OF THE CURRENT GAME */
+GameResult GameRecordReader::getResult() const {
+    return result;
+}
+
+/* DETERMINES WHETHER THE CURRENT GAME RECORDS A SEED */
+bool GameRecordReader::hasSeed() const {
+    return seeded;
+}
+
+/* GETTER FOR THE SEED OF THE CURRENT GAME */
+uint64_t GameRecordReader::getSeed() const {
+    return seed;
+}
+
+/* GETTER FOR THE NUMBER OF GAMES SKIPPED BY replayGame() */
+uint64_t GameRecordReader::getSkippedGames() const {
+    return skippedGames;
+}
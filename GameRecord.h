@@ -0,0 +1,165 @@
+/*
+ * GameRecord.h - Header file for the binary game record format and the
+ * classes that stream games to and from it.
+ *
+ * A record file is a sequence of games, each laid out as:
+ *
+ *     "CGR" magic, 1-byte version (1, or 2 if the game records a seed)
+ *     2-byte length of the starting FEN string, followed by the FEN string itself
+ *     8-byte seed the game was generated from (version 2 only)
+ *     2 bytes per move (the Move encoding), terminated by the null move (0x0000)
+ *     1-byte GameResult (unknownResult if the game has no recorded result)
+ *
+ * All multi-byte integers are little-endian.
+ */
+
+#ifndef GAMERECORD_H
+#define GAMERECORD_H
+
+#include "ChessGame.h"
+#include "Move.h"
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+
+/*
+ * Enum representing the recorded result of a game.
+ */
+enum GameResult : uint8_t {unknownResult, whiteWins, blackWins, drawnGame};
+
+
+/****************************** Class GameRecordWriter ******************************/
+
+class GameRecordWriter final {
+
+    public:
+        /*
+         * Parameterised constructor for a writer that appends games to a binary stream.
+         *
+         * @param stream The stream to write games to (opened in binary mode).
+         */
+        GameRecordWriter(std::ostream& stream);
+
+        /*
+         * Writes the header of a new game.
+         *
+         * @param startFen The FEN string of the position that the game starts from.
+         */
+        void beginGame(const char* startFen);
+
+        /*
+         * Writes the header of a new game that was generated from a seed (e.g. a random game),
+         * recording the seed so that the game can be reproduced.
+         *
+         * @param startFen The FEN string of the position that the game starts from.
+         * @param seed The seed the game was generated from.
+         */
+        void beginGame(const char* startFen, uint64_t seed);
+
+        /*
+         * Appends a move to the game that is being written.
+         *
+         * @param move The move to append (must not be the null move).
+         */
+        void addMove(Move move);
+
+        /*
+         * Terminates the game that is being written.
+         *
+         * @param result The result of the game (unknownResult if the game has no result).
+         */
+        void endGame(GameResult result = unknownResult);
+
+    private:
+        std::ostream& stream; // The stream that games are written to
+};
+
+
+/****************************** Class GameRecordReader ******************************/
+
+class GameRecordReader final {
+
+    public:
+        /*
+         * Parameterised constructor for a reader that streams games from a binary stream.
+         *
+         * @param stream The stream to read games from (opened in binary mode).
+         */
+        GameRecordReader(std::istream& stream);
+
+        /*
+         * Reads the header of the next game in the stream.
+         *
+         * @return true if a game header was read; false at the end of the stream or on a malformed header.
+         */
+        bool beginGame();
+
+        /*
+         * Reads the next move of the current game. Once this returns false the game's
+         * result is available from getResult().
+         *
+         * @param move A reference to store the move in.
+         *
+         * @return true if a move was read; false at the end of the game.
+         */
+        bool nextMove(Move& move);
+
+        /*
+         * Reads the next game in the stream and replays it directly into a chess game. The starting
+         * FEN string is loaded with ChessGame::loadPlayableState(), as the file may not be trusted:
+         * a game whose starting position is malformed or not playable is skipped (and counted by
+         * getSkippedGames()), and the game after it is replayed instead.
+         *
+         * @param game The chess game to load the starting position into and submit the moves to.
+         *
+         * @return true if a game was read and every move in it was legal; false otherwise.
+         */
+        bool replayGame(ChessGame& game);
+
+        /*
+         * Getter function for the starting FEN string of the current game.
+         *
+         * @return The FEN string that the current game starts from.
+         */
+        const std::string& getStartFen() const;
+
+        /*
+         * Getter function for the result of the current game (valid once nextMove() has returned false).
+         *
+         * @return The recorded result of the current game.
+         */
+        GameResult getResult() const;
+
+        /*
+         * Determines whether the current game records the seed it was generated from.
+         *
+         * @return true if the game has a seed; false otherwise.
+         */
+        bool hasSeed() const;
+
+        /*
+         * Getter function for the seed the current game was generated from (valid if hasSeed() is true).
+         *
+         * @return The seed of the current game.
+         */
+        uint64_t getSeed() const;
+
+        /*
+         * Getter function for the number of games skipped by replayGame() because their starting
+         * position could not be loaded.
+         *
+         * @return The number of games skipped so far.
+         */
+        uint64_t getSkippedGames() const;
+
+    private:
+        std::istream& stream; // The stream that games are read from
+        std::string startFen; // The starting FEN string of the current game
+        GameResult result; // The result of the current game
+        bool seeded; // Indicates whether the current game records a seed
+        uint64_t seed; // The seed of the current game
+        uint64_t skippedGames; // The number of games skipped by replayGame()
+};
+
+#endif
@@ -0,0 +1,260 @@
+/*
+ * Match.cpp - Implementation file for playing matches between two configurations of the engine.
+ */
+
+#include "Match.h"
+#include "TranspositionTable.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+// The number of moves a side is assumed to have left to make on its clock, for dividing up its time
+static const int movesToGoEstimate = 30;
+
+// The time kept back on a side's clock, as a search overruns its deadline by up to one poll of its stop condition
+static const chrono::milliseconds moveOverhead(10);
+
+// The fraction of a move's time after which no further depth is started, as it would likely not finish
+static const double newDepthFraction = 0.5;
+
+/*
+ * Converts a mean score per game into an Elo difference (logistic model).
+ */
+static double scoreToElo(double score) {
+    return -400.0 * log10(1.0 / score - 1.0);
+}
+
+
+/****************************** MatchScore - Member Function Definitions ******************************/
+
+/* GETTER FOR THE NUMBER OF GAMES SCORED */
+uint64_t MatchScore::games() const {
+    return wins + losses + draws;
+}
+
+/* COMPUTES THE MEAN SCORE PER GAME */
+double MatchScore::meanScore() const {
+    return (games() == 0 ? 0.5 : (wins + 0.5 * draws) / games());
+}
+
+/* ESTIMATES THE ELO DIFFERENCE FROM THE MEAN SCORE */
+double MatchScore::eloDifference() const {
+    double score = meanScore();
+    if (score <= 0.0 || score >= 1.0) {
+        return (score <= 0.0 ? -1000.0 : 1000.0);
+    }
+    return max(-1000.0, min(1000.0, scoreToElo(score)));
+}
+
+/* ESTIMATES THE HALF-WIDTH OF THE 95% CONFIDENCE INTERVAL OF THE ELO DIFFERENCE */
+double MatchScore::eloMargin() const {
+    uint64_t count = games();
+    if (count < 2) {
+        return 0.0;
+    }
+    double score = meanScore();
+    double variance = (wins * (1.0 - score) * (1.0 - score) + losses * score * score + draws * (0.5 - score) * (0.5 - score)) / count;
+    double scoreMargin = 1.96 * sqrt(variance / count);
+    double high = min(score + scoreMargin, 0.999), low = max(score - scoreMargin, 0.001);
+    return (scoreToElo(high) - scoreToElo(low)) / 2.0;
+}
+
+/* COMPUTES THE LOG-LIKELIHOOD RATIO OF H1 AGAINST H0 */
+double MatchScore::logLikelihoodRatio(const SprtSettings& sprt) const {
+    uint64_t count = games();
+    if (count == 0) {
+        return 0.0;
+    }
+    double score = meanScore();
+    double variance = (wins * (1.0 - score) * (1.0 - score) + losses * score * score + draws * (0.5 - score) * (0.5 - score)) / count;
+    if (variance <= 0.0) {
+        return 0.0;
+    }
+    double score0 = 1.0 / (1.0 + pow(10.0, -sprt.elo0 / 400.0));
+    double score1 = 1.0 / (1.0 + pow(10.0, -sprt.elo1 / 400.0));
+    return count * (score1 - score0) * (2.0 * score - score0 - score1) / (2.0 * variance);
+}
+
+/* DECIDES THE SEQUENTIAL PROBABILITY RATIO TEST */
+SprtDecision MatchScore::decide(const SprtSettings& sprt) const {
+    double ratio = logLikelihoodRatio(sprt);
+    if (ratio >= log((1.0 - sprt.beta) / sprt.alpha)) {
+        return sprtAcceptH1;
+    }
+    if (ratio <= log(sprt.beta / (1.0 - sprt.alpha))) {
+        return sprtAcceptH0;
+    }
+    return sprtContinue;
+}
+
+
+/****************************** Match Functions ******************************/
+
+/* PLAYS ONE GAME BETWEEN TWO CONFIGURATIONS FROM AN OPENING */
+void playMatchGame(const EngineConfig& whiteConfig, const EngineConfig& blackConfig, const TimeControl& timeControl,
+                   const char* openingFen, int maxPlies, MatchGame& matchGame) {
+    Clock::time_point gameStart = Clock::now();
+    matchGame.moves.clear();
+
+    ChessGame game;
+    game.setConsoleOutput(false);
+    game.loadState(openingFen);
+
+    // Each side keeps its own transposition table and search (with its pawn hash table) for the whole game
+    const EngineConfig* configs[2] = {&whiteConfig, &blackConfig}; // Indexed by PieceColour
+    TranspositionTable whiteTable(whiteConfig.transpositionEntries), blackTable(blackConfig.transpositionEntries);
+    Search whiteSearch(game, whiteTable), blackSearch(game, blackTable);
+    Search* searches[2] = {&whiteSearch, &blackSearch};
+    Clock::time_point deadline;
+    bool depthCompleted = false; // The first depth always completes, so that there is always a move to play
+    for (PieceColour colour : {white, black}) {
+        searches[colour]->setPawnStructureEvaluation(configs[colour]->pawnStructure);
+        searches[colour]->setStopCondition([&]() { return depthCompleted && Clock::now() >= deadline; });
+    }
+
+    chrono::duration<double> clocks[2] = {chrono::milliseconds(timeControl.baseMilliseconds),
+                                          chrono::milliseconds(timeControl.baseMilliseconds)};
+    chrono::duration<double> increment = chrono::milliseconds(timeControl.incrementMilliseconds);
+    vector<uint64_t> hashes = {game.positionHash()}; // The hash of every position in the game, for repetitions
+    Move moveList[maxLegalMoves];
+
+    auto finish = [&](MatchEnding ending, GameResult result) {
+        matchGame.ending = ending;
+        matchGame.result = result;
+        matchGame.seconds = chrono::duration<double>(Clock::now() - gameStart).count();
+    };
+
+    while (true) {
+        PieceColour turn = game.getTurn();
+        GameResult loss = (turn == white ? blackWins : whiteWins); // The result if the side to move loses
+
+        // The rules engine detects checkmate, stalemate and the 50-move rule
+        if (!game.isInProgress()) {
+            if (game.generateLegalMoves(moveList) == 0) {
+                bool checkmate = game.isInCheck(turn);
+                finish(checkmate ? checkmateMatchEnding : stalemateMatchEnding, checkmate ? loss : drawnGame);
+            }
+            else {
+                finish(fiftyMoveMatchEnding, drawnGame);
+            }
+            return;
+        }
+
+        if (ChessGame::countRepetitions(hashes, game.getHalfMoveCounter()) >= 3) {
+            finish(repetitionMatchEnding, drawnGame);
+            return;
+        }
+        if (static_cast<int>(matchGame.moves.size()) >= maxPlies) {
+            finish(moveLimitMatchEnding, drawnGame);
+            return;
+        }
+
+        // Spend an even share of the clock (plus most of the increment) on the move
+        Clock::time_point moveStart = Clock::now();
+        chrono::duration<double> available = max(clocks[turn] - chrono::duration<double>(moveOverhead), chrono::duration<double>(0));
+        chrono::duration<double> budget = min(available / movesToGoEstimate + increment * 0.75, available * 0.5);
+        deadline = moveStart + chrono::duration_cast<Clock::duration>(budget);
+        depthCompleted = false;
+
+        SearchResult result;
+        for (int depth = 1; depth <= max(configs[turn]->maxDepth, 1); depth++) {
+            if (depth > 1 && Clock::now() - moveStart >= budget * newDepthFraction) {
+                break;
+            }
+            if (!searches[turn]->searchDepth(depth, result)) {
+                break;
+            }
+            depthCompleted = true;
+            if (abs(result.score) >= mateThreshold) { // A forced mate is not improved on by searching deeper
+                break;
+            }
+        }
+
+        clocks[turn] -= Clock::now() - moveStart;
+        if (clocks[turn].count() < 0) {
+            finish(timeForfeitMatchEnding, loss);
+            return;
+        }
+        clocks[turn] += increment;
+
+        if (!game.submitMove(result.bestMove)) {
+            finish(illegalMoveMatchEnding, loss);
+            return;
+        }
+        matchGame.moves.push_back(result.bestMove);
+        hashes.push_back(game.positionHash());
+    }
+}
+
+/* PLAYS A MATCH BETWEEN TWO CONFIGURATIONS ACROSS WORKER THREADS */
+MatchSummary runMatch(const MatchSettings& settings, const vector<string>& openings,
+                      function<void(const MatchGame&, const MatchScore&)> onGameFinished) {
+    unsigned threadCount = settings.concurrency;
+    if (threadCount == 0) {
+        threadCount = max(thread::hardware_concurrency(), 1u);
+    }
+    threadCount = static_cast<unsigned>(min<uint64_t>(threadCount, max<uint64_t>(settings.maxGames, 1)));
+
+    MatchSummary summary;
+    if (openings.empty()) {
+        return summary;
+    }
+    atomic<uint64_t> nextGame(0);
+    atomic<bool> decided(false); // Set once the test accepts a hypothesis, so that no further games are started
+    mutex summaryMutex; // Guards the summary and the callback
+
+    auto playGames = [&]() {
+        MatchGame matchGame;
+        while (!decided) {
+            uint64_t index = nextGame++;
+            if (index >= settings.maxGames) {
+                break;
+            }
+            matchGame.index = index;
+            matchGame.opening = (index / 2) % openings.size();
+            matchGame.firstIsWhite = (index % 2 == 0);
+            const EngineConfig& whiteConfig = (matchGame.firstIsWhite ? settings.first : settings.second);
+            const EngineConfig& blackConfig = (matchGame.firstIsWhite ? settings.second : settings.first);
+            playMatchGame(whiteConfig, blackConfig, settings.timeControl, openings[matchGame.opening].c_str(),
+                          settings.maxPlies, matchGame);
+
+            lock_guard<mutex> lock(summaryMutex);
+            if (matchGame.result == drawnGame) {
+                summary.score.draws++;
+            }
+            else if ((matchGame.result == whiteWins) == matchGame.firstIsWhite) {
+                summary.score.wins++;
+            }
+            else {
+                summary.score.losses++;
+            }
+            summary.endings[matchGame.ending]++;
+            summary.plies += matchGame.moves.size();
+            if (settings.sprt.enabled && summary.decision == sprtContinue) {
+                summary.decision = summary.score.decide(settings.sprt);
+                decided = (summary.decision != sprtContinue);
+            }
+            if (onGameFinished) {
+                onGameFinished(matchGame, summary.score);
+            }
+        }
+    };
+
+    Clock::time_point start = Clock::now();
+    vector<thread> workers;
+    for (unsigned index = 1; index < threadCount; index++) {
+        workers.emplace_back(playGames);
+    }
+    playGames(); // The calling thread plays too
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    summary.seconds = chrono::duration<double>(Clock::now() - start).count();
+    return summary;
+}
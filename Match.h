@@ -0,0 +1,194 @@
+/*
+ * Match.h - Header file for playing matches between two configurations of the engine, for
+ * tuning: many games are played concurrently from a list of openings under a local time
+ * control, adjudicated by the rules engine, and scored as an Elo difference with a sequential
+ * probability ratio test (SPRT) deciding when enough games have been played.
+ */
+
+#ifndef MATCH_H
+#define MATCH_H
+
+#include "GameRecord.h"
+#include "Move.h"
+#include "Search.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/*
+ * A configuration of the engine taking part in a match.
+ */
+struct EngineConfig {
+    std::string name = "engine"; // The name reported in results
+    int maxDepth = maxSearchDepth - 1; // The deepest search to complete for a move, however much time remains
+    size_t transpositionEntries = 1 << 16; // The size of the transposition table (kept for the whole game)
+    bool pawnStructure = true; // Indicates that the evaluation includes the pawn-structure terms
+};
+
+/*
+ * A time control (the same for both sides): a time for the whole game plus an increment per move.
+ */
+struct TimeControl {
+    int baseMilliseconds = 2000; // The time on each side's clock at the start of the game
+    int incrementMilliseconds = 20; // The time added to a side's clock after each of its moves
+};
+
+/*
+ * Enum representing how a match game ended.
+ */
+enum MatchEnding : uint8_t {checkmateMatchEnding, stalemateMatchEnding, fiftyMoveMatchEnding, repetitionMatchEnding,
+                            moveLimitMatchEnding, timeForfeitMatchEnding, illegalMoveMatchEnding};
+
+const int matchEndingCount = 7;
+
+/*
+ * The parameters of a sequential probability ratio test of the Elo difference between the
+ * configurations: H0 (the difference is elo0) against H1 (the difference is elo1).
+ */
+struct SprtSettings {
+    bool enabled = true; // Indicates that the match stops as soon as the test accepts a hypothesis
+    double elo0 = 0; // The Elo difference of the null hypothesis
+    double elo1 = 5; // The Elo difference of the alternative hypothesis
+    double alpha = 0.05; // The probability of accepting H1 when H0 is true
+    double beta = 0.05; // The probability of accepting H0 when H1 is true
+};
+
+/*
+ * Enum representing the state of a sequential probability ratio test.
+ */
+enum SprtDecision : uint8_t {sprtContinue, sprtAcceptH0, sprtAcceptH1};
+
+/*
+ * The parameters of a match.
+ */
+struct MatchSettings {
+    EngineConfig first; // The configuration being tested (Elo differences are this configuration's)
+    EngineConfig second; // The configuration it is compared against
+    TimeControl timeControl; // The time control of every game
+    uint64_t maxGames = 1000; // The number of games to play if the test never decides
+    unsigned concurrency = 0; // The number of games played at once (0 for one per hardware thread; clocks run in wall time, so more games than threads lose time)
+    int maxPlies = 400; // Games still in progress after this many plies are adjudicated drawn
+    SprtSettings sprt; // The stop rule
+};
+
+/*
+ * A finished match game.
+ */
+struct MatchGame {
+    uint64_t index; // The index of the game in the match (games 2n and 2n + 1 play the same opening with colours swapped)
+    size_t opening; // The index of the opening played
+    bool firstIsWhite; // Indicates that the first configuration played white
+    std::vector<Move> moves; // The moves of the game
+    MatchEnding ending; // How the game ended
+    GameResult result; // The result of the game
+    double seconds; // The time the game took
+};
+
+/*
+ * The score of a match from the point of view of the first configuration.
+ */
+struct MatchScore {
+    uint64_t wins = 0; // Games won by the first configuration
+    uint64_t losses = 0; // Games lost by the first configuration
+    uint64_t draws = 0; // Games drawn
+
+    /*
+     * Getter function for the number of games scored.
+     *
+     * @return The number of games won, lost and drawn.
+     */
+    uint64_t games() const;
+
+    /*
+     * Computes the mean score per game (a win scoring 1, a draw 0.5).
+     *
+     * @return The mean score, or 0.5 if no games have been scored.
+     */
+    double meanScore() const;
+
+    /*
+     * Estimates the Elo difference between the configurations from the mean score (logistic model).
+     *
+     * @return The estimated Elo difference, clamped to +-1000 when every game has been won or lost.
+     */
+    double eloDifference() const;
+
+    /*
+     * Estimates the half-width of the 95% confidence interval of the Elo difference, from the
+     * variance of the results of single games.
+     *
+     * @return The half-width in Elo (0 until there are at least two games).
+     */
+    double eloMargin() const;
+
+    /*
+     * Computes the log-likelihood ratio of H1 against H0 for the results so far, with the
+     * normal approximation to the trinomial (win, draw, loss) distribution of a game's result.
+     *
+     * @param sprt The hypotheses.
+     *
+     * @return The log-likelihood ratio (0 while the results have no variance).
+     */
+    double logLikelihoodRatio(const SprtSettings& sprt) const;
+
+    /*
+     * Decides the test: H1 is accepted once the log-likelihood ratio reaches log((1 - beta) / alpha),
+     * and H0 once it falls to log(beta / (1 - alpha)).
+     *
+     * @param sprt The hypotheses and error probabilities.
+     *
+     * @return The decision (sprtContinue until a bound is crossed).
+     */
+    SprtDecision decide(const SprtSettings& sprt) const;
+};
+
+/*
+ * Counters describing a finished match.
+ */
+struct MatchSummary {
+    MatchScore score; // The score of the first configuration
+    SprtDecision decision = sprtContinue; // The decision of the test when the match stopped
+    uint64_t endings[matchEndingCount] = {}; // The number of games ending each way, indexed by MatchEnding
+    uint64_t plies = 0; // The number of moves played across every game
+    double seconds = 0; // The time taken
+};
+
+/*
+ * Plays one game between two configurations from an opening. Moves are submitted with
+ * submitMove() (the fully validated move path) and the game is adjudicated by the rules
+ * engine's own detection of checkmate, stalemate and the 50-move rule, plus threefold
+ * repetition, the time control and the ply limit. Each side's clock runs while it searches;
+ * a side whose clock runs out loses on time.
+ *
+ * @param whiteConfig The configuration playing white.
+ * @param blackConfig The configuration playing black.
+ * @param timeControl The time control.
+ * @param openingFen The FEN string of the position the game starts from (must be accepted by
+ *        ChessGame::loadPlayableState()).
+ * @param maxPlies The number of plies after which the game is adjudicated drawn.
+ * @param game A reference to store the moves, ending, result and time of the game in.
+ */
+void playMatchGame(const EngineConfig& whiteConfig, const EngineConfig& blackConfig, const TimeControl& timeControl,
+                   const char* openingFen, int maxPlies, MatchGame& game);
+
+/*
+ * Plays a match between two configurations, several games at once on worker threads. Each
+ * opening is played twice, once with each configuration as white. As each game finishes, it is
+ * scored and passed to a callback, in the order games finish; once the test accepts a hypothesis
+ * (or maxGames have been started) no further games are started, and the games still being
+ * played are finished and scored.
+ *
+ * @param settings The configurations, time control, number of games and stop rule.
+ * @param openings The FEN strings of the openings, used in turn (each must be accepted by
+ *        ChessGame::loadPlayableState()).
+ * @param onGameFinished Called with each finished game and the score including it (may be empty).
+ *                       Calls are serialised, so the callback may write to a shared stream.
+ *
+ * @return The final score, the decision of the test and how the games ended.
+ */
+MatchSummary runMatch(const MatchSettings& settings, const std::vector<std::string>& openings,
+                      std::function<void(const MatchGame&, const MatchScore&)> onGameFinished);
+
+#endif
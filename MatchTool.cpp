@@ -0,0 +1,206 @@
+/*
+ * MatchTool.cpp - Command line tool to play a match between two configurations of the engine,
+ * for tuning. Games are played concurrently from a file of openings (one FEN string per line;
+ * blank lines and lines starting with '#' are skipped, and invalid or unplayable positions are
+ * reported and skipped), each opening once with each
+ * configuration as white. Every game's result is printed as it finishes, with the running Elo
+ * difference and log-likelihood ratio, and the match stops early once the SPRT decides.
+ *
+ * Options (name=value, in any order):
+ *   games=N              the number of games to play if the test never decides (default 1000)
+ *   concurrency=N        the number of games played at once (default one per hardware thread)
+ *   time=MS inc=MS       the time control: milliseconds per game and per move (default 2000 and 20)
+ *   plies=N              the ply limit, after which a game is adjudicated drawn (default 400)
+ *   elo0=E elo1=E        the SPRT hypotheses (default 0 and 5)
+ *   alpha=P beta=P       the SPRT error probabilities (default 0.05 and 0.05)
+ *   sprt=0               plays every game, without the stop rule
+ *   first.OPTION=VALUE   an option of the configuration being tested (named "first" by default)
+ *   second.OPTION=VALUE  an option of the configuration it is compared against (named "second" by default)
+ * where the configuration options are name=NAME, depth=N (the depth limit), hash=N (transposition
+ * table entries) and pawns=0|1 (the pawn-structure evaluation).
+ *
+ * Usage: match <openings file> [option=value...]
+ */
+
+#include "Match.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static const char* const endingNames[matchEndingCount] = {"checkmate", "stalemate", "50-move rule", "repetition",
+                                                          "ply limit", "time forfeit", "illegal move"};
+
+/* READS THE PLAYABLE OPENINGS OF A FILE, ONE FEN STRING PER LINE, REPORTING THE REST */
+static bool readOpenings(const char* path, vector<string>& openings) {
+    ifstream input(path);
+    if (!input) {
+        return false;
+    }
+    ChessGame game; // Checks each opening
+    string line;
+    int lineNumber = 0;
+    while (getline(input, line)) {
+        lineNumber++;
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (game.loadPlayableState(line.c_str())) {
+            openings.push_back(line);
+        }
+        else {
+            cerr << "line " << lineNumber << ": skipped invalid FEN string or position: " << line << "\n";
+        }
+    }
+    return true;
+}
+
+/* SETS AN OPTION OF A CONFIGURATION, RETURNING FALSE IF THE OPTION IS UNKNOWN */
+static bool setConfigOption(EngineConfig& config, const string& name, const char* value) {
+    if (name == "name") {
+        config.name = value;
+    }
+    else if (name == "depth") {
+        config.maxDepth = atoi(value);
+    }
+    else if (name == "hash") {
+        config.transpositionEntries = strtoull(value, nullptr, 10);
+    }
+    else if (name == "pawns") {
+        config.pawnStructure = (atoi(value) != 0);
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+/* SETS AN OPTION OF THE MATCH, RETURNING FALSE IF THE OPTION IS UNKNOWN */
+static bool setOption(MatchSettings& settings, const string& name, const char* value) {
+    if (name.compare(0, 6, "first.") == 0) {
+        return setConfigOption(settings.first, name.substr(6), value);
+    }
+    if (name.compare(0, 7, "second.") == 0) {
+        return setConfigOption(settings.second, name.substr(7), value);
+    }
+    if (name == "games") {
+        settings.maxGames = strtoull(value, nullptr, 10);
+    }
+    else if (name == "concurrency") {
+        settings.concurrency = atoi(value);
+    }
+    else if (name == "time") {
+        settings.timeControl.baseMilliseconds = atoi(value);
+    }
+    else if (name == "inc") {
+        settings.timeControl.incrementMilliseconds = atoi(value);
+    }
+    else if (name == "plies") {
+        settings.maxPlies = atoi(value);
+    }
+    else if (name == "elo0") {
+        settings.sprt.elo0 = atof(value);
+    }
+    else if (name == "elo1") {
+        settings.sprt.elo1 = atof(value);
+    }
+    else if (name == "alpha") {
+        settings.sprt.alpha = atof(value);
+    }
+    else if (name == "beta") {
+        settings.sprt.beta = atof(value);
+    }
+    else if (name == "sprt") {
+        settings.sprt.enabled = (atoi(value) != 0);
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+/* PRINTS THE RUNNING SCORE OF THE MATCH */
+static void printScore(const MatchScore& score, const SprtSettings& sprt) {
+    cout << "+" << score.wins << " -" << score.losses << " =" << score.draws << ", Elo "
+         << score.eloDifference() << " +- " << score.eloMargin();
+    if (sprt.enabled) {
+        cout << ", LLR " << score.logLikelihoodRatio(sprt) << " [" << log(sprt.beta / (1 - sprt.alpha)) << ", "
+             << log((1 - sprt.beta) / sprt.alpha) << "]";
+    }
+}
+
+int main(int argc, char** argv) {
+    MatchSettings settings;
+    settings.first.name = "first";
+    settings.second.name = "second";
+
+    bool valid = (argc >= 2);
+    for (int index = 2; valid && index < argc; index++) {
+        const char* separator = strchr(argv[index], '=');
+        valid = (separator != nullptr && setOption(settings, string(argv[index], separator - argv[index]), separator + 1));
+        if (!valid) {
+            cerr << "Unknown option " << argv[index] << "\n";
+        }
+    }
+    if (!valid) {
+        cerr << "Usage: " << argv[0] << " <openings file> [option=value...]\n";
+        return 1;
+    }
+    if (!(settings.sprt.alpha > 0 && settings.sprt.alpha < 1 && settings.sprt.beta > 0 && settings.sprt.beta < 1)) {
+        cerr << "The SPRT error probabilities must be between 0 and 1\n";
+        return 1;
+    }
+
+    vector<string> openings;
+    if (!readOpenings(argv[1], openings)) {
+        cerr << "Could not open openings file " << argv[1] << "\n";
+        return 1;
+    }
+    if (openings.empty()) {
+        cerr << "No openings in " << argv[1] << "\n";
+        return 1;
+    }
+
+    cout << settings.first.name << " vs " << settings.second.name << ": up to " << settings.maxGames << " games from "
+         << openings.size() << " openings, " << settings.timeControl.baseMilliseconds << "+"
+         << settings.timeControl.incrementMilliseconds << " ms";
+    if (settings.sprt.enabled) {
+        cout << ", SPRT elo0=" << settings.sprt.elo0 << " elo1=" << settings.sprt.elo1 << " alpha=" << settings.sprt.alpha
+             << " beta=" << settings.sprt.beta;
+    }
+    cout << "\n";
+
+    MatchSummary summary = runMatch(settings, openings, [&](const MatchGame& game, const MatchScore& score) {
+        const string& whiteName = (game.firstIsWhite ? settings.first.name : settings.second.name);
+        const string& blackName = (game.firstIsWhite ? settings.second.name : settings.first.name);
+        const char* result = (game.result == whiteWins ? "1-0" : (game.result == blackWins ? "0-1" : "1/2-1/2"));
+        cout << "game " << game.index + 1 << " (opening " << game.opening + 1 << "): " << whiteName << " " << result
+             << " " << blackName << " by " << endingNames[game.ending] << ", " << game.moves.size() << " plies | ";
+        printScore(score, settings.sprt);
+        cout << endl;
+    });
+
+    cout << "Finished " << summary.score.games() << " games in " << summary.seconds << " s ("
+         << summary.plies / summary.seconds << " plies/s): ";
+    printScore(summary.score, settings.sprt);
+    cout << "\n  endings:";
+    for (int ending = 0; ending < matchEndingCount; ending++) {
+        cout << (ending == 0 ? " " : ", ") << summary.endings[ending] << " " << endingNames[ending];
+    }
+    cout << "\n";
+    if (settings.sprt.enabled) {
+        cout << "  SPRT: " << (summary.decision == sprtAcceptH1 ? "H1 accepted (" + settings.first.name + " is stronger)"
+                                : summary.decision == sprtAcceptH0 ? string("H0 accepted (no improvement)")
+                                : string("undecided")) << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,184 @@
+/*
+ * MateSolver.cpp - Implementation file for the MateSolver class, a depth-first
+ * proof-number (df-pn) search for forced mates.
+ */
+
+#include "MateSolver.h"
+#include <algorithm>
+
+using namespace std;
+
+// The proof or disproof number of a position that has been disproven or proven (respectively)
+static const uint32_t infiniteNumber = 1u << 30;
+
+// The longest mate searched for, in plies (which bounds the depth of recursion)
+static const int maxMatePlies = 63;
+
+/*
+ * Adds two proof or disproof numbers, saturating at infinity.
+ */
+static uint32_t addNumbers(uint64_t number1, uint64_t number2) {
+    return static_cast<uint32_t>(min<uint64_t>(number1 + number2, infiniteNumber));
+}
+
+
+/****************************** MateSolver - Member Function Definitions ******************************/
+
+/* PARAMETERISED CONSTRUCTOR - ALLOCATES A POWER OF TWO NUMBER OF EMPTY SLOTS */
+MateSolver::MateSolver(ChessGame& game, size_t tableBytes) : game(game) {
+    size_t slotCount = 2;
+    while (slotCount * 2 * sizeof(ProofEntry) <= tableBytes) {
+        slotCount *= 2;
+    }
+    table.assign(slotCount, ProofEntry{0, 1, 1, 0, Move()});
+    indexMask = slotCount - 1;
+}
+
+/* DETERMINES WHETHER THE SIDE TO MOVE CAN FORCE MATE WITHIN A NUMBER OF MOVES */
+MateResult MateSolver::solve(int mateInMoves, uint64_t limit) {
+    nodes = 0;
+    nodeLimit = limit;
+
+    int remainingPlies = min(max(2 * mateInMoves - 1, 1), maxMatePlies);
+    expand(infiniteNumber, infiniteNumber, remainingPlies, true);
+
+    ProofEntry root;
+    lookup(tableKey(game.positionHash(), remainingPlies), root);
+
+    MateResult result;
+    result.nodes = nodes;
+    if (root.proofNumber == 0) {
+        result.verdict = mateProven;
+        result.firstMove = root.bestMove;
+    }
+    else if (root.disproofNumber == 0) {
+        result.verdict = mateDisproven;
+    }
+    return result;
+}
+
+/* GETTER FOR THE SIZE OF THE TABLE IN BYTES */
+size_t MateSolver::getMemoryUsage() const {
+    return table.size() * sizeof(ProofEntry);
+}
+
+/* EXPANDS A POSITION UNTIL ITS PROOF OR DISPROOF NUMBER REACHES A THRESHOLD */
+void MateSolver::expand(uint32_t proofThreshold, uint32_t disproofThreshold, int remainingPlies, bool attacking) {
+    uint64_t startNodes = nodes++;
+    ProofEntry entry{tableKey(game.positionHash(), remainingPlies), 0, 0, 0, Move()};
+
+    Move moveList[maxLegalMoves];
+    int count = game.generateLegalMoves(moveList);
+
+    // A defender with no legal moves is mated (proven) or stalemated; an attacker with none cannot mate
+    if (count == 0) {
+        bool proven = (!attacking && game.activeColourInCheck());
+        entry.proofNumber = (proven ? 0 : infiniteNumber);
+        entry.disproofNumber = (proven ? infiniteNumber : 0);
+        store(entry);
+        return;
+    }
+    if (remainingPlies == 0) { // The defender has survived every attacking move
+        entry.proofNumber = infiniteNumber;
+        store(entry);
+        return;
+    }
+
+    // Each child's key is computed once, so the loop below only reads the table
+    uint64_t childKeys[maxLegalMoves];
+    ChessGame::MoveUndo undo;
+    for (int index = 0; index < count; index++) {
+        game.makeLegalMove(moveList[index], undo);
+        childKeys[index] = tableKey(game.positionHash(), remainingPlies - 1);
+        game.unmakeLegalMove(undo);
+    }
+
+    while (true) {
+        // The attacker needs one proven move (OR node); the defender needs every move proven (AND node)
+        uint64_t proofSum = 0, disproofSum = 0;
+        uint32_t minProof = infiniteNumber, minDisproof = infiniteNumber;
+        uint32_t secondBest = infiniteNumber;
+        int best = 0;
+        ProofEntry bestChild{0, 1, 1, 0, Move()};
+
+        for (int index = 0; index < count; index++) {
+            ProofEntry child;
+            lookup(childKeys[index], child);
+            proofSum += child.proofNumber;
+            disproofSum += child.disproofNumber;
+
+            uint32_t value = (attacking ? child.proofNumber : child.disproofNumber);
+            uint32_t bestValue = (attacking ? minProof : minDisproof);
+            if (value < bestValue) {
+                secondBest = bestValue;
+                best = index;
+                bestChild = child;
+            }
+            else if (value < secondBest) {
+                secondBest = value;
+            }
+            minProof = min(minProof, child.proofNumber);
+            minDisproof = min(minDisproof, child.disproofNumber);
+        }
+
+        entry.proofNumber = (attacking ? minProof : addNumbers(proofSum, 0));
+        entry.disproofNumber = (attacking ? addNumbers(disproofSum, 0) : minDisproof);
+        entry.bestMove = moveList[best];
+        if (entry.proofNumber >= proofThreshold || entry.disproofNumber >= disproofThreshold || nodes >= nodeLimit) {
+            break;
+        }
+
+        // Search the most promising child until it is no longer the most promising
+        uint32_t childProofThreshold, childDisproofThreshold;
+        if (attacking) {
+            childProofThreshold = min(proofThreshold, addNumbers(secondBest, 1));
+            childDisproofThreshold = addNumbers(disproofThreshold - entry.disproofNumber, bestChild.disproofNumber);
+        }
+        else {
+            childProofThreshold = addNumbers(proofThreshold - entry.proofNumber, bestChild.proofNumber);
+            childDisproofThreshold = min(disproofThreshold, addNumbers(secondBest, 1));
+        }
+
+        game.makeLegalMove(moveList[best], undo);
+        expand(childProofThreshold, childDisproofThreshold, remainingPlies - 1, !attacking);
+        game.unmakeLegalMove(undo);
+    }
+
+    entry.work = static_cast<uint32_t>(min<uint64_t>(nodes - startNodes, UINT32_MAX));
+    store(entry);
+}
+
+/* COMBINES A POSITION HASH WITH THE NUMBER OF REMAINING PLIES */
+uint64_t MateSolver::tableKey(uint64_t hash, int remainingPlies) {
+    uint64_t key = hash ^ (static_cast<uint64_t>(remainingPlies + 1) * 0x9E3779B97F4A7C15ull);
+    return (key == 0 ? 1 : key);
+}
+
+/* LOOKS UP THE PROOF AND DISPROOF NUMBERS OF A POSITION IN EITHER SLOT OF ITS BUCKET */
+void MateSolver::lookup(uint64_t key, ProofEntry& entry) const {
+    const ProofEntry* bucket = &table[key & indexMask & ~uint64_t(1)];
+    for (int slot = 0; slot < 2; slot++) {
+        if (bucket[slot].key == key) {
+            entry = bucket[slot];
+            return;
+        }
+    }
+    entry = ProofEntry{key, 1, 1, 0, Move()};
+}
+
+/* STORES THE NUMBERS OF A POSITION: THE FIRST SLOT OF A BUCKET KEEPS THE MOST WORK, THE SECOND THE LATEST ENTRY */
+void MateSolver::store(const ProofEntry& entry) {
+    ProofEntry* bucket = &table[entry.key & indexMask & ~uint64_t(1)];
+    if (bucket[0].key == entry.key) {
+        bucket[0] = entry;
+    }
+    else if (entry.work >= bucket[0].work) {
+        if (bucket[1].key != entry.key) {
+            bucket[1] = bucket[0];
+        }
+        bucket[0] = entry;
+    }
+    else {
+        bucket[1] = entry;
+    }
+}
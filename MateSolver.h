@@ -0,0 +1,121 @@
+/*
+ * MateSolver.h - Header file for the MateSolver class, which proves or disproves a
+ * forced mate by depth-first proof-number (df-pn) search over the legal move
+ * generator, storing proof and disproof numbers in a memory-bounded table.
+ */
+
+#ifndef MATESOLVER_H
+#define MATESOLVER_H
+
+#include "ChessGame.h"
+#include "Move.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Enum representing the outcome of a mate search.
+ */
+enum MateVerdict {mateProven, mateDisproven, mateUnknown};
+
+/*
+ * The result of a mate search.
+ */
+struct MateResult {
+    MateVerdict verdict = mateUnknown; // Whether the side to move can force mate (unknown if the node limit was reached)
+    Move firstMove; // A first move of the forced mate (the null move unless proven)
+    uint64_t nodes = 0; // The number of positions expanded
+};
+
+
+/****************************** Class MateSolver ******************************/
+
+class MateSolver final {
+
+    public:
+        /*
+         * Parameterised constructor for a solver with a fixed-size table of proof and disproof numbers.
+         * The table is split into buckets of two slots: one keeps the entry representing the most work,
+         * and the other the most recently stored entry, so the table never grows once allocated.
+         *
+         * @param game The game whose current position to solve (changed during the search and restored after).
+         * @param tableBytes The greatest size of the table in bytes (the number of entries is rounded down
+         *                   to a power of two, at least two).
+         */
+        MateSolver(ChessGame& game, size_t tableBytes);
+
+        /*
+         * Determines whether the side to move can force checkmate within a number of its own moves.
+         *
+         * @param mateInMoves The number of moves by the side to move within which to mate ("mate in N", at most 32).
+         * @param nodeLimit The greatest number of positions to expand before giving up.
+         *
+         * @return The verdict, a first move of the mate if proven, and the number of positions expanded.
+         */
+        MateResult solve(int mateInMoves, uint64_t nodeLimit);
+
+        /*
+         * Getter function for the size of the table.
+         *
+         * @return The number of bytes of table entries held.
+         */
+        size_t getMemoryUsage() const;
+
+    private:
+        /*
+         * The proof and disproof numbers of a position, for a given number of remaining plies.
+         */
+        struct ProofEntry {
+            uint64_t key; // The position hash combined with the remaining plies (0 if the slot is empty)
+            uint32_t proofNumber; // The minimum number of positions that must be proven to prove a mate
+            uint32_t disproofNumber; // The minimum number of positions that must be disproven to disprove a mate
+            uint32_t work; // The number of positions expanded beneath this one, used to choose what to overwrite
+            Move bestMove; // The move leading to the most promising child
+        };
+
+        ChessGame& game; // The game being solved
+        std::vector<ProofEntry> table; // The proof and disproof numbers, indexed by the low bits of the key
+        uint64_t indexMask; // The number of table slots less one
+        uint64_t nodes = 0; // The number of positions expanded in the current solve
+        uint64_t nodeLimit = 0; // The node limit of the current solve
+
+        /*
+         * Expands a position until its proof or disproof number reaches a threshold (the "MID"
+         * procedure of df-pn), storing its numbers in the table.
+         *
+         * @param proofThreshold The proof number at which to return.
+         * @param disproofThreshold The disproof number at which to return.
+         * @param remainingPlies The number of plies left in which to mate.
+         * @param attacking true if the side to move is the side trying to mate; false if it is defending.
+         */
+        void expand(uint32_t proofThreshold, uint32_t disproofThreshold, int remainingPlies, bool attacking);
+
+        /*
+         * Combines a position hash with the number of remaining plies into a table key.
+         *
+         * @param hash The Zobrist hash of the position.
+         * @param remainingPlies The number of plies left in which to mate.
+         *
+         * @return The table key (never 0).
+         */
+        static uint64_t tableKey(uint64_t hash, int remainingPlies);
+
+        /*
+         * Looks up the proof and disproof numbers of a position in its bucket, returning (1, 1) if it
+         * is not stored.
+         *
+         * @param key The table key of the position.
+         * @param entry A reference to store the numbers in.
+         */
+        void lookup(uint64_t key, ProofEntry& entry) const;
+
+        /*
+         * Stores the proof and disproof numbers of a position in its bucket, keeping the entry
+         * representing the most work in the first slot and the latest entry in the second.
+         *
+         * @param entry The entry to store.
+         */
+        void store(const ProofEntry& entry);
+};
+
+#endif
@@ -0,0 +1,134 @@
+/*
+ * MateSolverTool.cpp - Command line tool to verify a file of mate puzzles in parallel
+ * with the df-pn mate solver, reporting the puzzles solved per second and the memory used.
+ *
+ * Puzzle file: one puzzle per line, a FEN string followed by "dm <N>" (EPD's direct mate
+ * opcode), e.g. "6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1 dm 1". Blank lines and lines starting
+ * with '#' are ignored. Puzzles are submitted by users, so a puzzle whose FEN string is
+ * malformed or whose position is not playable (see ChessGame::restorePlayablePosition()), or
+ * whose mate is not in a positive number of moves, is rejected and reported rather than solved.
+ *
+ * Usage: matesolve <puzzle file> [threads] [table MB per thread] [node limit per puzzle]
+ */
+
+#include "ChessGame.h"
+#include "MateSolver.h"
+#include "PackedPosition.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+/*
+ * A puzzle read from the puzzle file.
+ */
+struct Puzzle {
+    int line; // The line of the file the puzzle was read from
+    string fen; // The position, with the side to mate to move
+    int mateInMoves; // The number of moves within which the puzzle claims mate is forced
+    Position position; // The position parsed from the FEN string
+    bool valid; // Indicates that the puzzle was parsed and its position loaded (cleared if it is rejected)
+};
+
+/* READS EVERY PUZZLE FROM A PUZZLE FILE */
+static bool readPuzzles(const char* path, vector<Puzzle>& puzzles) {
+    ifstream input(path);
+    if (!input) {
+        return false;
+    }
+    string text;
+    for (int line = 1; getline(input, text); line++) {
+        size_t opcode = text.find(" dm ");
+        if (text.empty() || text[0] == '#' || opcode == string::npos) {
+            continue;
+        }
+        Puzzle puzzle{line, text.substr(0, opcode), atoi(text.c_str() + opcode + 4), Position(), false};
+        puzzle.valid = (puzzle.mateInMoves > 0 && parseFen(puzzle.fen.c_str(), puzzle.position));
+        puzzles.push_back(puzzle);
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <puzzle file> [threads] [table MB per thread] [node limit per puzzle]\n";
+        return 1;
+    }
+    unsigned threadCount = (argc > 2 ? atoi(argv[2]) : 0);
+    if (threadCount == 0) {
+        threadCount = max(thread::hardware_concurrency(), 1u);
+    }
+    size_t tableBytes = static_cast<size_t>(argc > 3 ? atol(argv[3]) : 16) << 20;
+    uint64_t nodeLimit = (argc > 4 ? strtoull(argv[4], nullptr, 10) : 10000000);
+
+    vector<Puzzle> puzzles;
+    if (!readPuzzles(argv[1], puzzles)) {
+        cerr << "Could not open puzzle file " << argv[1] << "\n";
+        return 1;
+    }
+
+    // VERIFY THE PUZZLES, EACH THREAD CLAIMING THE NEXT UNSOLVED ONE
+    vector<MateResult> results(puzzles.size());
+    atomic<size_t> nextPuzzle(0);
+    atomic<size_t> tableMemory(0);
+    Clock::time_point start = Clock::now();
+
+    auto verifyPuzzles = [&]() {
+        ChessGame game;
+        game.setConsoleOutput(false);
+        MateSolver solver(game, tableBytes);
+        tableMemory += solver.getMemoryUsage();
+        for (size_t index = nextPuzzle++; index < puzzles.size(); index = nextPuzzle++) {
+            Puzzle& puzzle = puzzles[index];
+            puzzle.valid = puzzle.valid && game.restorePlayablePosition(puzzle.position);
+            if (puzzle.valid) {
+                results[index] = solver.solve(puzzle.mateInMoves, nodeLimit);
+            }
+        }
+    };
+    vector<thread> workers;
+    for (unsigned index = 0; index < threadCount; index++) {
+        workers.emplace_back(verifyPuzzles);
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+    // REPORT
+    size_t proven = 0, disproven = 0, unknown = 0, rejected = 0;
+    uint64_t nodes = 0;
+    for (size_t index = 0; index < puzzles.size(); index++) {
+        if (!puzzles[index].valid) {
+            rejected++;
+            cout << "line " << puzzles[index].line << ": rejected (malformed or unplayable): " << puzzles[index].fen << "\n";
+            continue;
+        }
+        const MateResult& result = results[index];
+        nodes += result.nodes;
+        if (result.verdict == mateProven) {
+            proven++;
+            continue;
+        }
+        (result.verdict == mateDisproven ? disproven : unknown)++;
+        cout << "line " << puzzles[index].line << ": " << (result.verdict == mateDisproven ? "no mate in " : "undecided mate in ")
+             << puzzles[index].mateInMoves << " (" << result.nodes << " nodes): " << puzzles[index].fen << "\n";
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    cout << puzzles.size() << " puzzles on " << threadCount << " threads in " << seconds << " s: "
+         << proven << " proven, " << disproven << " disproven, " << unknown << " undecided, " << rejected << " rejected\n";
+    cout << "  " << puzzles.size() / seconds << " puzzles solved/s, " << static_cast<long>(nodes / seconds) << " nodes/s\n";
+    cout << "  memory: " << (tableMemory >> 20) << " MB of tables, " << usage.ru_maxrss / 1024 << " MB peak resident\n";
+    return (proven == puzzles.size() ? 0 : 2);
+}
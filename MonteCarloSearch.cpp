@@ -0,0 +1,337 @@
+/*
+ * MonteCarloSearch.cpp - Implementation file for the MonteCarloSearch class, a
+ * multithreaded UCT search with random playouts over a fixed node arena.
+ */
+
+#include "MonteCarloSearch.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// The deepest a playout may descend through the tree before playing out at random
+static const int maxTreeDepth = 128;
+
+// The longest a random playout may last before it is scored as a draw
+static const int maxPlayoutPlies = 300;
+
+// The weight of exploration against exploitation in the upper confidence bound
+static const double explorationConstant = 1.4;
+
+/*
+ * Advances a xorshift64* generator, returning its next pseudorandom number.
+ */
+static uint64_t nextRandom(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ull;
+}
+
+
+/****************************** MonteCarloSearch - Member Function Definitions ******************************/
+
+/* PARAMETERISED CONSTRUCTOR - ALLOCATES BOTH ARENAS */
+MonteCarloSearch::MonteCarloSearch(size_t nodeCapacity, PlayoutPolicy policy) : capacity(max<size_t>(nodeCapacity, 1)), nodesUsed(0), policy(policy) {
+    arenas[0] = make_unique<Node[]>(capacity);
+    arenas[1] = make_unique<Node[]>(capacity);
+    resetNode(arenas[0][0], Move());
+    nodesUsed = 1;
+}
+
+/* SETS THE ROOT POSITION AND DISCARDS THE TREE */
+void MonteCarloSearch::setPosition(const Position& position) {
+    rootPosition = position;
+    activeArena = 0;
+    resetNode(arenas[0][0], Move());
+    nodesUsed = 1;
+}
+
+/* ADVANCES THE ROOT BY A MOVE, KEEPING ITS SUBTREE */
+void MonteCarloSearch::advance(Move move) {
+    ChessGame game;
+    game.setConsoleOutput(false);
+    game.restorePosition(rootPosition);
+    ChessGame::MoveUndo undo;
+    game.makeLegalMove(move, undo);
+    rootPosition = game.savePosition();
+
+    // Find the subtree of the move played
+    Node* from = arenas[activeArena].get();
+    const Node& root = from[0];
+    int childIndex = -1;
+    if (root.state == expanded) {
+        for (int child = 0; child < root.childCount; child++) {
+            if (from[root.firstChild + child].move == move) {
+                childIndex = root.firstChild + child;
+            }
+        }
+    }
+    if (childIndex == -1) { // Never explored, so nothing to reuse
+        resetNode(from[0], Move());
+        nodesUsed = 1;
+        return;
+    }
+
+    // Copy the subtree breadth first, so that every node's children stay contiguous
+    Node* to = arenas[1 - activeArena].get();
+    vector<uint32_t> sourceOf = {static_cast<uint32_t>(childIndex)};
+    for (size_t index = 0; index < sourceOf.size(); index++) {
+        const Node& source = from[sourceOf[index]];
+        Node& copy = to[index];
+        copy.visits = source.visits.load();
+        copy.halfPoints = source.halfPoints.load();
+        copy.state = source.state.load();
+        copy.terminalResult = source.terminalResult;
+        copy.move = (index == 0 ? Move() : source.move);
+        copy.childCount = (source.state == expanded ? source.childCount : 0);
+        copy.firstChild = sourceOf.size();
+        for (int child = 0; child < copy.childCount; child++) {
+            sourceOf.push_back(source.firstChild + child);
+        }
+    }
+    activeArena = 1 - activeArena;
+    nodesUsed = sourceOf.size();
+}
+
+/* RUNS PLAYOUTS FROM THE ROOT ACROSS THREADS */
+MonteCarloStatistics MonteCarloSearch::search(uint64_t playouts, unsigned threadCount, uint64_t seed) {
+    if (threadCount == 0) {
+        threadCount = max(thread::hardware_concurrency(), 1u);
+    }
+    atomic<uint64_t> remaining(playouts), completed(0);
+    atomic<bool> arenaFull(false);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (unsigned index = 0; index < threadCount; index++) {
+        uint64_t threadSeed = (seed + index) * 0x9E3779B97F4A7C15ull;
+        workers.emplace_back([this, &remaining, &completed, &arenaFull, threadSeed]() {
+            runPlayouts(remaining, completed, arenaFull, threadSeed);
+        });
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+
+    MonteCarloStatistics statistics;
+    statistics.playouts = completed;
+    statistics.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    statistics.nodesUsed = min(nodesUsed.load(), capacity);
+    statistics.arenaFull = arenaFull;
+    return statistics;
+}
+
+/* OBTAINS THE MOST VISITED MOVE AT THE ROOT */
+Move MonteCarloSearch::bestMove() const {
+    const Node* arena = arenas[activeArena].get();
+    const Node& root = arena[0];
+    if (root.state != expanded) {
+        return Move();
+    }
+    Move best;
+    uint32_t bestVisits = 0;
+    for (int child = 0; child < root.childCount; child++) {
+        const Node& node = arena[root.firstChild + child];
+        if (best.isNull() || node.visits > bestVisits) {
+            best = node.move;
+            bestVisits = node.visits;
+        }
+    }
+    return best;
+}
+
+/* GETTER FOR THE NUMBER OF VISITS OF THE ROOT */
+uint32_t MonteCarloSearch::getRootVisits() const {
+    return arenas[activeArena][0].visits;
+}
+
+/* RUNS PLAYOUTS ON ONE THREAD UNTIL THE PLAYOUTS ARE USED UP OR THE ARENA IS FULL */
+void MonteCarloSearch::runPlayouts(atomic<uint64_t>& remaining, atomic<uint64_t>& completed, atomic<bool>& arenaFull, uint64_t seed) {
+    ChessGame game;
+    game.setConsoleOutput(false);
+    game.restorePosition(rootPosition);
+    uint64_t randomState = seed | 1;
+
+    Node* arena = arenas[activeArena].get();
+    Node* path[maxTreeDepth + 1];
+    PieceColour movers[maxTreeDepth + 1]; // The side that made the move into each node on the path
+    ChessGame::MoveUndo undos[maxTreeDepth];
+
+    while (!arenaFull) {
+        // Claim a playout
+        uint64_t claimed = remaining.load();
+        do {
+            if (claimed == 0) {
+                return;
+            }
+        } while (!remaining.compare_exchange_weak(claimed, claimed - 1));
+
+        // SELECTION AND EXPANSION: descend by upper confidence bound, adding a virtual loss (a visit
+        // without a result) to each node, until reaching a node that has not been expanded
+        Node* node = &arena[0];
+        node->visits++;
+        path[0] = node;
+        int depth = 0;
+        PlayoutResult result = playoutContinues;
+        bool expandedHere = false;
+
+        while (depth < maxTreeDepth) {
+            uint8_t state = node->state.load(memory_order_acquire);
+            if (state == unexpanded && !expandedHere) {
+                uint8_t expected = unexpanded;
+                if (node->state.compare_exchange_strong(expected, expanding)) {
+                    if (!expand(*node, game)) {
+                        node->state.store(unexpanded, memory_order_release);
+                        arenaFull = true;
+                        break;
+                    }
+                    state = expanded;
+                    expandedHere = true;
+                }
+            }
+            if (state != expanded) { // Another thread is expanding this node, or this playout has expanded one
+                break;
+            }
+            if (node->childCount == 0) { // Checkmate, stalemate or a draw
+                result = static_cast<PlayoutResult>(node->terminalResult);
+                break;
+            }
+
+            Node& child = selectChild(*node);
+            child.visits++;
+            movers[depth + 1] = game.getTurn();
+            game.makeLegalMove(child.move, undos[depth]);
+            path[++depth] = node = &child;
+            if (expandedHere) { // Expand one node per playout, then play out from one of its children
+                break;
+            }
+        }
+
+        // SIMULATION
+        if (result == playoutContinues) {
+            result = playout(game, randomState);
+        }
+
+        // BACKPROPAGATION: each node scores the result for the side that moved into it
+        for (int index = depth; index >= 1; index--) {
+            uint32_t points = (result == playoutDrawn ? 1 : (result == static_cast<PlayoutResult>(movers[index]) ? 2 : 0));
+            path[index]->halfPoints += points;
+            game.unmakeLegalMove(undos[index - 1]);
+        }
+        completed++;
+    }
+}
+
+/* EXPANDS A NODE, ALLOCATING A CHILD FOR EVERY LEGAL MOVE */
+bool MonteCarloSearch::expand(Node& node, ChessGame& game) {
+    Move moveList[maxLegalMoves];
+    int count = game.generateLegalMoves(moveList);
+
+    PlayoutResult result = gameResult(game, count);
+    if (result != playoutContinues) {
+        node.terminalResult = result;
+        node.childCount = 0;
+        node.state.store(expanded, memory_order_release);
+        return true;
+    }
+
+    size_t first = nodesUsed.fetch_add(count);
+    if (first + count > capacity) {
+        return false;
+    }
+    Node* arena = arenas[activeArena].get();
+    for (int index = 0; index < count; index++) {
+        resetNode(arena[first + index], moveList[index]);
+    }
+    node.firstChild = first;
+    node.childCount = count;
+    node.state.store(expanded, memory_order_release);
+    return true;
+}
+
+/* SELECTS THE CHILD WITH THE GREATEST UPPER CONFIDENCE BOUND */
+MonteCarloSearch::Node& MonteCarloSearch::selectChild(const Node& node) {
+    Node* children = &arenas[activeArena][node.firstChild];
+    double logVisits = log(max<uint32_t>(node.visits.load(memory_order_relaxed), 1));
+
+    Node* best = &children[0];
+    double bestBound = -1;
+    for (int index = 0; index < node.childCount; index++) {
+        uint32_t visits = children[index].visits.load(memory_order_relaxed);
+        if (visits == 0) { // Try every move once first
+            return children[index];
+        }
+        double bound = children[index].halfPoints.load(memory_order_relaxed) / (2.0 * visits) +
+                       explorationConstant * sqrt(logVisits / visits);
+        if (bound > bestBound) {
+            bestBound = bound;
+            best = &children[index];
+        }
+    }
+    return *best;
+}
+
+/* PLAYS RANDOM MOVES UNTIL THE GAME ENDS, THEN TAKES THEM BACK */
+MonteCarloSearch::PlayoutResult MonteCarloSearch::playout(ChessGame& game, uint64_t& randomState) {
+    ChessGame::MoveUndo undos[maxPlayoutPlies];
+    int plies = 0;
+    PlayoutResult result = playoutContinues;
+
+    while (plies < maxPlayoutPlies) {
+        Move moveList[maxLegalMoves];
+        int count = game.generateLegalMoves(moveList);
+        result = gameResult(game, count);
+        if (result != playoutContinues) {
+            break;
+        }
+
+        if (policy == capturePreferringPlayouts) { // Keep only the captures and promotions, if there are any
+            int tacticalCount = 0;
+            for (int index = 0; index < count; index++) {
+                Move move = moveList[index];
+                const ChessPiece* piece = game.chessBoard[move.getOrigin() / 8][move.getOrigin() % 8];
+                bool capture = (game.chessBoard[move.getDestination() / 8][move.getDestination() % 8] != nullptr ||
+                                (piece->getType() == pawn && move.getOrigin() % 8 != move.getDestination() % 8));
+                if (capture || move.getPromotion() != noPromotion) {
+                    moveList[tacticalCount++] = move;
+                }
+            }
+            count = (tacticalCount > 0 ? tacticalCount : count);
+        }
+        game.makeLegalMove(moveList[nextRandom(randomState) % count], undos[plies++]);
+    }
+
+    while (plies > 0) {
+        game.unmakeLegalMove(undos[--plies]);
+    }
+    return (result == playoutContinues ? playoutDrawn : result); // A game that runs too long is scored as a draw
+}
+
+/* DETERMINES THE RESULT OF A FINISHED GAME, AS detectGameState() WOULD */
+MonteCarloSearch::PlayoutResult MonteCarloSearch::gameResult(ChessGame& game, int legalMoveCount) {
+    if (legalMoveCount == 0) { // Checkmate or stalemate
+        if (!game.activeColourInCheck()) {
+            return playoutDrawn;
+        }
+        return (game.getTurn() == white ? playoutBlackWins : playoutWhiteWins);
+    }
+    if (game.getHalfMoveCounter() >= 100) { // Draw by the 50-move rule
+        return playoutDrawn;
+    }
+    return playoutContinues;
+}
+
+/* INITIALISES AN ARENA NODE */
+void MonteCarloSearch::resetNode(Node& node, Move move) {
+    node.visits.store(0, memory_order_relaxed);
+    node.halfPoints.store(0, memory_order_relaxed);
+    node.state.store(unexpanded, memory_order_relaxed);
+    node.terminalResult = playoutContinues;
+    node.move = move;
+    node.childCount = 0;
+    node.firstChild = 0;
+}
@@ -0,0 +1,188 @@
+/*
+ * MonteCarloSearch.h - Header file for the MonteCarloSearch class, a multithreaded
+ * UCT (upper confidence bounds applied to trees) search with random playouts, whose
+ * nodes are allocated from a fixed arena and kept between moves.
+ */
+
+#ifndef MONTECARLOSEARCH_H
+#define MONTECARLOSEARCH_H
+
+#include "ChessGame.h"
+#include "Move.h"
+#include "Position.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/*
+ * Enum representing how moves are chosen during a playout.
+ */
+enum PlayoutPolicy {
+    randomPlayouts, // Every legal move is equally likely
+    capturePreferringPlayouts // A capture or promotion is chosen whenever one is available, otherwise any move
+};
+
+/*
+ * Counters describing a run of the search.
+ */
+struct MonteCarloStatistics {
+    uint64_t playouts = 0; // The number of playouts completed
+    double seconds = 0; // The time taken
+    size_t nodesUsed = 0; // The number of arena nodes in use afterwards (including any reused tree)
+    bool arenaFull = false; // Indicates that the search stopped early because the arena ran out of nodes
+};
+
+
+/****************************** Class MonteCarloSearch ******************************/
+
+class MonteCarloSearch final {
+
+    public:
+        /*
+         * Parameterised constructor which allocates the node arena up front. Nodes are never freed
+         * individually; the arena is reset or compacted between searches.
+         *
+         * @param nodeCapacity The number of nodes in the arena.
+         * @param policy How moves are chosen during playouts.
+         */
+        MonteCarloSearch(size_t nodeCapacity, PlayoutPolicy policy = randomPlayouts);
+
+        MonteCarloSearch(const MonteCarloSearch&) = delete;
+        MonteCarloSearch& operator=(const MonteCarloSearch&) = delete;
+
+        /*
+         * Sets the position to search from, discarding the tree.
+         *
+         * @param position The position (see ChessGame::savePosition()).
+         */
+        void setPosition(const Position& position);
+
+        /*
+         * Advances the root by a move (played by either side), keeping the subtree beneath that move
+         * so that its statistics are reused by the next search. The subtree is copied to the front of
+         * a second arena, which then becomes the active arena, so the nodes of discarded lines are freed.
+         *
+         * @param move The move played (legal in the root position).
+         */
+        void advance(Move move);
+
+        /*
+         * Runs playouts from the root on a number of threads, which share the tree. Each thread
+         * applies a virtual loss to the nodes it is descending through, so that concurrent threads
+         * spread across different lines instead of expanding the same one.
+         *
+         * @param playouts The number of playouts to run (in total across threads).
+         * @param threadCount The number of threads (zero selects one per hardware thread).
+         * @param seed The seed of the random playouts (each thread derives its own sequence from it).
+         *
+         * @return The number of playouts run, the time taken and the arena usage.
+         */
+        MonteCarloStatistics search(uint64_t playouts, unsigned threadCount = 0, uint64_t seed = 1);
+
+        /*
+         * Obtains the most visited move at the root.
+         *
+         * @return The most visited move (the null move if the root has not been expanded or has no legal moves).
+         */
+        Move bestMove() const;
+
+        /*
+         * Getter function for the number of playouts that have passed through the root, including
+         * those of earlier searches reused by advance().
+         *
+         * @return The number of visits of the root.
+         */
+        uint32_t getRootVisits() const;
+
+    private:
+        /*
+         * A node of the tree: a position reached by a move, with the statistics of the playouts through it.
+         */
+        struct Node {
+            std::atomic<uint32_t> visits; // Playouts through the node, including those still running (virtual loss)
+            std::atomic<uint32_t> halfPoints; // Two per win, one per draw, for the side that made 'move'
+            std::atomic<uint8_t> state; // The NodeState of the node
+            uint8_t terminalResult; // The PlayoutResult of a position with no legal moves, or drawn by the 50-move rule
+            Move move; // The move leading to the node (the null move at the root)
+            uint16_t childCount; // The number of children (valid once expanded)
+            uint32_t firstChild; // The arena index of the first child; the children are contiguous
+        };
+
+        /*
+         * Enum representing how far a node has been expanded.
+         */
+        enum NodeState : uint8_t {unexpanded, expanding, expanded};
+
+        /*
+         * Enum representing the result of a playout. It is not the recorded GameResult of GameRecord.h:
+         * the wins are in PieceColour order, so that a colour converts directly to its own win.
+         */
+        enum PlayoutResult : uint8_t {playoutWhiteWins, playoutBlackWins, playoutDrawn, playoutContinues};
+
+        std::unique_ptr<Node[]> arenas[2]; // The two node arenas (one active, one used when compacting)
+        size_t capacity; // The number of nodes in each arena
+        int activeArena = 0; // The arena holding the tree
+        std::atomic<size_t> nodesUsed; // The number of nodes allocated in the active arena
+        Position rootPosition; // The position at the root
+        PlayoutPolicy policy; // How moves are chosen during playouts
+
+        /*
+         * Runs playouts on one thread until the shared playout count is used up or the arena is full.
+         *
+         * @param remaining The number of playouts still to be claimed by any thread.
+         * @param completed The number of playouts completed by every thread.
+         * @param arenaFull Set by the first thread to find the arena full, which stops every thread.
+         * @param seed The seed of this thread's random playouts.
+         */
+        void runPlayouts(std::atomic<uint64_t>& remaining, std::atomic<uint64_t>& completed, std::atomic<bool>& arenaFull, uint64_t seed);
+
+        /*
+         * Expands a node claimed by this thread, allocating a child for every legal move.
+         *
+         * @param node The node to expand.
+         * @param game The game, in the position of the node.
+         *
+         * @return false if the arena has no room for the children; true otherwise.
+         */
+        bool expand(Node& node, ChessGame& game);
+
+        /*
+         * Selects the child of an expanded node with the greatest upper confidence bound. A child
+         * that has never been visited is selected first.
+         *
+         * @param node The expanded node.
+         * @return The child selected.
+         */
+        Node& selectChild(const Node& node);
+
+        /*
+         * Plays random moves from the current position of a game until the game ends, then takes them back.
+         *
+         * @param game The game to play out.
+         * @param randomState The state of this thread's random number generator.
+         *
+         * @return The result of the game.
+         */
+        PlayoutResult playout(ChessGame& game, uint64_t& randomState);
+
+        /*
+         * Determines the result of a position with no legal moves or drawn by the 50-move rule.
+         *
+         * @param game The game, in the position to score.
+         * @param legalMoveCount The number of legal moves in the position.
+         *
+         * @return The result, or playoutContinues if the game continues.
+         */
+        static PlayoutResult gameResult(ChessGame& game, int legalMoveCount);
+
+        /*
+         * Initialises an arena node.
+         *
+         * @param node The node to initialise.
+         * @param move The move leading to the node.
+         */
+        static void resetNode(Node& node, Move move);
+};
+
+#endif
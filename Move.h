@@ -0,0 +1,150 @@
+/*
+ * Move.h - Header file for the compact 16-bit Move type used to submit,
+ * store and replay moves.
+ */
+
+#ifndef MOVE_H
+#define MOVE_H
+
+#include "Enums.h"
+#include <cstdint>
+
+// An upper bound on the number of legal moves in any position (the known maximum is 218)
+const int maxLegalMoves = 256;
+
+/*
+ * Enum representing the piece that a pawn promotes to, stored in the flag bits of a Move.
+ */
+enum Promotion {noPromotion, promoteToKnight, promoteToBishop, promoteToRook, promoteToQueen};
+
+/*
+ * A move packed into 16 bits:  bits 0-5   origin square      (rank * 8 + file, zero indexed)
+ *                              bits 6-11  destination square (rank * 8 + file, zero indexed)
+ *                              bits 12-15 flags              (the Promotion of a pawn, if any)
+ *
+ * Castling and en passant are not flagged; as with letter-integer coordinates, they are
+ * identified from the position when the move is submitted. The all-zero value (A1 to A1)
+ * is never a legal move and is used as the null move.
+ */
+class Move {
+
+    public:
+        /*
+         * Default constructor for the null move.
+         */
+        constexpr Move() : data(0) {}
+
+        /*
+         * Parameterised constructor for a move between two squares.
+         *
+         * @param origin The index (rank * 8 + file) of the square occupied by the piece to move.
+         * @param destination The index (rank * 8 + file) of the destination square.
+         * @param promotion The piece that a pawn promotes to (noPromotion for any other move).
+         */
+        constexpr Move(int origin, int destination, Promotion promotion = noPromotion)
+        : data(static_cast<uint16_t>(origin | (destination << 6) | (promotion << 12))) {}
+
+        /*
+         * Parses a move from letter-integer coordinates (e.g. "E2", "E4"). The coordinates
+         * are assumed to be in-bounds.
+         *
+         * @param stringCoord1 The string literal letter-integer coordinates of the piece to move.
+         * @param stringCoord2 The string literal letter-integer coordinates of the destination square.
+         * @param promotion The piece that a pawn promotes to (noPromotion for any other move).
+         *
+         * @return The move between the two squares.
+         */
+        static Move fromStrings(const char* stringCoord1, const char* stringCoord2, Promotion promotion = noPromotion) {
+            return Move((stringCoord1[1] - '1') * 8 + (stringCoord1[0] - 'A'),
+                        (stringCoord2[1] - '1') * 8 + (stringCoord2[0] - 'A'), promotion);
+        }
+
+        /*
+         * Unpacks a move from its 16-bit encoding.
+         *
+         * @param raw The 16-bit encoding of the move.
+         *
+         * @return The decoded move.
+         */
+        static constexpr Move fromRaw(uint16_t raw) {
+            Move move;
+            move.data = raw;
+            return move;
+        }
+
+        /* @return The 16-bit encoding of the move. */
+        constexpr uint16_t getRaw() const { return data; }
+
+        /* @return The index (rank * 8 + file) of the origin square. */
+        constexpr int getOrigin() const { return data & 0x3F; }
+
+        /* @return The index (rank * 8 + file) of the destination square. */
+        constexpr int getDestination() const { return (data >> 6) & 0x3F; }
+
+        /* @return The piece that a pawn promotes to (noPromotion for any other move). */
+        constexpr Promotion getPromotion() const { return static_cast<Promotion>(data >> 12); }
+
+        /* @return true if this is the null move. */
+        constexpr bool isNull() const { return data == 0; }
+
+        /*
+         * Writes the origin and destination squares as letter-integer coordinates (e.g. "E2").
+         *
+         * @param stringCoord1 A buffer of at least three characters for the origin square.
+         * @param stringCoord2 A buffer of at least three characters for the destination square.
+         */
+        void toStrings(char* stringCoord1, char* stringCoord2) const {
+            stringCoord1[0] = 'A' + getOrigin() % 8;
+            stringCoord1[1] = '1' + getOrigin() / 8;
+            stringCoord1[2] = '\0';
+            stringCoord2[0] = 'A' + getDestination() % 8;
+            stringCoord2[1] = '1' + getDestination() / 8;
+            stringCoord2[2] = '\0';
+        }
+
+        constexpr bool operator==(const Move& other) const { return data == other.data; }
+        constexpr bool operator!=(const Move& other) const { return data != other.data; }
+
+    private:
+        uint16_t data; // The packed origin, destination and flags
+};
+
+/*
+ * A square, written to an output stream as letter-integer coordinates (e.g. "E2"), so that
+ * messages about a move can name its squares without formatting them into strings.
+ */
+struct SquareName {
+    int rank, file; // Zero indexed
+
+    /*
+     * Parameterised constructor for the square at a pair of coordinates.
+     *
+     * @param coord An integer array of length two containing zero-indexed coordinates (rank, file) of the square.
+     */
+    explicit SquareName(const int* coord) : rank(coord[0]), file(coord[1]) {}
+};
+
+inline std::ostream &operator<<(std::ostream& os, SquareName name) {
+    return os << static_cast<char>('A' + name.file) << static_cast<char>('1' + name.rank);
+}
+
+/*
+ * Converts a Promotion into the type of piece that the pawn becomes.
+ *
+ * @param promotion The promotion flag of a move (noPromotion is treated as a queen).
+ * @return The type of the promoted piece.
+ */
+inline PieceType promotionPieceType(Promotion promotion) {
+    switch (promotion) {
+        case promoteToKnight:
+            return knight;
+        case promoteToBishop:
+            return bishop;
+        case promoteToRook:
+            return rook;
+        default:
+            return queen;
+    }
+}
+
+#endif
@@ -0,0 +1,107 @@
+/*
+ * MoveCache.cpp - Implementation file for the MoveCache class, a bounded concurrent
+ * cache of the legal moves and game state of positions, shared between games.
+ */
+
+#include "MoveCache.h"
+#include <algorithm>
+
+using namespace std;
+
+
+/****************************** CachedPosition - Member Function Definitions ******************************/
+
+/* DETERMINES WHETHER A MOVE IS LEGAL BY BINARY SEARCH OF THE SORTED MOVES */
+bool CachedPosition::containsMove(Move move) const {
+    const Move* end = moves + moveCount;
+    const Move* found = lower_bound(moves, end, move, [](const Move& move1, const Move& move2) { return move1.getRaw() < move2.getRaw(); });
+    return found != end && *found == move;
+}
+
+
+/****************************** MoveCacheStatistics - Member Function Definitions ******************************/
+
+/* RETURNS THE FRACTION OF LOOKUPS THAT FOUND THE POSITION */
+double MoveCacheStatistics::hitRate() const {
+    uint64_t lookups = hits + misses;
+    return (lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups);
+}
+
+
+/****************************** MoveCache - Member Function Definitions ******************************/
+
+/* CONSTRUCTOR - PREALLOCATES EVERY SEGMENT */
+MoveCache::MoveCache(size_t capacity, unsigned segmentCount) : hits(0), misses(0), insertions(0), evictions(0) {
+    segmentCount = max(segmentCount, 1u);
+    slotsPerSegment = max<size_t>(capacity / segmentCount, 1);
+
+    for (unsigned index = 0; index < segmentCount; index++) {
+        unique_ptr<Segment> segment = make_unique<Segment>();
+        segment->slots.resize(slotsPerSegment);
+        segment->referenced.assign(slotsPerSegment, 0);
+        segment->slotOf.reserve(slotsPerSegment);
+        segments.push_back(move(segment));
+    }
+}
+
+/* LOOKS UP A POSITION AND MARKS IT AS RECENTLY USED */
+bool MoveCache::find(uint64_t hash, CachedPosition& position) {
+    Segment& segment = segmentFor(hash);
+    {
+        lock_guard<mutex> lock(segment.mutex);
+        auto slot = segment.slotOf.find(hash);
+        if (slot != segment.slotOf.end()) {
+            segment.referenced[slot->second] = 1;
+            position = segment.slots[slot->second];
+            hits.fetch_add(1, memory_order_relaxed);
+            return true;
+        }
+    }
+    misses.fetch_add(1, memory_order_relaxed);
+    return false;
+}
+
+/* ADDS A POSITION, EVICTING BY CLOCK IF THE SEGMENT IS FULL */
+void MoveCache::insert(const CachedPosition& position) {
+    Segment& segment = segmentFor(position.hash);
+    lock_guard<mutex> lock(segment.mutex);
+
+    uint32_t slot;
+    auto existing = segment.slotOf.find(position.hash);
+
+    if (existing != segment.slotOf.end()) { // Already cached (e.g. inserted concurrently by another game)
+        slot = existing->second;
+    }
+    else if (segment.slotOf.size() < slotsPerSegment) { // Free slots are filled in order
+        slot = segment.slotOf.size();
+        segment.slotOf[position.hash] = slot;
+    }
+    else { // Sweep the clock hand, giving referenced positions a second chance
+        while (segment.referenced[segment.clockHand]) {
+            segment.referenced[segment.clockHand] = 0;
+            segment.clockHand = (segment.clockHand + 1) % slotsPerSegment;
+        }
+        slot = segment.clockHand;
+        segment.clockHand = (segment.clockHand + 1) % slotsPerSegment;
+
+        // Reuse the evicted position's index entry, so that a full segment never allocates
+        auto entry = segment.slotOf.extract(segment.slots[slot].hash);
+        entry.key() = position.hash;
+        segment.slotOf.insert(move(entry));
+        evictions.fetch_add(1, memory_order_relaxed);
+    }
+
+    segment.slots[slot] = position;
+    segment.referenced[slot] = 0;
+    insertions.fetch_add(1, memory_order_relaxed);
+}
+
+/* RETURNS A SNAPSHOT OF THE USAGE COUNTERS */
+MoveCacheStatistics MoveCache::getStatistics() const {
+    return {hits.load(), misses.load(), insertions.load(), evictions.load()};
+}
+
+/* RETURNS THE SEGMENT RESPONSIBLE FOR A HASH */
+MoveCache::Segment& MoveCache::segmentFor(uint64_t hash) {
+    return *segments[(hash >> 32) % segments.size()];
+}
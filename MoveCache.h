@@ -0,0 +1,137 @@
+/*
+ * MoveCache.h - Header file for the MoveCache class, a bounded concurrent cache
+ * of the legal moves and game state of positions, shared between games.
+ */
+
+#ifndef MOVECACHE_H
+#define MOVECACHE_H
+
+#include "Move.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Flags describing the game state of a position for the side to move.
+ */
+enum PositionStateFlags : uint8_t {
+    sideInCheck = 1, // The side to move is in check
+    sideCheckmated = 2, // The side to move is in check and has no legal moves
+    sideStalemated = 4, // The side to move is not in check and has no legal moves
+    sideDrawnByFiftyMoves = 8, // The side to move has legal moves but the 50-move rule has ended the game
+    positionInvalid = 128 // Set alone by ChessGame::classifyPosition() for a FEN string that is malformed or not playable
+    // NB: The move cache never stores sideDrawnByFiftyMoves, as the move counters are not part of the hash.
+};
+
+/*
+ * The legal moves and game state of a single position.
+ */
+struct CachedPosition {
+    uint64_t hash; // The Zobrist hash of the position (ChessGame::positionHash())
+    uint8_t stateFlags; // A combination of PositionStateFlags
+    uint16_t moveCount; // The number of legal moves
+    Move moves[maxLegalMoves]; // The legal moves, sorted by their 16-bit encoding
+
+    /*
+     * Determines whether a move is legal in this position.
+     *
+     * @param move The move to look up (promotions must carry their promotion flag).
+     *
+     * @return true if the move is one of the legal moves; false otherwise.
+     */
+    bool containsMove(Move move) const;
+};
+
+/*
+ * Counters describing how effective a MoveCache has been.
+ */
+struct MoveCacheStatistics {
+    uint64_t hits; // Lookups that found the position
+    uint64_t misses; // Lookups that did not find the position
+    uint64_t insertions; // Positions added to the cache
+    uint64_t evictions; // Positions removed to make room for others
+
+    /* @return The fraction of lookups that found the position (0 if there have been none). */
+    double hitRate() const;
+};
+
+
+/****************************** Class MoveCache ******************************/
+
+class MoveCache final {
+
+    public:
+        /*
+         * Parameterised constructor for a cache holding a bounded number of positions. The
+         * cache is split into independently locked segments (selected by hash) so that games
+         * on different threads rarely contend; each segment evicts with the CLOCK algorithm.
+         *
+         * @param capacity The maximum number of positions held across all segments.
+         * @param segmentCount The number of independently locked segments.
+         */
+        MoveCache(size_t capacity, unsigned segmentCount = 16);
+
+        MoveCache(const MoveCache&) = delete;
+        MoveCache& operator=(const MoveCache&) = delete;
+
+        /*
+         * Looks up a position, marking it as recently used if found.
+         *
+         * @param hash The Zobrist hash of the position.
+         * @param position A reference to copy the cached position into if found.
+         *
+         * @return true if the position was found; false otherwise.
+         */
+        bool find(uint64_t hash, CachedPosition& position);
+
+        /*
+         * Adds a position to the cache (replacing any existing entry with the same hash),
+         * evicting a position that has not been used recently if the segment is full. Memory
+         * is only allocated while a segment is filling; once it is full, insertions allocate nothing.
+         *
+         * @param position The position to add.
+         */
+        void insert(const CachedPosition& position);
+
+        /*
+         * Getter function for the cache's usage counters.
+         *
+         * @return A snapshot of the hit, miss, insertion and eviction counts.
+         */
+        MoveCacheStatistics getStatistics() const;
+
+    private:
+        /*
+         * An independently locked part of the cache holding a fixed number of slots.
+         */
+        struct Segment {
+            std::mutex mutex; // Guards every other member
+            std::vector<CachedPosition> slots; // The cached positions
+            std::vector<uint8_t> referenced; // CLOCK reference bits, set on every hit
+            std::unordered_map<uint64_t, uint32_t> slotOf; // The slot holding each cached hash
+            size_t clockHand = 0; // The next slot to consider for eviction
+        };
+
+        std::vector<std::unique_ptr<Segment>> segments; // The segments, indexed by the high bits of the hash
+        size_t slotsPerSegment; // The number of slots in each segment
+
+        std::atomic<uint64_t> hits; // Lookups that found the position
+        std::atomic<uint64_t> misses; // Lookups that did not find the position
+        std::atomic<uint64_t> insertions; // Positions added to the cache
+        std::atomic<uint64_t> evictions; // Positions removed to make room for others
+
+        /*
+         * Obtains the segment responsible for a hash.
+         *
+         * @param hash The Zobrist hash of a position.
+         *
+         * @return A reference to the segment.
+         */
+        Segment& segmentFor(uint64_t hash);
+};
+
+#endif
@@ -0,0 +1,245 @@
+/*
+ * PackedPosition.cpp - Implementation file for the packed position format.
+ */
+
+#include "PackedPosition.h"
+#include "Enums.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+static const char castlingCharacters[] = "KQkq"; // Indexed by bit of Position::castlingRights
+
+/* PACKS A POSITION */
+void packPosition(const Position& position, PackedPosition& packed) {
+    uint8_t* bytes = packed.bytes;
+    memset(bytes, 0, packedPositionSize);
+
+    uint64_t occupancy = 0;
+    int pieceIndex = 0;
+    for (int square = 0; square < 64; square++) {
+        char piece = position.squares[square];
+        if (piece == '\0') {
+            continue;
+        }
+        uint8_t code = static_cast<uint8_t>(pieceTypeOf(piece) | (piece >= 'a' ? 8 : 0));
+        occupancy |= uint64_t(1) << square;
+        bytes[8 + pieceIndex / 2] |= static_cast<uint8_t>(code << (4 * (pieceIndex % 2)));
+        pieceIndex++;
+    }
+    for (int index = 0; index < 8; index++) {
+        bytes[index] = static_cast<uint8_t>(occupancy >> (8 * index));
+    }
+
+    bytes[24] = static_cast<uint8_t>((position.turn == black ? 1 : 0) | ((position.castlingRights & 0xF) << 1));
+    bytes[25] = (position.enPassantSquare == -1 ? 0xFF : static_cast<uint8_t>(position.enPassantSquare));
+    bytes[26] = static_cast<uint8_t>(min<int>(position.halfMoveCounter, 255));
+    bytes[30] = static_cast<uint8_t>(position.fullMoveCounter & 0xFF);
+    bytes[31] = static_cast<uint8_t>(position.fullMoveCounter >> 8);
+}
+
+/* UNPACKS A POSITION */
+bool unpackPosition(const PackedPosition& packed, Position& position) {
+    const uint8_t* bytes = packed.bytes;
+    memset(position.squares, 0, sizeof(position.squares));
+
+    uint64_t occupancy = 0;
+    for (int index = 0; index < 8; index++) {
+        occupancy |= static_cast<uint64_t>(bytes[index]) << (8 * index);
+    }
+    int pieceCount = __builtin_popcountll(occupancy);
+    if (pieceCount > 32) {
+        return false;
+    }
+    for (int pieceIndex = 0; pieceIndex < 32; pieceIndex++) {
+        uint8_t code = (bytes[8 + pieceIndex / 2] >> (4 * (pieceIndex % 2))) & 0xF;
+        if (pieceIndex >= pieceCount) {
+            if (code != 0) { // Unused nibbles are zero
+                return false;
+            }
+            continue;
+        }
+        if ((code & 7) > king) {
+            return false;
+        }
+        int square = __builtin_ctzll(occupancy);
+        occupancy &= occupancy - 1;
+        position.squares[square] = pieceAbbrName(static_cast<PieceColour>(code >> 3), static_cast<PieceType>(code & 7));
+    }
+
+    position.turn = (bytes[24] & 1 ? black : white);
+    position.castlingRights = (bytes[24] >> 1) & 0xF;
+    position.enPassantSquare = (bytes[25] == 0xFF ? -1 : static_cast<int8_t>(bytes[25] & 63));
+    position.statusFlags = positionLoaded | positionStateStale;
+    position.halfMoveCounter = bytes[26];
+    position.fullMoveCounter = static_cast<uint16_t>(bytes[30] | (bytes[31] << 8));
+    return (bytes[24] >> 5) == 0 && (bytes[25] == 0xFF || bytes[25] < 64);
+}
+
+/*
+ * Parses a counter of one to five digits followed by the given terminator, which must fit in 16 bits.
+ */
+static bool parseCounter(const char*& next, char terminator, uint16_t& counter) {
+    unsigned value = 0;
+    int digits = 0;
+    for (; *next >= '0' && *next <= '9' && digits <= 5; next++, digits++) {
+        value = value * 10 + (*next - '0');
+    }
+    counter = static_cast<uint16_t>(value);
+    return digits > 0 && digits <= 5 && value <= 0xFFFF && *next++ == terminator;
+}
+
+/* PARSES A FEN STRING, CHECKING THAT IT IS WELL FORMED */
+bool parseFen(const char* fenString, Position& position) {
+    memset(position.squares, 0, sizeof(position.squares));
+    const char* next = fenString;
+
+    // PART 1: BOARD ARRANGEMENT
+    int pieces[2] = {0, 0}, kings[2] = {0, 0};
+    for (int rank = 7; rank >= 0; rank--) {
+        int file = 0;
+        while (file < 8) {
+            char character = *next++;
+            if (character >= '1' && character <= '8') {
+                file += character - '0';
+                continue;
+            }
+            int type = pieceTypeOf(character);
+            if (type < 0) {
+                return false;
+            }
+            if (type == pawn && (rank == 0 || rank == 7)) {
+                return false;
+            }
+            int colour = (character >= 'a' ? black : white);
+            pieces[colour]++;
+            kings[colour] += (type == king);
+            position.squares[rank * 8 + file++] = character;
+        }
+        if (file != 8 || *next++ != (rank > 0 ? '/' : ' ')) {
+            return false;
+        }
+    }
+    if (pieces[white] > 16 || pieces[black] > 16 || kings[white] != 1 || kings[black] != 1) {
+        return false;
+    }
+
+    // PART 2: ACTIVE COLOUR
+    if ((*next != 'w' && *next != 'b') || next[1] != ' ') {
+        return false;
+    }
+    position.turn = (*next == 'b' ? black : white);
+    next += 2;
+
+    // PART 3: CASTLING RIGHTS
+    position.castlingRights = 0;
+    if (*next == '-') {
+        next++;
+    }
+    else {
+        for (; *next != ' ' && *next != '\0'; next++) {
+            const char* found = strchr(castlingCharacters, *next);
+            if (found == nullptr || (position.castlingRights & (1 << (found - castlingCharacters)))) {
+                return false;
+            }
+            position.castlingRights |= static_cast<uint8_t>(1 << (found - castlingCharacters));
+        }
+        if (position.castlingRights == 0) {
+            return false;
+        }
+    }
+    if (*next++ != ' ') {
+        return false;
+    }
+
+    // PART 4: EN PASSANT SQUARE
+    if (*next == '-') {
+        position.enPassantSquare = -1;
+        next++;
+    }
+    else if (*next >= 'a' && *next <= 'h' && (next[1] == '3' || next[1] == '6')) {
+        position.enPassantSquare = static_cast<int8_t>((next[1] - '1') * 8 + (*next - 'a'));
+        next += 2;
+    }
+    else {
+        return false;
+    }
+
+    // PARTS 5 AND 6: HALF-MOVE AND FULL-MOVE COUNTERS
+    position.statusFlags = positionLoaded | positionStateStale;
+    position.halfMoveCounter = 0;
+    position.fullMoveCounter = 1;
+    if (*next == '\0') {
+        return true;
+    }
+    next++;
+    return next[-1] == ' ' && parseCounter(next, ' ', position.halfMoveCounter)
+        && parseCounter(next, '\0', position.fullMoveCounter);
+}
+
+/*
+ * Writes a space and then a counter in decimal, returning the position after its last digit.
+ */
+static char* formatCounter(char* next, unsigned counter) {
+    char digits[5];
+    int count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + counter % 10);
+        counter /= 10;
+    } while (counter > 0);
+    *next++ = ' ';
+    while (count > 0) {
+        *next++ = digits[--count];
+    }
+    return next;
+}
+
+/* WRITES A POSITION AS A FULL FEN STRING */
+size_t formatFen(const Position& position, char* fenString) {
+    char* next = fenString;
+    for (int rank = 7; rank >= 0; rank--) {
+        int emptySquares = 0;
+        for (int file = 0; file < 8; file++) {
+            char piece = position.squares[rank * 8 + file];
+            if (piece == '\0') {
+                emptySquares++;
+                continue;
+            }
+            if (emptySquares > 0) {
+                *next++ = static_cast<char>('0' + emptySquares);
+                emptySquares = 0;
+            }
+            *next++ = piece;
+        }
+        if (emptySquares > 0) {
+            *next++ = static_cast<char>('0' + emptySquares);
+        }
+        *next++ = (rank > 0 ? '/' : ' ');
+    }
+
+    *next++ = (position.turn == black ? 'b' : 'w');
+    *next++ = ' ';
+    if ((position.castlingRights & 0xF) == 0) {
+        *next++ = '-';
+    }
+    for (int right = 0; right < 4; right++) {
+        if (position.castlingRights & (1 << right)) {
+            *next++ = castlingCharacters[right];
+        }
+    }
+    *next++ = ' ';
+    if (position.enPassantSquare == -1) {
+        *next++ = '-';
+    }
+    else {
+        *next++ = static_cast<char>('a' + position.enPassantSquare % 8);
+        *next++ = static_cast<char>('1' + position.enPassantSquare / 8);
+    }
+
+    // Both counters fit in five digits, so the longest FEN string is within maxFenLength
+    next = formatCounter(next, position.halfMoveCounter);
+    next = formatCounter(next, position.fullMoveCounter);
+    *next = '\0';
+    return static_cast<size_t>(next - fenString);
+}
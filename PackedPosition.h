@@ -0,0 +1,90 @@
+/*
+ * PackedPosition.h - Header file for the packed position format, a canonical fixed-size binary
+ * encoding of a chess position for bulk storage, which loads much faster than a FEN string.
+ *
+ * A packed position is 32 bytes, laid out as:
+ *
+ *     8-byte occupancy: bit (rank * 8 + file) set for each occupied square
+ *     16 bytes of 4-bit piece codes, one per occupied square in increasing square order (low
+ *         nibble first, unused nibbles zero): the PieceType, plus 8 for a black piece
+ *     1-byte state: bit 0 set if black is to move, bits 1-4 the castling rights (white
+ *         kingside, white queenside, black kingside, black queenside), bits 5-7 zero
+ *     1-byte en passant square (rank * 8 + file), or 0xFF if none
+ *     1-byte half-move counter (saturating at 255)
+ *     3 bytes free for the use of formats embedding packed positions (zero as packed, ignored as unpacked)
+ *     2-byte full-move counter
+ *
+ * All multi-byte integers are little-endian. Every position has exactly one packing, so packed
+ * positions can be compared and hashed bytewise (once the free bytes are cleared).
+ */
+
+#ifndef PACKEDPOSITION_H
+#define PACKEDPOSITION_H
+
+#include "Position.h"
+#include <cstddef>
+#include <cstdint>
+
+// The size of a packed position in bytes
+const size_t packedPositionSize = 32;
+
+// The offset of the bytes of a packed position free for the use of formats embedding it, and their number
+const size_t packedFreeOffset = 27;
+const size_t packedFreeSize = 3;
+
+// The greatest length of a FEN string written by formatFen() (excluding the terminating null)
+const size_t maxFenLength = 96;
+
+/*
+ * A position in the packed position format.
+ */
+struct PackedPosition {
+    uint8_t bytes[packedPositionSize]; // The packed bytes
+};
+
+static_assert(sizeof(PackedPosition) == packedPositionSize, "PackedPosition must have no padding");
+
+/*
+ * Packs a position.
+ *
+ * @param position The position to pack (holding at most 32 pieces).
+ * @param packed A reference to store the packed position in.
+ */
+void packPosition(const Position& position, PackedPosition& packed);
+
+/*
+ * Unpacks a position, without checking that it could arise in a game.
+ *
+ * @param packed The packed position.
+ * @param position A reference to store the position in (with statusFlags positionLoaded | positionStateStale,
+ *                 so that the game state is evaluated when first queried after it is restored).
+ *
+ * @return true if the packing is well formed (valid piece codes, zero unused nibbles and state bits); false otherwise.
+ */
+bool unpackPosition(const PackedPosition& packed, Position& position);
+
+/*
+ * Parses a FEN string into a position, checking that it is well formed: eight ranks of eight
+ * squares, at most 16 pieces and exactly one king of each colour, no pawn on the first or last
+ * rank (where the engine cannot move it), and valid active colour, castling rights and en
+ * passant fields. The counters may be omitted (as in a short notation FEN string), in which case
+ * they are 0 and 1. Whether the position could arise in a game is not checked.
+ *
+ * @param fenString The null-terminated FEN string (with single spaces between fields).
+ * @param position A reference to store the position in (with statusFlags positionLoaded | positionStateStale).
+ *
+ * @return true if the FEN string is well formed; false otherwise (leaving the position unspecified).
+ */
+bool parseFen(const char* fenString, Position& position);
+
+/*
+ * Writes a position as a full FEN string.
+ *
+ * @param position The position.
+ * @param fenString An array of at least maxFenLength + 1 characters to store the null-terminated FEN string in.
+ *
+ * @return The length of the FEN string.
+ */
+size_t formatFen(const Position& position, char* fenString);
+
+#endif
@@ -0,0 +1,218 @@
+/*
+ * PackedPositionTool.cpp - Command line tool to convert corpora of positions between FEN or EPD
+ * text and the packed position format (see PackedPosition.h).
+ *
+ * pack: reads a file of FEN strings or EPD records, one per line (blank lines and lines starting
+ * with '#' are skipped), and writes each position as a 32-byte packed position. An EPD record's
+ * first four fields are the position; its fifth and sixth fields are taken as the counters only
+ * if both are numbers (its operations are dropped). Malformed lines are reported and skipped.
+ *
+ * unpack: reads a file of packed positions and writes each as a full FEN string on its own line.
+ *
+ * Both stream their files in large blocks, so a conversion runs at close to disk speed, and
+ * report how many positions were converted and how fast.
+ *
+ * Usage: packpos pack <FEN/EPD file> <packed file>
+ *        packpos unpack <packed file> <FEN file>
+ */
+
+#include "PackedPosition.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+static const size_t blockSize = 1 << 20; // The number of bytes read or written at once
+static const size_t maxLineLength = 4096; // Longer lines are malformed (FEN strings are under 100 characters)
+static const int maxInvalidListed = 20;
+
+/*
+ * Converts a line holding a FEN string or an EPD record into a full FEN string, normalising the
+ * whitespace between fields.
+ *
+ * @return false if the line has fewer than four fields; true otherwise.
+ */
+static bool normaliseLine(const char* line, size_t length, string& fen) {
+    const char* fields[6];
+    size_t lengths[6];
+    int fieldCount = 0;
+    for (size_t index = 0; index < length && fieldCount < 6;) {
+        if (line[index] == ' ' || line[index] == '\t') {
+            index++;
+            continue;
+        }
+        size_t start = index;
+        while (index < length && line[index] != ' ' && line[index] != '\t') {
+            index++;
+        }
+        fields[fieldCount] = line + start;
+        lengths[fieldCount++] = index - start;
+    }
+    if (fieldCount < 4) {
+        return false;
+    }
+
+    // Fields five and six are the counters of a FEN string, or the first operations of an EPD record
+    int usedFields = 6;
+    for (int field = 4; field < 6; field++) {
+        if (field >= fieldCount || strspn(fields[field], "0123456789") < lengths[field]) {
+            usedFields = 4;
+        }
+    }
+    fen.clear();
+    for (int field = 0; field < usedFields; field++) {
+        fen.append(field > 0 ? " " : "").append(fields[field], lengths[field]);
+    }
+    return true;
+}
+
+/* PACKS A FILE OF FEN STRINGS OR EPD RECORDS */
+static int packFile(const char* inputPath, const char* outputPath) {
+    ifstream input(inputPath, ios::binary);
+    ofstream output(outputPath, ios::binary | ios::trunc);
+    if (!input.is_open() || !output.is_open()) {
+        cerr << "Could not open " << (input.is_open() ? outputPath : inputPath) << "\n";
+        return 1;
+    }
+
+    Clock::time_point start = Clock::now();
+    vector<char> block(blockSize);
+    vector<uint8_t> packedBlock;
+    packedBlock.reserve(blockSize);
+    string partial, fen;
+    uint64_t bytesRead = 0, lines = 0, positions = 0, invalid = 0;
+    Position position;
+    PackedPosition packed;
+
+    // Each line is converted as soon as it is complete; a line split across blocks is gathered in 'partial'
+    auto convertLine = [&](const char* line, size_t length) {
+        lines++;
+        if (length > 0 && line[length - 1] == '\r') {
+            length--;
+        }
+        size_t first = 0;
+        while (first < length && (line[first] == ' ' || line[first] == '\t')) {
+            first++;
+        }
+        if (first == length || line[first] == '#') {
+            return;
+        }
+        if (length > maxLineLength || !normaliseLine(line, length, fen) || !parseFen(fen.c_str(), position)) {
+            if (invalid++ < maxInvalidListed) {
+                cout << "line " << lines << ": not a valid FEN string or EPD record\n";
+            }
+            return;
+        }
+        packPosition(position, packed);
+        packedBlock.insert(packedBlock.end(), packed.bytes, packed.bytes + packedPositionSize);
+        if (packedBlock.size() >= blockSize) {
+            output.write(reinterpret_cast<const char*>(packedBlock.data()), packedBlock.size());
+            packedBlock.clear();
+        }
+        positions++;
+    };
+
+    while (input) {
+        input.read(block.data(), block.size());
+        size_t count = static_cast<size_t>(input.gcount());
+        bytesRead += count;
+        const char* next = block.data();
+        const char* end = next + count;
+        while (const char* newline = static_cast<const char*>(memchr(next, '\n', end - next))) {
+            if (partial.empty()) {
+                convertLine(next, newline - next);
+            }
+            else {
+                partial.append(next, newline);
+                convertLine(partial.data(), partial.size());
+                partial.clear();
+            }
+            next = newline + 1;
+        }
+        partial.append(next, end);
+    }
+    if (!partial.empty()) { // The last line has no newline
+        convertLine(partial.data(), partial.size());
+    }
+    output.write(reinterpret_cast<const char*>(packedBlock.data()), packedBlock.size());
+    output.close();
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+    cout << "Packed " << positions << " positions from " << lines << " lines (" << invalid << " invalid) in "
+         << seconds << " s\n";
+    cout << "  " << static_cast<uint64_t>(lines / seconds) << " lines/s, " << bytesRead / seconds / (1 << 20)
+         << " MB/s read; " << bytesRead << " bytes -> " << positions * packedPositionSize << " bytes\n";
+    if (output.fail()) {
+        cerr << "Could not write " << outputPath << "\n";
+        return 2;
+    }
+    return (invalid > 0 ? 2 : 0);
+}
+
+/* UNPACKS A FILE OF PACKED POSITIONS INTO FEN STRINGS */
+static int unpackFile(const char* inputPath, const char* outputPath) {
+    ifstream input(inputPath, ios::binary);
+    ofstream output(outputPath, ios::binary | ios::trunc);
+    if (!input.is_open() || !output.is_open()) {
+        cerr << "Could not open " << (input.is_open() ? outputPath : inputPath) << "\n";
+        return 1;
+    }
+
+    Clock::time_point start = Clock::now();
+    vector<PackedPosition> packedBlock(blockSize / packedPositionSize);
+    vector<char> text(packedBlock.size() * (maxFenLength + 1));
+    uint64_t positions = 0, bytesWritten = 0;
+    bool malformed = false;
+    Position position;
+    while (input && !malformed) {
+        input.read(reinterpret_cast<char*>(packedBlock.data()), packedBlock.size() * packedPositionSize);
+        size_t count = static_cast<size_t>(input.gcount());
+        if (count % packedPositionSize != 0) { // The file ends part way through a position
+            malformed = true;
+        }
+
+        char* next = text.data();
+        for (size_t index = 0; index < count / packedPositionSize; index++) {
+            if (!unpackPosition(packedBlock[index], position)) {
+                cerr << "position " << positions + 1 << ": malformed packing\n";
+                malformed = true;
+                break;
+            }
+            next += formatFen(position, next);
+            *next++ = '\n';
+            positions++;
+        }
+        output.write(text.data(), next - text.data());
+        bytesWritten += next - text.data();
+    }
+    output.close();
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+    cout << "Unpacked " << positions << " positions in " << seconds << " s\n";
+    cout << "  " << static_cast<uint64_t>(positions / seconds) << " positions/s, "
+         << positions * packedPositionSize / seconds / (1 << 20) << " MB/s read; " << positions * packedPositionSize
+         << " bytes -> " << bytesWritten << " bytes\n";
+    if (output.fail()) {
+        cerr << "Could not write " << outputPath << "\n";
+        return 2;
+    }
+    return (malformed ? 2 : 0);
+}
+
+int main(int argc, char** argv) {
+    if (argc == 4 && strcmp(argv[1], "pack") == 0) {
+        return packFile(argv[2], argv[3]);
+    }
+    if (argc == 4 && strcmp(argv[1], "unpack") == 0) {
+        return unpackFile(argv[2], argv[3]);
+    }
+    cerr << "Usage: " << argv[0] << " pack <FEN/EPD file> <packed file>\n"
+         << "       " << argv[0] << " unpack <packed file> <FEN file>\n";
+    return 1;
+}
@@ -0,0 +1,152 @@
+/*
+ * PawnHashTable.cpp - Implementation file for the pawn-structure evaluation and the
+ * PawnHashTable class, a fixed-size cache of pawn-structure evaluations.
+ */
+
+#include "PawnHashTable.h"
+
+using namespace std;
+
+static const SquareSet fileA = 0x0101010101010101ull; // Every square of the A file
+
+static const int passedPawnBonus[8] = {0, 5, 10, 20, 35, 60, 100, 0}; // Indexed by the rank advanced to, from the pawn's own side
+static const int doubledPawnPenalty = 12; // For each pawn on a file beyond the first
+static const int isolatedPawnPenalty = 15; // For a pawn with no pawns of its colour on the adjacent files
+static const int backwardPawnPenalty = 10; // For a pawn that cannot be supported by a pawn and cannot advance safely
+static const int shieldBonus[2] = {10, 5}; // For a pawn one and two ranks in front of its king (on the king's file or beside it)
+
+/* RETURNS THE FILES ADJACENT TO A FILE */
+static SquareSet adjacentFiles(int file) {
+    return (((fileA << file) << 1) & notFileA) | (((fileA << file) >> 1) & notFileH);
+}
+
+/* RETURNS EVERY SQUARE ON THE RANKS IN FRONT OF A RANK, FROM A COLOUR'S POINT OF VIEW */
+static SquareSet ranksInFront(int rank, PieceColour colour) {
+    if (colour == white) {
+        return (rank == 7 ? 0 : ~SquareSet(0) << (8 * (rank + 1)));
+    }
+    return (SquareSet(1) << (8 * rank)) - 1;
+}
+
+/* SCORES THE PASSED, DOUBLED, ISOLATED AND BACKWARD PAWNS OF ONE COLOUR */
+static int scorePawns(SquareSet pawns, SquareSet enemyPawns, PieceColour colour) {
+    int score = 0;
+
+    for (int file = 0; file < 8; file++) {
+        int pawnsOnFile = __builtin_popcountll(pawns & (fileA << file));
+        if (pawnsOnFile > 1) {
+            score -= doubledPawnPenalty * (pawnsOnFile - 1);
+        }
+    }
+
+    SquareSet enemyAttacks = pawnAttackSet(enemyPawns, (colour == white ? black : white));
+    SquareSet remaining = pawns;
+    while (remaining != 0) {
+        int square = popSquare(remaining);
+        int rank = square / 8, file = square % 8;
+        SquareSet neighbours = adjacentFiles(file);
+        SquareSet inFront = ranksInFront(rank, colour);
+
+        if ((enemyPawns & (neighbours | (fileA << file)) & inFront) == 0) {
+            score += passedPawnBonus[colour == white ? rank : 7 - rank];
+        }
+        if ((pawns & neighbours) == 0) {
+            score -= isolatedPawnPenalty;
+        }
+        else if ((pawns & neighbours & ~inFront) == 0) { // Every neighbour has advanced past it
+            int stopSquare = square + (colour == white ? 8 : -8);
+            if (containsSquare(enemyAttacks, stopSquare)) {
+                score -= backwardPawnPenalty;
+            }
+        }
+    }
+    return score;
+}
+
+/* EVALUATES A PAWN STRUCTURE FROM SCRATCH */
+PawnEntry evaluatePawnStructure(SquareSet whitePawns, SquareSet blackPawns) {
+    PawnEntry entry;
+    entry.key = 0;
+    entry.score = static_cast<int16_t>(scorePawns(whitePawns, blackPawns, white) - scorePawns(blackPawns, whitePawns, black));
+
+    for (PieceColour colour : {white, black}) {
+        SquareSet pawns = (colour == white ? whitePawns : blackPawns);
+        int homeRank = (colour == white ? 0 : 7), forward = (colour == white ? 1 : -1);
+
+        for (int file = 0; file < 8; file++) {
+            SquareSet shieldFiles = adjacentFiles(file) | (fileA << file);
+            int shelter = 0;
+            for (int distance = 1; distance <= 2; distance++) {
+                SquareSet rankSquares = SquareSet(0xFF) << (8 * (homeRank + distance * forward));
+                shelter += shieldBonus[distance - 1] * __builtin_popcountll(pawns & shieldFiles & rankSquares);
+            }
+            entry.shelter[colour][file] = static_cast<int8_t>(shelter);
+        }
+    }
+    return entry;
+}
+
+
+/****************************** PawnHashStatistics - Member Function Definitions ******************************/
+
+/* RETURNS THE FRACTION OF EVALUATIONS FOUND IN THE TABLE */
+double PawnHashStatistics::hitRate() const {
+    uint64_t evaluations = hits + misses;
+    return (evaluations == 0 ? 0.0 : static_cast<double>(hits) / evaluations);
+}
+
+
+/****************************** PawnHashTable - Member Function Definitions ******************************/
+
+/* CONSTRUCTOR - ALLOCATES A POWER OF TWO NUMBER OF SLOTS */
+PawnHashTable::PawnHashTable(size_t entryCount) {
+    size_t slotCount = 1;
+    while (slotCount * 2 <= entryCount) {
+        slotCount *= 2;
+    }
+    entries.resize(slotCount);
+    indexMask = slotCount - 1;
+    clear();
+}
+
+/* SCORES THE PAWN STRUCTURE AND KING SHELTER OF THE CURRENT POSITION */
+int PawnHashTable::evaluate(const ChessGame& game) {
+    uint64_t key = game.pawnHash();
+    PawnEntry& slot = entries[key & indexMask];
+
+    if (slot.key == key) {
+        hits++;
+    }
+    else {
+        slot = evaluatePawnStructure(game.pieceSquares(white, pawn), game.pieceSquares(black, pawn));
+        slot.key = key;
+        misses++;
+    }
+
+    // The shelter counts only while the king stays on its home rank
+    int score = slot.score;
+    SquareSet whiteKing = game.pieceSquares(white, king), blackKing = game.pieceSquares(black, king);
+    if (whiteKing != 0 && __builtin_ctzll(whiteKing) < 8) {
+        score += slot.shelter[white][__builtin_ctzll(whiteKing)];
+    }
+    if (blackKing != 0 && __builtin_ctzll(blackKing) >= 56) {
+        score -= slot.shelter[black][__builtin_ctzll(blackKing) - 56];
+    }
+    return (game.getTurn() == white ? score : -score);
+}
+
+/* RETURNS A SNAPSHOT OF THE USAGE COUNTERS */
+PawnHashStatistics PawnHashTable::getStatistics() const {
+    return {hits, misses};
+}
+
+/* EMPTIES THE TABLE */
+void PawnHashTable::clear() {
+    // A position without pawns has a pawn hash of zero, so empty slots hold its evaluation
+    PawnEntry noPawns = evaluatePawnStructure(0, 0);
+    for (PawnEntry& slot : entries) {
+        slot = noPawns;
+    }
+    hits = 0;
+    misses = 0;
+}
@@ -0,0 +1,92 @@
+/*
+ * PawnHashTable.h - Header file for the pawn-structure evaluation and the PawnHashTable class,
+ * a fixed-size cache of pawn-structure evaluations indexed by the pawn hash, owned by a single
+ * thread. Pawn structures change rarely from one position of a search to the next, so most
+ * evaluations are found in the table instead of being computed again.
+ */
+
+#ifndef PAWNHASHTABLE_H
+#define PAWNHASHTABLE_H
+
+#include "AttackTables.h"
+#include "ChessGame.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * The evaluation of a pawn structure: every term that depends on the pawns alone.
+ */
+struct PawnEntry {
+    uint64_t key; // The pawn hash of the structure (ChessGame::pawnHash())
+    int16_t score; // The passed, doubled, isolated and backward pawn terms, in centipawns from white's perspective
+    int8_t shelter[2][8]; // Indexed by [PieceColour][file]: the pawn shield bonus of a king of that colour on its home rank and that file
+};
+
+/*
+ * Counters describing how well the pawn hash table is working.
+ */
+struct PawnHashStatistics {
+    uint64_t hits; // Evaluations found in the table
+    uint64_t misses; // Evaluations computed and stored
+
+    /* @return The fraction of evaluations found in the table (0 if there have been none). */
+    double hitRate() const;
+};
+
+/*
+ * Evaluates a pawn structure from scratch: passed pawns (by how far they have advanced), doubled,
+ * isolated and backward pawns, and the pawn shield in front of a king on each square of its home rank.
+ *
+ * @param whitePawns The squares of the white pawns.
+ * @param blackPawns The squares of the black pawns.
+ * @return The evaluation of the structure (with a key of zero).
+ */
+PawnEntry evaluatePawnStructure(SquareSet whitePawns, SquareSet blackPawns);
+
+
+/****************************** Class PawnHashTable ******************************/
+
+class PawnHashTable final {
+
+    public:
+        /*
+         * Parameterised constructor for a table holding a fixed number of entries.
+         *
+         * @param entryCount The number of entries (rounded down to a power of two, at least one).
+         */
+        explicit PawnHashTable(size_t entryCount);
+
+        PawnHashTable(const PawnHashTable&) = delete;
+        PawnHashTable& operator=(const PawnHashTable&) = delete;
+
+        /*
+         * Scores the pawn structure of a game's current position, and the pawn shield in front of
+         * each king still on its home rank. The structure is looked up by the game's pawn hash and
+         * only evaluated (then stored) if it is not in the table.
+         *
+         * @param game The game whose current position to score.
+         * @return The score in centipawns from the perspective of the side to move.
+         */
+        int evaluate(const ChessGame& game);
+
+        /*
+         * Getter function for the table's usage counters.
+         *
+         * @return A snapshot of the hit and miss counts.
+         */
+        PawnHashStatistics getStatistics() const;
+
+        /*
+         * Empties the table and resets its counters.
+         */
+        void clear();
+
+    private:
+        std::vector<PawnEntry> entries; // The slots, indexed by the low bits of the pawn hash
+        uint64_t indexMask; // The number of slots less one
+        uint64_t hits = 0; // Evaluations found in the table
+        uint64_t misses = 0; // Evaluations computed and stored
+};
+
+#endif
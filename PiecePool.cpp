@@ -0,0 +1,49 @@
+/*
+ * PiecePool.cpp - Implementation file for the PiecePool class, the fixed storage in
+ * which a ChessGame constructs its pieces.
+ */
+
+#include "PiecePool.h"
+#include "ChessPiece.h"
+#include <algorithm>
+
+static_assert(std::max({sizeof(Pawn), sizeof(Rook), sizeof(Knight), sizeof(Bishop), sizeof(Queen), sizeof(King)}) <= PiecePool::slotSize,
+              "Every piece must fit in a pool slot");
+static_assert(std::max({alignof(Pawn), alignof(Rook), alignof(Knight), alignof(Bishop), alignof(Queen), alignof(King)}) <= alignof(std::max_align_t),
+              "Every piece must be aligned by a pool slot");
+
+
+/****************************** PiecePool - Member Function Definitions ******************************/
+
+/* DEFAULT CONSTRUCTOR */
+PiecePool::PiecePool() : freeCount(0), nextUnused(0) {}
+
+/* DESTROYS A PIECE AND FREES ITS SLOT */
+void PiecePool::destroy(ChessPiece* piece) {
+    // The slot is found from the address of the piece, as every piece starts within its slot
+    int slot = static_cast<int>((reinterpret_cast<unsigned char*>(piece) - reinterpret_cast<unsigned char*>(slots)) / sizeof(Slot));
+    piece->~ChessPiece();
+    freeSlots[freeCount++] = static_cast<uint8_t>(slot);
+}
+
+/* FREES EVERY SLOT AT ONCE */
+void PiecePool::reset() {
+    freeCount = 0;
+    nextUnused = 0;
+}
+
+/* GETTER FOR THE NUMBER OF SLOTS IN USE */
+int PiecePool::getPiecesInUse() const {
+    return nextUnused - freeCount;
+}
+
+/* TAKES A FREE SLOT */
+void* PiecePool::allocateSlot() {
+    if (freeCount > 0) {
+        return slots[freeSlots[--freeCount]].bytes;
+    }
+    if (nextUnused < capacity) {
+        return slots[nextUnused++].bytes;
+    }
+    return nullptr;
+}
@@ -0,0 +1,93 @@
+/*
+ * PiecePool.h - Header file for the PiecePool class, the fixed storage owned by each
+ * ChessGame in which its pieces are constructed, instead of allocating every piece
+ * separately on the heap.
+ */
+
+#ifndef PIECEPOOL_H
+#define PIECEPOOL_H
+
+#include "Enums.h"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+class ChessGame;
+class ChessPiece;
+
+
+/****************************** Class PiecePool ******************************/
+
+class PiecePool final {
+
+    public:
+        // The number of pieces the pool can hold at once: every piece on the board, plus those kept
+        // off the board by ChessGame::makeLegalMove() until their move is taken back
+        static const int capacity = 64;
+
+        // The size of each slot, which must hold any piece sub-class (checked in PiecePool.cpp)
+        static const size_t slotSize = 64;
+
+        /*
+         * Default constructor for an empty pool.
+         */
+        PiecePool();
+
+        PiecePool(const PiecePool&) = delete;
+        PiecePool& operator=(const PiecePool&) = delete;
+
+        /*
+         * Constructs a piece in a free slot of the pool.
+         *
+         * @param colour The colour of the chess piece.
+         * @param rank The rank of the square occupied by the chess piece.
+         * @param file The file of the square occupied by the chess piece.
+         * @param chessGame The chess game that the chess piece belongs to.
+         *
+         * @return A pointer to the new piece, or nullptr if every slot is in use.
+         */
+        template <typename PieceClass>
+        ChessPiece* create(PieceColour colour, int rank, int file, ChessGame& chessGame) {
+            void* slot = allocateSlot();
+            return (slot == nullptr ? nullptr : new (slot) PieceClass(colour, rank, file, chessGame));
+        }
+
+        /*
+         * Destroys a piece created by this pool and frees its slot for reuse.
+         *
+         * @param piece The piece to destroy.
+         */
+        void destroy(ChessPiece* piece);
+
+        /*
+         * Frees every slot at once, in constant time. The pieces' destructors are not run, which
+         * is safe because pieces own no resources; any pointer to a piece of the pool is invalidated.
+         */
+        void reset();
+
+        /*
+         * Getter function for the number of slots in use.
+         *
+         * @return The number of pieces currently held by the pool.
+         */
+        int getPiecesInUse() const;
+
+    private:
+        struct alignas(std::max_align_t) Slot {
+            unsigned char bytes[slotSize];
+        };
+
+        Slot slots[capacity]; // The storage of the pieces
+        uint8_t freeSlots[capacity]; // A stack of the indices of slots freed by destroy()
+        int freeCount; // The number of indices on the stack of free slots
+        int nextUnused; // The first slot that has not been used since the last reset (slots beyond it are free)
+
+        /*
+         * Takes a free slot, preferring one freed by destroy() over one never used since the last reset.
+         *
+         * @return The storage of the slot, or nullptr if every slot is in use.
+         */
+        void* allocateSlot();
+};
+
+#endif
@@ -0,0 +1,41 @@
+/*
+ * Position.h - Header file for the Position snapshot, a flat, trivially copyable record of
+ * the full state of a chess game that can be copied freely and handed to other threads.
+ */
+
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <cstdint>
+#include <type_traits>
+
+/*
+ * Flags recording the status of the game in a Position.
+ */
+enum PositionStatusFlags : uint8_t {
+    positionLoaded = 1, // A game was loaded (moves can be submitted unless the game is over)
+    positionGameOver = 2, // The game has ended by checkmate, stalemate or a draw
+    positionWhiteInCheck = 4, // The white king is in check
+    positionBlackInCheck = 8, // The black king is in check
+    positionStateStale = 16 // The game state has not been evaluated since the last move (see ChessGame::setLazyGameState())
+};
+
+/*
+ * A snapshot of the full state of a chess game, taken by ChessGame::savePosition() and restored
+ * by ChessGame::restorePosition(). It holds no pointers, so it is copied with a single memcpy
+ * and may be read by any number of threads at once.
+ */
+struct Position {
+    char squares[64]; // Indexed by rank * 8 + file: the FEN character of the piece on each square ('\0' if empty)
+    uint8_t turn; // The active colour (a PieceColour)
+    uint8_t castlingRights; // Bit 0: white kingside, bit 1: white queenside, bit 2: black kingside, bit 3: black queenside
+    int8_t enPassantSquare; // The index (rank * 8 + file) of the en passant square (-1 if none)
+    uint8_t statusFlags; // A combination of PositionStatusFlags
+    uint16_t halfMoveCounter; // The number of moves since the last capture or pawn advance
+    uint16_t fullMoveCounter; // The number of full moves
+};
+
+static_assert(std::is_trivially_copyable<Position>::value, "Position must be copyable with memcpy");
+static_assert(sizeof(Position) == 72, "Position must stay compact");
+
+#endif
@@ -0,0 +1,48 @@
+/*
+ * PositionClassifier.cpp - Implementation file for classifying the game state of
+ * large batches of positions in parallel.
+ */
+
+#include "PositionClassifier.h"
+#include "ChessGame.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// The number of consecutive positions a worker claims at once
+static const size_t blockSize = 256;
+
+/* CLASSIFIES A BATCH OF POSITIONS ACROSS WORKER THREADS */
+void classifyPositions(const char* const* fenStrings, size_t count, uint8_t* statuses, unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = max(thread::hardware_concurrency(), 1u);
+    }
+    size_t blockCount = (count + blockSize - 1) / blockSize;
+    threadCount = static_cast<unsigned>(min<size_t>(threadCount, max<size_t>(blockCount, 1)));
+
+    atomic<size_t> nextBlock(0);
+    auto classifyBlocks = [&]() {
+        ChessGame game;
+        game.setConsoleOutput(false);
+
+        // Claim blocks rather than fixed slices, so one slow slice cannot hold up the batch
+        for (size_t block = nextBlock++; block < blockCount; block = nextBlock++) {
+            size_t end = min(count, (block + 1) * blockSize);
+            for (size_t index = block * blockSize; index < end; index++) {
+                statuses[index] = (fenStrings[index] != nullptr ? game.classifyPosition(fenStrings[index]) : positionInvalid);
+            }
+        }
+    };
+
+    vector<thread> workers;
+    for (unsigned index = 1; index < threadCount; index++) {
+        workers.emplace_back(classifyBlocks);
+    }
+    classifyBlocks(); // The calling thread works too
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
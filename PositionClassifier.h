@@ -0,0 +1,29 @@
+/*
+ * PositionClassifier.h - Header file for classifying the game state (check, checkmate,
+ * stalemate and draw by the 50-move rule) of large batches of positions in parallel.
+ */
+
+#ifndef POSITIONCLASSIFIER_H
+#define POSITIONCLASSIFIER_H
+
+#include "MoveCache.h"
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Classifies a batch of positions given as FEN strings, writing one byte of PositionStateFlags
+ * per position (for the side to move). The batch is split into blocks which worker threads
+ * claim in turn, each loading positions silently into its own game, so no output is written
+ * and no locks are taken per position. Each FEN string is validated as it is loaded (see
+ * ChessGame::classifyPosition()), so a malformed or unplayable line, or a null pointer, is
+ * marked positionInvalid without affecting the rest of the batch.
+ *
+ * @param fenStrings An array of FEN strings describing the positions to classify.
+ * @param count The number of FEN strings in the array.
+ * @param statuses An array of at least 'count' bytes to store the state of each position in
+ *                 (positionInvalid for a position that could not be loaded).
+ * @param threadCount The number of worker threads (0 to use one per hardware thread).
+ */
+void classifyPositions(const char* const* fenStrings, size_t count, uint8_t* statuses, unsigned threadCount = 0);
+
+#endif
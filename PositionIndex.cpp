@@ -0,0 +1,316 @@
+/*
+ * PositionIndex.cpp - Implementation file for the on-disk index from position
+ * hashes to the games that reached them, and the builder that creates it.
+ */
+
+#include "PositionIndex.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <queue>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "index entries are memory-mapped in their little-endian file layout");
+
+static const char indexMagic[4] = {'C', 'P', 'I', 'X'};
+static const uint32_t indexVersion = 1;
+static const size_t headerSize = 16; // Magic, version and entry count
+static const size_t mergeBlockEntries = 1 << 14; // Entries read from each run at a time while merging
+
+/* WRITES AN INTEGER OF THE GIVEN NUMBER OF BYTES IN LITTLE-ENDIAN ORDER, RETURNING FALSE IF THE WRITE FAILS */
+static bool writeLittleEndian(FILE* file, uint64_t value, int size) {
+    unsigned char bytes[8];
+    for (int index = 0; index < size; index++) {
+        bytes[index] = static_cast<unsigned char>(value >> (8 * index));
+    }
+    return fwrite(bytes, 1, size, file) == static_cast<size_t>(size);
+}
+
+/* READS AN INTEGER OF THE GIVEN NUMBER OF BYTES IN LITTLE-ENDIAN ORDER */
+static uint64_t readLittleEndian(const char* bytes, int size) {
+    uint64_t value = 0;
+    for (int index = 0; index < size; index++) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(bytes[index])) << (8 * index);
+    }
+    return value;
+}
+
+/* ORDERS ENTRIES BY HASH, THEN GAME, THEN PLY */
+static bool entryLess(const PositionIndexEntry& entry1, const PositionIndexEntry& entry2) {
+    if (entry1.hash != entry2.hash) {
+        return entry1.hash < entry2.hash;
+    }
+    if (entry1.gameID != entry2.gameID) {
+        return entry1.gameID < entry2.gameID;
+    }
+    return entry1.ply < entry2.ply;
+}
+
+/*
+ * Reads the entries of a sorted run file one block at a time.
+ */
+struct RunReader {
+    FILE* file = nullptr;
+    vector<PositionIndexEntry> block;
+    size_t position = 0;
+
+    /* LOADS THE NEXT BLOCK OF ENTRIES, RETURNING FALSE AT THE END OF THE RUN */
+    bool refill() {
+        block.resize(mergeBlockEntries);
+        block.resize(fread(block.data(), sizeof(PositionIndexEntry), mergeBlockEntries, file));
+        position = 0;
+        return !block.empty();
+    }
+
+    /* OBTAINS THE NEXT ENTRY, RETURNING FALSE AT THE END OF THE RUN */
+    bool next(PositionIndexEntry& entry) {
+        if (position == block.size() && !refill()) {
+            return false;
+        }
+        entry = block[position++];
+        return true;
+    }
+};
+
+
+/****************************** PositionIndexBuilder - Member Function Definitions ******************************/
+
+/* CONSTRUCTOR */
+PositionIndexBuilder::PositionIndexBuilder(const string& indexPath, size_t memoryBudget)
+: indexPath(indexPath), bufferCapacity(max<size_t>(memoryBudget / sizeof(PositionIndexEntry), 1)), nextGameID(0),
+  skippedGames(0), runFailed(false) {
+    buffer.reserve(bufferCapacity);
+    game.setConsoleOutput(false);
+}
+
+/* DESTRUCTOR - REMOVES TEMPORARY RUN FILES */
+PositionIndexBuilder::~PositionIndexBuilder() {
+    for (const string& runPath : runPaths) {
+        remove(runPath.c_str());
+    }
+}
+
+/* REPLAYS A GAME RECORD FILE AND INDEXES EVERY POSITION REACHED */
+uint32_t PositionIndexBuilder::addRecordFile(const string& recordPath) {
+    ifstream input(recordPath, ios::binary);
+    GameRecordReader reader(input);
+    uint32_t gamesIndexed = 0;
+
+    while (reader.beginGame()) {
+        uint32_t gameID = nextGameID++;
+        uint32_t ply = 0;
+
+        // Record files may come from anywhere, so a starting position that cannot be loaded skips the game
+        Move move;
+        if (!game.loadPlayableState(reader.getStartFen().c_str())) {
+            while (reader.nextMove(move)) {}
+            skippedGames++;
+            continue;
+        }
+        addPosition(game.positionHash(), gameID, ply);
+
+        while (reader.nextMove(move)) {
+            if (game.submitMove(move)) { // Positions are only reached by legal moves
+                addPosition(game.positionHash(), gameID, ++ply);
+            }
+        }
+        gamesIndexed++;
+    }
+    return gamesIndexed;
+}
+
+/* GETTER FOR THE NUMBER OF GAMES SKIPPED BY addRecordFile() */
+uint32_t PositionIndexBuilder::getSkippedGames() const {
+    return skippedGames;
+}
+
+/* BUFFERS A POSITION, SPILLING A SORTED RUN WHEN THE MEMORY BUDGET IS REACHED */
+void PositionIndexBuilder::addPosition(uint64_t hash, uint32_t gameID, uint32_t ply) {
+    buffer.push_back({hash, gameID, ply});
+    if (buffer.size() == bufferCapacity) {
+        spillRun();
+    }
+}
+
+/* SORTS THE BUFFER AND WRITES IT TO A TEMPORARY RUN FILE */
+void PositionIndexBuilder::spillRun() {
+    if (buffer.empty()) {
+        return;
+    }
+    sort(buffer.begin(), buffer.end(), entryLess);
+
+    string runPath = indexPath + ".run" + to_string(runPaths.size());
+    FILE* run = fopen(runPath.c_str(), "wb");
+    bool written = (run != nullptr && fwrite(buffer.data(), sizeof(PositionIndexEntry), buffer.size(), run) == buffer.size());
+    if (run != nullptr && fclose(run) != 0) {
+        written = false;
+    }
+    if (!written) { // Reported now, while errno describes it, and returned as an error by finish()
+        perror(runPath.c_str());
+        runFailed = true;
+    }
+
+    runPaths.push_back(runPath); // Removed when the build finishes, even if incomplete
+    buffer.clear();
+}
+
+/* MERGES THE SORTED RUNS INTO THE INDEX FILE, STOPPING AT THE FIRST ERROR */
+bool PositionIndexBuilder::finish(uint64_t& entryCount) {
+    spillRun();
+    entryCount = 0;
+
+    FILE* output = fopen(indexPath.c_str(), "wb");
+    if (output == nullptr) {
+        perror(indexPath.c_str());
+        return false;
+    }
+    bool written = !runFailed && fwrite(indexMagic, 1, 4, output) == 4 && writeLittleEndian(output, indexVersion, 4)
+                   && writeLittleEndian(output, entryCount, 8); // Rewritten once the merge is complete
+    bool reported = runFailed; // Whether the error has been reported (a run that failed to spill already was)
+
+    // K-WAY MERGE OF THE RUNS
+    vector<RunReader> runs(runPaths.size());
+    typedef pair<PositionIndexEntry, size_t> HeapItem; // An entry and the run it came from
+    auto heapGreater = [](const HeapItem& item1, const HeapItem& item2) { return entryLess(item2.first, item1.first); };
+    priority_queue<HeapItem, vector<HeapItem>, decltype(heapGreater)> heap(heapGreater);
+
+    for (size_t run = 0; run < runs.size() && written; run++) {
+        runs[run].file = fopen(runPaths[run].c_str(), "rb");
+        if (runs[run].file == nullptr) { // Every run is needed, or entries would silently go missing
+            perror(runPaths[run].c_str());
+            written = false;
+            reported = true;
+            break;
+        }
+        PositionIndexEntry entry;
+        if (runs[run].next(entry)) {
+            heap.push({entry, run});
+        }
+    }
+
+    PositionIndexEntry previous = {0, 0, 0};
+    while (written && !heap.empty()) {
+        HeapItem smallest = heap.top();
+        heap.pop();
+
+        // Keep only the first ply at which each game reached each position
+        if (entryCount == 0 || smallest.first.hash != previous.hash || smallest.first.gameID != previous.gameID) {
+            written = (fwrite(&smallest.first, sizeof(PositionIndexEntry), 1, output) == 1);
+            previous = smallest.first;
+            entryCount++;
+        }
+
+        PositionIndexEntry entry;
+        if (runs[smallest.second].next(entry)) {
+            heap.push({entry, smallest.second});
+        }
+    }
+
+    for (size_t run = 0; run < runs.size(); run++) {
+        if (runs[run].file != nullptr) {
+            if (ferror(runs[run].file)) { // A failed read ends a run early, just as its end does
+                perror(runPaths[run].c_str());
+                written = false;
+                reported = true;
+            }
+            fclose(runs[run].file);
+        }
+    }
+    for (const string& runPath : runPaths) {
+        remove(runPath.c_str());
+    }
+    runPaths.clear();
+
+    if (written && (fseek(output, 8, SEEK_SET) != 0 || !writeLittleEndian(output, entryCount, 8))) {
+        written = false;
+    }
+    if (fclose(output) != 0) {
+        written = false;
+    }
+    if (!written) { // Never leave a partial index that could be mistaken for a complete one
+        if (!reported) {
+            perror(indexPath.c_str());
+        }
+        remove(indexPath.c_str());
+        entryCount = 0;
+        return false;
+    }
+    return true;
+}
+
+
+/****************************** PositionIndex - Member Function Definitions ******************************/
+
+/* CONSTRUCTOR - MEMORY-MAPS THE INDEX FILE */
+PositionIndex::PositionIndex(const string& indexPath) : mapping(nullptr), mappingLength(0), entries(nullptr), entryCount(0) {
+    int descriptor = open(indexPath.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return;
+    }
+
+    struct stat fileStatus;
+    if (fstat(descriptor, &fileStatus) == 0 && static_cast<size_t>(fileStatus.st_size) >= headerSize) {
+        mappingLength = fileStatus.st_size;
+        void* mapped = mmap(nullptr, mappingLength, PROT_READ, MAP_SHARED, descriptor, 0);
+        if (mapped != MAP_FAILED) {
+            mapping = mapped;
+        }
+    }
+    close(descriptor);
+
+    if (mapping == nullptr) {
+        return;
+    }
+
+    const char* bytes = static_cast<const char*>(mapping);
+    uint32_t version = static_cast<uint32_t>(readLittleEndian(bytes + 4, 4));
+    uint64_t count = readLittleEndian(bytes + 8, 8);
+
+    if (memcmp(bytes, indexMagic, 4) != 0 || version != indexVersion || count > (mappingLength - headerSize) / sizeof(PositionIndexEntry)) {
+        munmap(mapping, mappingLength);
+        mapping = nullptr;
+        return;
+    }
+
+    entries = reinterpret_cast<const PositionIndexEntry*>(bytes + headerSize);
+    entryCount = count;
+    madvise(mapping, mappingLength, MADV_RANDOM); // Lookups touch a handful of pages each
+}
+
+/* DESTRUCTOR - UNMAPS THE INDEX FILE */
+PositionIndex::~PositionIndex() {
+    if (mapping != nullptr) {
+        munmap(mapping, mappingLength);
+    }
+}
+
+/* DETERMINES WHETHER THE INDEX WAS MAPPED */
+bool PositionIndex::isOpen() const {
+    return mapping != nullptr;
+}
+
+/* GETTER FOR THE NUMBER OF ENTRIES */
+uint64_t PositionIndex::size() const {
+    return entryCount;
+}
+
+/* FINDS THE ENTRIES FOR A POSITION BY BINARY SEARCH */
+size_t PositionIndex::find(uint64_t hash, const PositionIndexEntry*& first) const {
+    const PositionIndexEntry* end = entries + entryCount;
+
+    first = lower_bound(entries, end, hash, [](const PositionIndexEntry& entry, uint64_t value) { return entry.hash < value; });
+    const PositionIndexEntry* last = first;
+    while (last != end && last->hash == hash) {
+        last++;
+    }
+    return last - first;
+}
@@ -0,0 +1,164 @@
+/*
+ * PositionIndex.h - Header file for the on-disk index from position hashes to
+ * the games that reached them, and the builder that creates it from game records.
+ *
+ * Index file layout: "CPIX" magic, 4-byte version, 8-byte entry count, followed by
+ * the entries sorted by (hash, gameID). A (hash, gameID) pair appears at most once,
+ * with the ply at which the game first reached the position. Every integer is
+ * little-endian, as in game records; the entries are memory-mapped and searched in
+ * place, so the index is only built and read on little-endian hosts.
+ */
+
+#ifndef POSITIONINDEX_H
+#define POSITIONINDEX_H
+
+#include "ChessGame.h"
+#include "GameRecord.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * A single entry of the index: a game that reached a position.
+ */
+struct PositionIndexEntry {
+    uint64_t hash; // The Zobrist hash of the position (ChessGame::positionHash())
+    uint32_t gameID; // The ID of the game (its order of appearance across the indexed record files)
+    uint32_t ply; // The number of moves played in the game when it first reached the position
+};
+
+
+/****************************** Class PositionIndexBuilder ******************************/
+
+class PositionIndexBuilder final {
+
+    public:
+        /*
+         * Parameterised constructor for a builder that writes an index file. Entries are
+         * sorted in memory-bounded runs which are spilled to temporary files next to the
+         * index and merged when finish() is called.
+         *
+         * @param indexPath The path of the index file to create.
+         * @param memoryBudget The maximum number of bytes of entries to hold in memory at once.
+         */
+        PositionIndexBuilder(const std::string& indexPath, size_t memoryBudget);
+
+        /*
+         * Destructor removes any temporary run files left behind by an unfinished build.
+         */
+        ~PositionIndexBuilder();
+
+        PositionIndexBuilder(const PositionIndexBuilder&) = delete;
+        PositionIndexBuilder& operator=(const PositionIndexBuilder&) = delete;
+
+        /*
+         * Replays every game in a binary game record file through a chess game and adds
+         * each position reached (including the starting position) to the index. A game whose
+         * starting FEN string is malformed or not playable (see ChessGame::loadPlayableState())
+         * is skipped, keeping its game ID, and counted by getSkippedGames().
+         *
+         * @param recordPath The path of the game record file.
+         *
+         * @return The number of games indexed from the file.
+         */
+        uint32_t addRecordFile(const std::string& recordPath);
+
+        /*
+         * Getter function for the number of games skipped by addRecordFile().
+         *
+         * @return The number of games skipped so far.
+         */
+        uint32_t getSkippedGames() const;
+
+        /*
+         * Adds a single position to the index.
+         *
+         * @param hash The Zobrist hash of the position.
+         * @param gameID The ID of the game that reached the position.
+         * @param ply The number of moves played in the game when it reached the position.
+         */
+        void addPosition(uint64_t hash, uint32_t gameID, uint32_t ply);
+
+        /*
+         * Merges the sorted runs into the index file and removes the temporary files. If a run
+         * could not be written or read back, or the index could not be written, the merge stops,
+         * the error is reported on stderr and no index file is left behind.
+         *
+         * @param entryCount A reference to store the number of entries written to the index in.
+         *
+         * @return true if the whole index was written; false otherwise.
+         */
+        bool finish(uint64_t& entryCount);
+
+    private:
+        std::string indexPath; // The path of the index file to create
+        std::vector<PositionIndexEntry> buffer; // Entries waiting to be sorted into a run
+        size_t bufferCapacity; // The number of entries that fit in the memory budget
+        std::vector<std::string> runPaths; // The temporary files holding each sorted run
+        uint32_t nextGameID; // The ID to give to the next game indexed
+        uint32_t skippedGames; // The number of games whose starting position could not be loaded
+        bool runFailed; // Indicates that a run could not be written in full, so the index cannot be finished
+        ChessGame game; // The game used to replay records
+
+        /*
+         * Sorts the buffered entries and writes them to a new temporary run file, setting
+         * 'runFailed' if the file cannot be written.
+         */
+        void spillRun();
+};
+
+
+/****************************** Class PositionIndex ******************************/
+
+class PositionIndex final {
+
+    public:
+        /*
+         * Parameterised constructor which memory-maps an index file for querying.
+         * isOpen() reports whether the file was mapped successfully.
+         *
+         * @param indexPath The path of the index file.
+         */
+        PositionIndex(const std::string& indexPath);
+
+        /*
+         * Destructor unmaps the index file.
+         */
+        ~PositionIndex();
+
+        PositionIndex(const PositionIndex&) = delete;
+        PositionIndex& operator=(const PositionIndex&) = delete;
+
+        /*
+         * Determines whether the index file was opened and mapped.
+         *
+         * @return true if the index can be queried; false otherwise.
+         */
+        bool isOpen() const;
+
+        /*
+         * Getter function for the number of entries in the index.
+         *
+         * @return The number of (position, game) entries.
+         */
+        uint64_t size() const;
+
+        /*
+         * Finds every game that reached a position.
+         *
+         * @param hash The Zobrist hash of the position.
+         * @param first A reference to store a pointer to the first matching entry in.
+         *
+         * @return The number of matching entries (consecutive from 'first', ordered by game ID).
+         */
+        size_t find(uint64_t hash, const PositionIndexEntry*& first) const;
+
+    private:
+        void* mapping; // The memory-mapped file (nullptr if not mapped)
+        size_t mappingLength; // The length of the mapping in bytes
+        const PositionIndexEntry* entries; // The sorted entries within the mapping
+        uint64_t entryCount; // The number of entries
+};
+
+#endif
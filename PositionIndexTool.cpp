@@ -0,0 +1,91 @@
+/*
+ * PositionIndexTool.cpp - Command line tool to build a position index from
+ * binary game records and to query it for the games that reached a position.
+ *
+ * Usage: posindex build <index file> <memory budget MB> <record file>...
+ *        posindex query <index file> <FEN string>...
+ */
+
+#include "ChessGame.h"
+#include "PositionIndex.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+static const size_t maxGamesListed = 20;
+
+/* BUILDS AN INDEX FROM ONE OR MORE GAME RECORD FILES */
+static int buildIndex(int argc, char** argv) {
+    size_t memoryBudget = static_cast<size_t>(atol(argv[3])) << 20;
+    PositionIndexBuilder builder(argv[2], memoryBudget);
+
+    Clock::time_point start = Clock::now();
+    uint32_t games = 0;
+    for (int arg = 4; arg < argc; arg++) {
+        games += builder.addRecordFile(argv[arg]);
+    }
+    uint64_t entries;
+    if (!builder.finish(entries)) {
+        cerr << "Could not build index " << argv[2] << "\n";
+        return 1;
+    }
+
+    cout << "Indexed " << games << " games (" << builder.getSkippedGames() << " skipped with an invalid starting position): "
+         << entries << " entries in " << chrono::duration<double>(Clock::now() - start).count() << " s\n";
+    return 0;
+}
+
+/* LOOKS UP THE GAMES THAT REACHED EACH GIVEN POSITION */
+static int queryIndex(int argc, char** argv) {
+    PositionIndex index(argv[2]);
+    if (!index.isOpen()) {
+        cerr << "Could not open index " << argv[2] << "\n";
+        return 1;
+    }
+
+    ChessGame game;
+    game.setConsoleOutput(false);
+
+    int rejected = 0;
+    for (int arg = 3; arg < argc; arg++) {
+        if (!game.loadPlayableState(argv[arg])) {
+            cout << argv[arg] << "\n  invalid FEN string or position\n";
+            rejected++;
+            continue;
+        }
+        uint64_t hash = game.positionHash();
+
+        Clock::time_point start = Clock::now();
+        const PositionIndexEntry* first;
+        size_t matches = index.find(hash, first);
+        double microseconds = chrono::duration<double, micro>(Clock::now() - start).count();
+
+        cout << argv[arg] << "\n  " << matches << " games (lookup " << microseconds << " us)";
+        for (size_t match = 0; match < matches && match < maxGamesListed; match++) {
+            cout << (match == 0 ? ": " : ", ") << "game " << first[match].gameID << " ply " << first[match].ply;
+        }
+        if (matches > maxGamesListed) {
+            cout << ", ...";
+        }
+        cout << "\n";
+    }
+    return (rejected == 0 ? 0 : 1);
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 5 && strcmp(argv[1], "build") == 0) {
+        return buildIndex(argc, argv);
+    }
+    if (argc >= 4 && strcmp(argv[1], "query") == 0) {
+        return queryIndex(argc, argv);
+    }
+
+    cerr << "Usage: " << argv[0] << " build <index file> <memory budget MB> <record file>...\n"
+         << "       " << argv[0] << " query <index file> <FEN string>...\n";
+    return 1;
+}
@@ -0,0 +1,138 @@
+/*
+ * RandomGameTool.cpp - Command line tool to generate random legal games in bulk, for load
+ * testing game servers and fuzzing the rules engine, and to verify the games generated.
+ *
+ * generate: plays games of random legal moves from a start position (the standard starting
+ * position by default) to checkmate, stalemate, the 50-move rule or threefold repetition, and
+ * streams them to a binary game record file, each with its seed.
+ *
+ * verify: replays every game of a record file through submitMove() (the fully validated move
+ * path, with game state detection) and checks that each game is reproduced exactly by its seed.
+ * A game whose starting FEN string cannot be loaded (see ChessGame::loadPlayableState()) is
+ * reported as a mismatch and skipped.
+ *
+ * The start FEN string given to generate is checked the same way before any game is played.
+ *
+ * Usage: gamegen generate <record file> <games> [threads] [first seed] [start FEN]
+ *        gamegen verify <record file>
+ */
+
+#include "ChessGame.h"
+#include "GameRecord.h"
+#include "RandomGames.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+static const char* const startingPosition = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+static const int maxMismatchesListed = 20;
+
+/* GENERATES RANDOM GAMES INTO A RECORD FILE */
+static int generateGames(int argc, char** argv) {
+    uint64_t gameCount = strtoull(argv[3], nullptr, 10);
+    unsigned threadCount = (argc > 4 ? atoi(argv[4]) : 0);
+    uint64_t firstSeed = (argc > 5 ? strtoull(argv[5], nullptr, 10) : 1);
+    const char* startFen = (argc > 6 ? argv[6] : startingPosition);
+
+    ChessGame startGame; // The generator assumes a playable start position
+    if (!startGame.loadPlayableState(startFen)) {
+        cerr << "Invalid start FEN string or position: " << startFen << "\n";
+        return 1;
+    }
+
+    ofstream output(argv[2], ios::binary);
+    if (!output) {
+        cerr << "Could not create record file " << argv[2] << "\n";
+        return 1;
+    }
+    RandomGameStatistics statistics = generateRandomGames(startFen, gameCount, firstSeed, output, threadCount);
+    output.close();
+
+    cout << statistics.games << " games (seeds " << firstSeed << " to " << firstSeed + gameCount - 1 << ") in "
+         << statistics.seconds << " s: " << statistics.moves << " moves\n";
+    cout << "  " << statistics.games / statistics.seconds << " games/s, "
+         << static_cast<uint64_t>(statistics.moves / statistics.seconds) << " moves/s\n";
+    cout << "  endings: " << statistics.endings[checkmateEnding] << " checkmate, " << statistics.endings[stalemateEnding]
+         << " stalemate, " << statistics.endings[fiftyMoveEnding] << " 50-move rule, "
+         << statistics.endings[repetitionEnding] << " repetition\n";
+    return 0;
+}
+
+/* REPLAYS EVERY GAME OF A RECORD FILE AND REPRODUCES IT FROM ITS SEED */
+static int verifyGames(char** argv) {
+    ifstream input(argv[2], ios::binary);
+    if (!input) {
+        cerr << "Could not open record file " << argv[2] << "\n";
+        return 1;
+    }
+    GameRecordReader reader(input);
+    ChessGame game, generator;
+    game.setConsoleOutput(false);
+    generator.setConsoleOutput(false);
+
+    Clock::time_point start = Clock::now();
+    uint64_t games = 0, moves = 0, mismatches = 0;
+    vector<Move> recorded;
+    RandomGame reproduced;
+    while (reader.beginGame()) {
+        games++;
+        recorded.clear();
+
+        Move move;
+        if (!game.loadPlayableState(reader.getStartFen().c_str())) {
+            while (reader.nextMove(move)) {} // Skip the moves of a game that cannot be replayed
+            if (mismatches++ < maxMismatchesListed) {
+                cout << "game " << games << ": invalid starting position " << reader.getStartFen() << "\n";
+            }
+            continue;
+        }
+
+        bool allLegal = true;
+        while (reader.nextMove(move)) {
+            recorded.push_back(move);
+            allLegal = game.submitMove(move) && allLegal;
+        }
+        moves += recorded.size();
+
+        // A decisive result must leave the game over; only a draw by repetition is not detected by ChessGame
+        bool stateAgrees = (reader.getResult() == drawnGame || !game.isInProgress());
+        bool seedAgrees = true;
+        if (reader.hasSeed()) {
+            generator.loadPlayableState(reader.getStartFen().c_str()); // Already loaded into 'game' above
+            playRandomGame(generator, reader.getSeed(), reproduced);
+            seedAgrees = (reproduced.moves == recorded && reproduced.result == reader.getResult());
+        }
+
+        if (!allLegal || !stateAgrees || !seedAgrees) {
+            if (mismatches++ < maxMismatchesListed) {
+                cout << "game " << games << (reader.hasSeed() ? " (seed " + to_string(reader.getSeed()) + ")" : string())
+                     << ":" << (allLegal ? "" : " illegal move") << (stateAgrees ? "" : " game state disagrees with result")
+                     << (seedAgrees ? "" : " not reproduced by its seed") << "\n";
+            }
+        }
+    }
+
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+    cout << "Verified " << games << " games (" << moves << " moves) in " << seconds << " s: "
+         << mismatches << " mismatches\n";
+    return (mismatches == 0 ? 0 : 2);
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 4 && strcmp(argv[1], "generate") == 0) {
+        return generateGames(argc, argv);
+    }
+    if (argc == 3 && strcmp(argv[1], "verify") == 0) {
+        return verifyGames(argv);
+    }
+    cerr << "Usage: " << argv[0] << " generate <record file> <games> [threads] [first seed] [start FEN]\n"
+         << "       " << argv[0] << " verify <record file>\n";
+    return 1;
+}
@@ -0,0 +1,132 @@
+/*
+ * RandomGames.cpp - Implementation file for generating random legal games in bulk.
+ */
+
+#include "RandomGames.h"
+#include "Zobrist.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// The number of bytes of encoded games a worker buffers before appending them to the stream
+static const size_t flushThreshold = 1 << 16;
+
+/* PLAYS RANDOM LEGAL MOVES UNTIL THE GAME ENDS, THEN TAKES THEM BACK */
+void playRandomGame(ChessGame& game, uint64_t seed, RandomGame& randomGame) {
+    randomGame.seed = seed;
+    randomGame.moves.clear();
+    uint64_t randomState = seed;
+
+    vector<ChessGame::MoveUndo> undos; // Captured pieces stay allocated until their move is taken back
+    vector<uint64_t> hashes = {game.positionHash()}; // The hash of every position in the game, for repetitions
+    Move moveList[maxLegalMoves];
+
+    while (true) {
+        int count = game.generateLegalMoves(moveList);
+        if (count == 0) {
+            bool checkmate = game.activeColourInCheck();
+            randomGame.ending = (checkmate ? checkmateEnding : stalemateEnding);
+            randomGame.result = (!checkmate ? drawnGame : (game.getTurn() == white ? blackWins : whiteWins));
+            break;
+        }
+        if (game.getHalfMoveCounter() >= 100) {
+            randomGame.ending = fiftyMoveEnding;
+            randomGame.result = drawnGame;
+            break;
+        }
+
+        if (ChessGame::countRepetitions(hashes, game.getHalfMoveCounter()) >= 3) {
+            randomGame.ending = repetitionEnding;
+            randomGame.result = drawnGame;
+            break;
+        }
+
+        // Generation order depends on the order of the piece lists, which a game's history can change,
+        // so the moves are sorted to make the game depend only on the start position and the seed
+        sort(moveList, moveList + count, [](Move first, Move second) { return first.getRaw() < second.getRaw(); });
+        Move move = moveList[splitMix64(randomState) % count];
+        undos.emplace_back();
+        game.makeLegalMove(move, undos.back());
+        randomGame.moves.push_back(move);
+        hashes.push_back(game.positionHash());
+    }
+
+    while (!undos.empty()) {
+        game.unmakeLegalMove(undos.back());
+        undos.pop_back();
+    }
+}
+
+/* GENERATES RANDOM GAMES ACROSS WORKER THREADS, STREAMING THEM TO A GAME RECORD STREAM */
+RandomGameStatistics generateRandomGames(const char* startFen, uint64_t gameCount, uint64_t firstSeed,
+                                         ostream& stream, unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = max(thread::hardware_concurrency(), 1u);
+    }
+    threadCount = static_cast<unsigned>(min<uint64_t>(threadCount, max<uint64_t>(gameCount, 1)));
+
+    RandomGameStatistics statistics;
+    atomic<uint64_t> nextGame(0);
+    mutex streamMutex; // Guards the stream and the statistics
+
+    auto generateGames = [&]() {
+        ChessGame game;
+        game.setConsoleOutput(false);
+        game.loadState(startFen);
+
+        RandomGame randomGame;
+        RandomGameStatistics local;
+        ostringstream buffer;
+        GameRecordWriter writer(buffer);
+
+        auto flush = [&]() {
+            lock_guard<mutex> lock(streamMutex);
+            string bytes = buffer.str();
+            stream.write(bytes.data(), bytes.size());
+            buffer.str(string());
+        };
+
+        for (uint64_t index = nextGame++; index < gameCount; index = nextGame++) {
+            playRandomGame(game, firstSeed + index, randomGame);
+
+            writer.beginGame(startFen, randomGame.seed);
+            for (Move move : randomGame.moves) {
+                writer.addMove(move);
+            }
+            writer.endGame(randomGame.result);
+
+            local.games++;
+            local.moves += randomGame.moves.size();
+            local.endings[randomGame.ending]++;
+            if (buffer.tellp() >= static_cast<streamoff>(flushThreshold)) {
+                flush();
+            }
+        }
+        flush();
+
+        lock_guard<mutex> lock(streamMutex);
+        statistics.games += local.games;
+        statistics.moves += local.moves;
+        for (int ending = 0; ending < 4; ending++) {
+            statistics.endings[ending] += local.endings[ending];
+        }
+    };
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (unsigned index = 1; index < threadCount; index++) {
+        workers.emplace_back(generateGames);
+    }
+    generateGames(); // The calling thread works too
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    statistics.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return statistics;
+}
@@ -0,0 +1,71 @@
+/*
+ * RandomGames.h - Header file for generating random legal games in bulk, for load testing
+ * game servers and fuzzing the rules engine.
+ */
+
+#ifndef RANDOMGAMES_H
+#define RANDOMGAMES_H
+
+#include "ChessGame.h"
+#include "GameRecord.h"
+#include "Move.h"
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/*
+ * Enum representing how a random game ended.
+ */
+enum GameEnding : uint8_t {checkmateEnding, stalemateEnding, fiftyMoveEnding, repetitionEnding};
+
+/*
+ * A game of uniformly random legal moves, played to termination.
+ */
+struct RandomGame {
+    uint64_t seed; // The seed the game was played from; the same seed and start position replay the same game
+    std::vector<Move> moves; // The moves of the game
+    GameEnding ending; // How the game ended
+    GameResult result; // The result of the game
+};
+
+/*
+ * Counters describing a run of generateRandomGames().
+ */
+struct RandomGameStatistics {
+    uint64_t games = 0; // The number of games generated
+    uint64_t moves = 0; // The number of moves played across every game
+    uint64_t endings[4] = {0, 0, 0, 0}; // The number of games ending each way, indexed by GameEnding
+    double seconds = 0; // The time taken
+};
+
+/*
+ * Plays a game of uniformly random legal moves from the current position of a chess game until
+ * it ends by checkmate, stalemate, the 50-move rule or threefold repetition. Moves are made
+ * directly on the board with makeLegalMove(), without validation or output, and are taken back
+ * at the end, so the chess game is left in the position it started from.
+ *
+ * @param game The chess game to play in (loaded, with console output disabled).
+ * @param seed The seed of the random moves.
+ * @param randomGame A reference to store the game in.
+ */
+void playRandomGame(ChessGame& game, uint64_t seed, RandomGame& randomGame);
+
+/*
+ * Generates random games from a start position across worker threads and streams them to a
+ * binary game record stream, each with its seed. Game 'index' is played from seed
+ * (firstSeed + index), so any game can be reproduced alone whichever thread played it. Each
+ * worker encodes its games into a local buffer and appends the buffer to the stream under a
+ * lock once it is large, so games appear in the order they were finished.
+ *
+ * @param startFen The FEN string of the position every game starts from (must be a valid position).
+ * @param gameCount The number of games to generate.
+ * @param firstSeed The seed of the first game.
+ * @param stream The stream to write the games to (opened in binary mode).
+ * @param threadCount The number of worker threads (0 to use one per hardware thread).
+ *
+ * @return The number of games and moves generated, how the games ended and the time taken.
+ */
+RandomGameStatistics generateRandomGames(const char* startFen, uint64_t gameCount, uint64_t firstSeed,
+                                         std::ostream& stream, unsigned threadCount = 0);
+
+#endif
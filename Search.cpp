@@ -0,0 +1,324 @@
+/*
+ * Search.cpp - Implementation file for the Search class, an iterative-deepening
+ * alpha-beta search over a ChessGame.
+ */
+
+#include "Search.h"
+#include <algorithm>
+
+using namespace std;
+
+// The value of each type of piece in centipawns, for ordering captures (indexed by PieceType)
+static const int orderingValues[] = {100, 500, 320, 330, 900, 2000};
+
+// The number of positions visited between polls of the stop condition (a power of two)
+static const uint64_t stopPollInterval = 4096;
+
+// The number of entries in each search's pawn hash table (a power of two)
+static const size_t pawnTableEntries = 4096;
+
+/*
+ * Converts a score to the form stored in the transposition table, in which a mate is
+ * counted from the stored position rather than from the root of the search.
+ */
+static int scoreToTable(int score, int ply) {
+    return (score >= mateThreshold ? score + ply : (score <= -mateThreshold ? score - ply : score));
+}
+
+/*
+ * Converts a score read from the transposition table back to a score from the root.
+ */
+static int scoreFromTable(int score, int ply) {
+    return (score >= mateThreshold ? score - ply : (score <= -mateThreshold ? score + ply : score));
+}
+
+
+/****************************** Search - Member Function Definitions ******************************/
+
+/* PARAMETERISED CONSTRUCTOR */
+Search::Search(ChessGame& game, TranspositionTable& table) : game(game), table(table), pawnTable(pawnTableEntries) {}
+
+/* SETS THE CONDITION POLLED TO END A DEPTH EARLY */
+void Search::setStopCondition(function<bool()> condition) {
+    shouldStop = move(condition);
+}
+
+/* SEARCHES THE CURRENT POSITION TO A GIVEN DEPTH */
+bool Search::searchDepth(int depth, SearchResult& result) {
+    int lineCount = 0;
+    return searchLines(depth, 1, &result, lineCount);
+}
+
+/* SEARCHES THE CURRENT POSITION TO A GIVEN DEPTH FOR THE BEST FEW DISTINCT LINES */
+bool Search::searchLines(int depth, int maxLines, SearchResult* lines, int& lineCount) {
+    stopped = false;
+    depth = min(max(depth, 1), maxSearchDepth - 1);
+
+    Move moveList[maxLegalMoves];
+    int legalCount = game.generateLegalMoves(moveList);
+    if (legalCount == 0) { // Checkmate or stalemate
+        lines[0] = SearchResult();
+        lines[0].depth = depth;
+        lines[0].score = (game.activeColourInCheck() ? -mateScore : 0);
+        lines[0].nodes = nodes;
+        lineCount = 1;
+        return true;
+    }
+
+    int count = 0;
+    for (int index = 0; index < legalCount; index++) {
+        if (find(excludedRootMoves.begin(), excludedRootMoves.end(), moveList[index]) == excludedRootMoves.end()) {
+            moveList[count++] = moveList[index];
+        }
+    }
+    uint64_t hash = game.positionHash();
+    TranspositionEntry entry;
+    orderMoves(moveList, count, table.probe(hash, entry) ? entry.bestMove : Move());
+
+    // Find each line in turn, skipping the root moves of the lines already found
+    int found = min(maxLines, count);
+    vector<SearchResult> results(found);
+    bool chosen[maxLegalMoves] = {false};
+    ChessGame::MoveUndo undo;
+    for (int line = 0; line < found; line++) {
+        int alpha = -mateScore - 1;
+        int bestIndex = -1;
+        for (int index = 0; index < count; index++) {
+            if (chosen[index]) {
+                continue;
+            }
+            game.makeLegalMove(moveList[index], undo);
+            int score = -alphaBeta(depth - 1, -mateScore - 1, -alpha, 1);
+            game.unmakeLegalMove(undo);
+
+            if (stopped) {
+                return false;
+            }
+            if (score > alpha || bestIndex == -1) {
+                alpha = max(alpha, score);
+                bestIndex = index;
+            }
+        }
+        chosen[bestIndex] = true;
+
+        results[line].depth = depth;
+        results[line].bestMove = moveList[bestIndex];
+        results[line].score = alpha;
+        results[line].nodes = nodes;
+        extractPrincipalVariation(results[line]);
+    }
+
+    if (excludedRootMoves.empty()) { // The stored best move orders the next depth
+        table.store(TranspositionEntry{hash, results[0].bestMove, static_cast<int16_t>(results[0].score), static_cast<int8_t>(depth), exactScore});
+    }
+    copy(results.begin(), results.end(), lines);
+    lineCount = found;
+    return true;
+}
+
+/* SETS THE ROOT MOVES WHICH ARE NOT TO BE SEARCHED */
+void Search::setExcludedRootMoves(const Move* moves, int count) {
+    excludedRootMoves.assign(moves, moves + count);
+}
+
+/* ENABLES OR DISABLES THE PAWN-STRUCTURE TERMS OF THE EVALUATION */
+void Search::setPawnStructureEvaluation(bool enabled) {
+    pawnStructureEvaluation = enabled;
+}
+
+/* GETTER FOR THE NUMBER OF POSITIONS VISITED */
+uint64_t Search::getNodes() const {
+    return nodes;
+}
+
+/* GETTER FOR THE PAWN HASH TABLE'S USAGE COUNTERS */
+PawnHashStatistics Search::getPawnHashStatistics() const {
+    return pawnTable.getStatistics();
+}
+
+/* SCORES THE CURRENT POSITION STATICALLY */
+int Search::evaluate() {
+    return game.materialBalance() + (pawnStructureEvaluation ? pawnTable.evaluate(game) : 0);
+}
+
+/* SCORES A POSITION BY NEGAMAX ALPHA-BETA SEARCH */
+int Search::alphaBeta(int depth, int alpha, int beta, int ply) {
+    if (depth <= 0) {
+        return quiescence(alpha, beta, ply);
+    }
+    if (checkStop()) {
+        return 0;
+    }
+    if (game.getHalfMoveCounter() >= 100) { // Draw by the 50-move rule
+        return 0;
+    }
+    if (ply >= maxSearchDepth - 1) {
+        return evaluate();
+    }
+
+    // Use a stored result if it was searched deeply enough and its bound settles this window
+    uint64_t hash = game.positionHash();
+    TranspositionEntry entry;
+    Move hashMove;
+    if (table.probe(hash, entry)) {
+        hashMove = entry.bestMove;
+        int score = scoreFromTable(entry.score, ply);
+        if (entry.depth >= depth && (entry.bound == exactScore || (entry.bound == lowerBound && score >= beta) ||
+                                     (entry.bound == upperBound && score <= alpha))) {
+            return score;
+        }
+    }
+
+    Move moveList[maxLegalMoves];
+    int count = game.generateLegalMoves(moveList);
+    if (count == 0) { // Checkmate (the sooner the better) or stalemate
+        return (game.activeColourInCheck() ? -(mateScore - ply) : 0);
+    }
+    orderMoves(moveList, count, hashMove);
+
+    int originalAlpha = alpha;
+    int bestScore = -mateScore - 1;
+    Move bestMove = moveList[0];
+    ChessGame::MoveUndo undo;
+    for (int index = 0; index < count; index++) {
+        game.makeLegalMove(moveList[index], undo);
+        int score = -alphaBeta(depth - 1, -beta, -alpha, ply + 1);
+        game.unmakeLegalMove(undo);
+
+        if (stopped) {
+            return 0;
+        }
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = moveList[index];
+        }
+        alpha = max(alpha, score);
+        if (alpha >= beta) { // The opponent will avoid this position
+            break;
+        }
+    }
+
+    ScoreBound bound = (bestScore <= originalAlpha ? upperBound : (bestScore >= beta ? lowerBound : exactScore));
+    table.store(TranspositionEntry{hash, bestMove, static_cast<int16_t>(scoreToTable(bestScore, ply)), static_cast<int8_t>(depth), bound});
+    return bestScore;
+}
+
+/* SCORES A POSITION BY SEARCHING CAPTURES AND PROMOTIONS UNTIL IT IS QUIET */
+int Search::quiescence(int alpha, int beta, int ply) {
+    if (checkStop()) {
+        return 0;
+    }
+
+    // The side to move may decline every capture
+    int standPat = evaluate();
+    if (standPat >= beta || ply >= maxSearchDepth - 1) {
+        return standPat;
+    }
+    alpha = max(alpha, standPat);
+
+    Move moveList[maxLegalMoves];
+    int count = game.generateLegalMoves(moveList);
+    int tacticalCount = 0;
+    for (int index = 0; index < count; index++) {
+        if (isTactical(moveList[index])) {
+            moveList[tacticalCount++] = moveList[index];
+        }
+    }
+    orderMoves(moveList, tacticalCount, Move());
+
+    ChessGame::MoveUndo undo;
+    for (int index = 0; index < tacticalCount; index++) {
+        game.makeLegalMove(moveList[index], undo);
+        int score = -quiescence(-beta, -alpha, ply + 1);
+        game.unmakeLegalMove(undo);
+
+        if (stopped) {
+            return 0;
+        }
+        if (score >= beta) {
+            return score;
+        }
+        alpha = max(alpha, score);
+    }
+    return alpha;
+}
+
+/* ORDERS MOVES: HASH MOVE, THEN CAPTURES AND PROMOTIONS, THEN QUIET MOVES */
+void Search::orderMoves(Move* moveList, int count, Move hashMove) const {
+    int scores[maxLegalMoves];
+    for (int index = 0; index < count; index++) {
+        Move move = moveList[index];
+        const ChessPiece* attacker = game.chessBoard[move.getOrigin() / 8][move.getOrigin() % 8];
+        const ChessPiece* victim = game.chessBoard[move.getDestination() / 8][move.getDestination() % 8];
+
+        int score = 0;
+        if (move == hashMove) {
+            score = 1000000;
+        }
+        else if (victim != nullptr) {
+            score = 100000 + orderingValues[victim->getType()] * 16 - orderingValues[attacker->getType()] / 16;
+        }
+        else if (move.getPromotion() != noPromotion || isTactical(move)) { // Promotions and en passant
+            score = 100000 + orderingValues[promotionPieceType(move.getPromotion())];
+        }
+        scores[index] = score;
+    }
+
+    // Insertion sort, as move lists are short and often nearly ordered already
+    for (int index = 1; index < count; index++) {
+        Move move = moveList[index];
+        int score = scores[index];
+        int position = index;
+        while (position > 0 && scores[position - 1] < score) {
+            moveList[position] = moveList[position - 1];
+            scores[position] = scores[position - 1];
+            position--;
+        }
+        moveList[position] = move;
+        scores[position] = score;
+    }
+}
+
+/* DETERMINES WHETHER A MOVE CAPTURES OR PROMOTES */
+bool Search::isTactical(Move move) const {
+    int origin = move.getOrigin(), destination = move.getDestination();
+    if (move.getPromotion() != noPromotion || game.chessBoard[destination / 8][destination % 8] != nullptr) {
+        return true;
+    }
+    // An en passant capture is a diagonal pawn move to an empty square
+    const ChessPiece* piece = game.chessBoard[origin / 8][origin % 8];
+    return piece->getType() == pawn && origin % 8 != destination % 8;
+}
+
+/* POLLS THE STOP CONDITION EVERY FEW THOUSAND POSITIONS */
+bool Search::checkStop() {
+    if ((++nodes & (stopPollInterval - 1)) == 0 && shouldStop && shouldStop()) {
+        stopped = true;
+    }
+    return stopped;
+}
+
+/* MAKES A LINE'S BEST MOVE AND FOLLOWS THE STORED BEST MOVES FROM THE RESULTING POSITION */
+void Search::extractPrincipalVariation(SearchResult& result) {
+    ChessGame::MoveUndo undos[maxSearchDepth];
+    result.principalVariation[0] = result.bestMove;
+    game.makeLegalMove(result.bestMove, undos[0]);
+    int length = 1;
+
+    TranspositionEntry entry;
+    while (length < result.depth && table.probe(game.positionHash(), entry) && !entry.bestMove.isNull()) {
+        // A stored move may belong to a different position with a colliding slot, so check it is legal
+        Move moveList[maxLegalMoves];
+        int count = game.generateLegalMoves(moveList);
+        if (find(moveList, moveList + count, entry.bestMove) == moveList + count) {
+            break;
+        }
+        result.principalVariation[length] = entry.bestMove;
+        game.makeLegalMove(entry.bestMove, undos[length]);
+        length++;
+    }
+    for (int index = length - 1; index >= 0; index--) {
+        game.unmakeLegalMove(undos[index]);
+    }
+    result.principalVariationLength = length;
+}
@@ -0,0 +1,195 @@
+/*
+ * Search.h - Header file for the Search class, an iterative-deepening alpha-beta
+ * search over a ChessGame, with a material and pawn-structure evaluation, a capture-only
+ * quiescence search and a transposition table.
+ */
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "ChessGame.h"
+#include "Move.h"
+#include "PawnHashTable.h"
+#include "TranspositionTable.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// The greatest depth (in plies) that a search may reach, including its quiescence search
+const int maxSearchDepth = 64;
+
+// The score of delivering checkmate immediately; a mate in N plies scores (mateScore - N)
+const int mateScore = 30000;
+
+// Any score at least this large (in magnitude) is a forced mate
+const int mateThreshold = mateScore - maxSearchDepth;
+
+/*
+ * The result of searching the current position to a single depth.
+ */
+struct SearchResult {
+    int depth = 0; // The depth searched to (0 if no depth was completed)
+    Move bestMove; // The best move found (the null move if the side to move has no legal moves)
+    int score = 0; // The score in centipawns from the perspective of the side to move (see mateScore)
+    uint64_t nodes = 0; // The number of positions visited so far by the search
+    Move principalVariation[maxSearchDepth]; // The expected line of play, starting with bestMove
+    int principalVariationLength = 0; // The number of moves in 'principalVariation'
+};
+
+
+/****************************** Class Search ******************************/
+
+class Search final {
+
+    public:
+        /*
+         * Parameterised constructor for a search of the current position of a game. The game is
+         * changed during the search (by making and taking back moves) and restored after each depth.
+         *
+         * @param game The game whose current position to search.
+         * @param table The transposition table to use, which is kept between depths.
+         */
+        Search(ChessGame& game, TranspositionTable& table);
+
+        /*
+         * Sets a condition polled regularly during the search (e.g. a deadline or a cancellation
+         * token). Once it returns true, the depth being searched is abandoned.
+         *
+         * @param shouldStop The condition (an empty function to never stop early).
+         */
+        void setStopCondition(std::function<bool()> shouldStop);
+
+        /*
+         * Searches the current position to a given depth. Depths are expected to be searched in
+         * increasing order, so that each depth orders its moves from the results of the last.
+         *
+         * @param depth The number of plies to search before the quiescence search (1 to maxSearchDepth).
+         * @param result A reference to store the result in (left unchanged if the search is stopped).
+         *
+         * @return true if the depth was completed; false if the stop condition ended it.
+         */
+        bool searchDepth(int depth, SearchResult& result);
+
+        /*
+         * Searches the current position to a given depth for the best few distinct lines (multi-PV).
+         * Each line is searched with the root moves of the lines before it excluded, sharing the
+         * transposition table and move ordering, so later lines reuse most of the work of earlier ones.
+         *
+         * @param depth The number of plies to search before the quiescence search (1 to maxSearchDepth).
+         * @param maxLines The greatest number of lines to find.
+         * @param lines An array of at least 'maxLines' results to store the lines in, best first
+         *              (left unchanged if the search is stopped).
+         * @param lineCount A reference to store the number of lines found in (fewer than 'maxLines'
+         *                  if there are fewer legal moves).
+         *
+         * @return true if the depth was completed; false if the stop condition ended it.
+         */
+        bool searchLines(int depth, int maxLines, SearchResult* lines, int& lineCount);
+
+        /*
+         * Sets root moves which are not to be searched (for example, to find the best alternative
+         * to a move already chosen). A search whose every legal move is excluded finds no lines.
+         *
+         * @param moves The moves to exclude.
+         * @param count The number of moves to exclude.
+         */
+        void setExcludedRootMoves(const Move* moves, int count);
+
+        /*
+         * Enables or disables the pawn-structure terms of the evaluation (enabled by default), so
+         * that configurations of the engine can be compared by playing them against each other.
+         *
+         * @param enabled true to score material and pawn structure; false to score material alone.
+         */
+        void setPawnStructureEvaluation(bool enabled);
+
+        /*
+         * Getter function for the number of positions visited.
+         *
+         * @return The number of positions visited since the search was constructed.
+         */
+        uint64_t getNodes() const;
+
+        /*
+         * Getter function for the usage counters of the search's pawn hash table.
+         *
+         * @return The number of pawn-structure evaluations found in the table and computed since the search was constructed.
+         */
+        PawnHashStatistics getPawnHashStatistics() const;
+
+    private:
+        ChessGame& game; // The game being searched
+        TranspositionTable& table; // The transposition table
+        std::function<bool()> shouldStop; // The stop condition (empty to never stop early)
+        bool stopped = false; // Indicates that the stop condition has ended the current depth
+        uint64_t nodes = 0; // The number of positions visited
+        std::vector<Move> excludedRootMoves; // Root moves which are not searched
+        PawnHashTable pawnTable; // The pawn-structure evaluations, owned by the search (and so by the thread running it)
+        bool pawnStructureEvaluation = true; // Indicates that the evaluation includes the pawn-structure terms
+
+        /*
+         * Scores the current position statically: the material balance plus the pawn-structure terms.
+         *
+         * @return The score in centipawns from the perspective of the side to move.
+         */
+        int evaluate();
+
+        /*
+         * Scores a position by negamax alpha-beta search.
+         *
+         * @param depth The remaining depth (the quiescence search starts at zero).
+         * @param alpha The score the side to move is already assured of.
+         * @param beta The score the opponent is already assured of.
+         * @param ply The distance from the root of the search.
+         *
+         * @return The score from the perspective of the side to move.
+         */
+        int alphaBeta(int depth, int alpha, int beta, int ply);
+
+        /*
+         * Scores a position by searching only captures and promotions until the position is quiet.
+         *
+         * @param alpha The score the side to move is already assured of.
+         * @param beta The score the opponent is already assured of.
+         * @param ply The distance from the root of the search.
+         *
+         * @return The score from the perspective of the side to move.
+         */
+        int quiescence(int alpha, int beta, int ply);
+
+        /*
+         * Orders moves so that the hash move comes first, followed by captures (most valuable
+         * victim first, then least valuable attacker) and promotions, then quiet moves.
+         *
+         * @param moveList The moves to order.
+         * @param count The number of moves.
+         * @param hashMove The best move stored for the position (the null move if none).
+         */
+        void orderMoves(Move* moveList, int count, Move hashMove) const;
+
+        /*
+         * Determines whether a move captures a piece or promotes a pawn.
+         *
+         * @param move The move (legal in the current position).
+         *
+         * @return true if the move captures or promotes; false otherwise.
+         */
+        bool isTactical(Move move) const;
+
+        /*
+         * Polls the stop condition every few thousand positions.
+         *
+         * @return true if the current depth is to be abandoned; false otherwise.
+         */
+        bool checkStop();
+
+        /*
+         * Makes a line's best move and follows the best moves stored in the transposition table from
+         * the resulting position.
+         *
+         * @param result A reference to the result to store the line in (starting with its best move).
+         */
+        void extractPrincipalVariation(SearchResult& result);
+};
+
+#endif
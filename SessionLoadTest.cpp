@@ -0,0 +1,113 @@
+/*
+ * SessionLoadTest.cpp - Synthetic load generator for SessionManager. Hosts many games
+ * across the shards, drives them from several client threads and reports the
+ * p50/p99 round-trip latency of a move.
+ *
+ * Usage: loadtest [sessions] [moves per session] [shards] [client threads] [move cache positions]
+ */
+
+#include "SessionManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+// A cycle of knight moves that returns to the starting position every four plies
+static const char* const knightShuffle[4][2] = {{"G1", "F3"}, {"G8", "F6"}, {"F3", "G1"}, {"F6", "G8"}};
+static const char* const startingPosition = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// Reload each game before the knight shuffle would trigger the 50-move rule
+static const int pliesBeforeReload = 96;
+
+int main(int argc, char** argv) {
+
+    int sessionCount = (argc > 1 ? atoi(argv[1]) : 10000);
+    int movesPerSession = (argc > 2 ? atoi(argv[2]) : 200);
+    unsigned shardCount = (argc > 3 ? atoi(argv[3]) : 0);
+    int clientCount = (argc > 4 ? atoi(argv[4]) : 8);
+    size_t cachePositions = (argc > 5 ? atol(argv[5]) : 0);
+
+    unique_ptr<MoveCache> moveCache;
+    if (cachePositions > 0) {
+        moveCache = make_unique<MoveCache>(cachePositions);
+    }
+    SessionManager manager(shardCount, true, moveCache.get());
+
+    // CREATE AND LOAD EVERY SESSION
+    vector<uint64_t> sessionIDs(sessionCount);
+    vector<future<bool>> loads;
+    for (int session = 0; session < sessionCount; session++) {
+        sessionIDs[session] = manager.createSession();
+        loads.push_back(manager.loadSession(sessionIDs[session], startingPosition));
+    }
+    for (future<bool>& load : loads) {
+        load.get();
+    }
+
+    // DRIVE THE SESSIONS FROM SEVERAL CLOSED-LOOP CLIENTS (EACH OWNS A DISJOINT SET OF SESSIONS)
+    vector<vector<double>> latencies(clientCount);
+    vector<int> rejected(clientCount, 0);
+    vector<thread> clients;
+
+    Clock::time_point start = Clock::now();
+
+    for (int client = 0; client < clientCount; client++) {
+        clients.emplace_back([&, client]() {
+            latencies[client].reserve((sessionCount / clientCount + 1) * movesPerSession);
+
+            for (int ply = 0; ply < movesPerSession; ply++) {
+                for (int session = client; session < sessionCount; session += clientCount) {
+
+                    if (ply > 0 && ply % pliesBeforeReload == 0) {
+                        manager.loadSession(sessionIDs[session], startingPosition).get();
+                    }
+
+                    const char* const* move = knightShuffle[ply % 4];
+                    Clock::time_point submitted = Clock::now();
+                    bool accepted = manager.submitMove(sessionIDs[session], move[0], move[1]).get();
+                    latencies[client].push_back(chrono::duration<double, micro>(Clock::now() - submitted).count());
+
+                    if (!accepted) {
+                        rejected[client]++;
+                    }
+                }
+            }
+        });
+    }
+    for (thread& client : clients) {
+        client.join();
+    }
+
+    double elapsed = chrono::duration<double>(Clock::now() - start).count();
+
+    // REPORT
+    vector<double> all;
+    int totalRejected = 0;
+    for (int client = 0; client < clientCount; client++) {
+        all.insert(all.end(), latencies[client].begin(), latencies[client].end());
+        totalRejected += rejected[client];
+    }
+    sort(all.begin(), all.end());
+
+    cout << "Sessions: " << sessionCount << ", shards: " << manager.getShardCount() << ", clients: " << clientCount << "\n";
+    cout << "Moves: " << all.size() << " (" << totalRejected << " rejected) in " << elapsed << " s = "
+         << static_cast<long>(all.size() / elapsed) << " moves/s\n";
+    if (!all.empty()) {
+        cout << "Move latency p50: " << all[all.size() / 2] << " us, p99: " << all[all.size() * 99 / 100]
+             << " us, max: " << all.back() << " us\n";
+    }
+    if (moveCache) {
+        MoveCacheStatistics statistics = moveCache->getStatistics();
+        cout << "Move cache hit rate: " << statistics.hitRate() * 100 << "% (" << statistics.hits << " hits, "
+             << statistics.misses << " misses, " << statistics.evictions << " evictions)\n";
+    }
+
+    return (totalRejected == 0 ? 0 : 1);
+}
@@ -0,0 +1,230 @@
+/*
+ * SessionManager.cpp - Implementation file for the SessionManager class which hosts
+ * many concurrent chess games, sharded by session ID across worker threads.
+ */
+
+#include "SessionManager.h"
+#include "PackedPosition.h"
+#include <cstring>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std;
+
+/*
+ * Determines whether a client's coordinate string names a square ("A1" to "H8").
+ */
+static bool isSquareCoordinate(const char* stringCoord) {
+    return stringCoord != nullptr && stringCoord[0] >= 'A' && stringCoord[0] <= 'H' && stringCoord[1] >= '1'
+           && stringCoord[1] <= '8' && stringCoord[2] == '\0';
+}
+
+
+/****************************** SessionManager - Member Function Definitions ******************************/
+
+/* CONSTRUCTOR - STARTS ONE (OPTIONALLY PINNED) WORKER THREAD PER SHARD */
+SessionManager::SessionManager(unsigned shardCount, bool pinThreads, MoveCache* moveCache) : nextSessionID(0), moveCache(moveCache) {
+
+    unsigned cores = thread::hardware_concurrency();
+    if (cores == 0) {
+        cores = 1;
+    }
+    if (shardCount == 0) {
+        shardCount = cores;
+    }
+
+    for (unsigned index = 0; index < shardCount; index++) {
+        shards.push_back(make_unique<Shard>());
+    }
+
+    for (unsigned index = 0; index < shardCount; index++) {
+        Shard& shard = *shards[index];
+        shard.worker = thread(runShard, ref(shard));
+
+#ifdef __linux__
+        if (pinThreads) { // Keep each shard's games in the caches of a single core
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            CPU_SET(index % cores, &cpuSet);
+            pthread_setaffinity_np(shard.worker.native_handle(), sizeof(cpu_set_t), &cpuSet);
+        }
+#else
+        (void) pinThreads;
+#endif
+    }
+}
+
+/* DESTRUCTOR - DRAINS AND STOPS EVERY SHARD */
+SessionManager::~SessionManager() {
+    for (unique_ptr<Shard>& shard : shards) {
+        {
+            lock_guard<mutex> lock(shard->queueMutex);
+            shard->stopping = true;
+        }
+        shard->queueReady.notify_one();
+    }
+    for (unique_ptr<Shard>& shard : shards) {
+        shard->worker.join();
+    }
+}
+
+/* CREATES A NEW SESSION ON THE SHARD THAT OWNS ITS ID */
+uint64_t SessionManager::createSession() {
+    uint64_t sessionID = nextSessionID++;
+    Shard& shard = shardFor(sessionID);
+
+    enqueue(shard, [this, &shard, sessionID]() {
+        unique_ptr<ChessGame> game = make_unique<ChessGame>();
+        game->setConsoleOutput(false);
+        game->setMoveCache(moveCache);
+        game->setHistoryLimit(sessionHistoryLimit);
+        shard.sessions[sessionID] = move(game);
+    });
+    return sessionID;
+}
+
+/* LOADS A FEN STRING INTO A SESSION */
+future<bool> SessionManager::loadSession(uint64_t sessionID, const string& fenString) {
+    Shard& shard = shardFor(sessionID);
+    shared_ptr<promise<bool>> result = make_shared<promise<bool>>();
+
+    // Parse on the caller's thread, so a malformed FEN string never reaches the shard
+    Position position;
+    if (!parseFen(fenString.c_str(), position)) {
+        result->set_value(false);
+        return result->get_future();
+    }
+
+    enqueue(shard, [&shard, sessionID, position, result]() {
+        ChessGame* game = findGame(shard, sessionID);
+        result->set_value(game != nullptr && game->restorePlayablePosition(position));
+    });
+    return result->get_future();
+}
+
+/* SUBMITS A MOVE TO A SESSION */
+future<bool> SessionManager::submitMove(uint64_t sessionID, const char* stringCoord1, const char* stringCoord2) {
+    Shard& shard = shardFor(sessionID);
+    shared_ptr<promise<bool>> result = make_shared<promise<bool>>();
+
+    // The game reads the board at the coordinates before validating them, so only squares are passed on
+    if (!isSquareCoordinate(stringCoord1) || !isSquareCoordinate(stringCoord2)) {
+        result->set_value(false);
+        return result->get_future();
+    }
+
+    // Copy the coordinates so that the caller's strings need not outlive the request
+    char origin[3] = {0}, destination[3] = {0};
+    strncpy(origin, stringCoord1, 2);
+    strncpy(destination, stringCoord2, 2);
+
+    enqueue(shard, [&shard, sessionID, origin, destination, result]() {
+        ChessGame* game = findGame(shard, sessionID);
+        result->set_value(game != nullptr && game->submitMove(origin, destination));
+    });
+    return result->get_future();
+}
+
+/* TAKES BACK MOVES IN A SESSION */
+future<int> SessionManager::undoMoves(uint64_t sessionID, int count) {
+    Shard& shard = shardFor(sessionID);
+    shared_ptr<promise<int>> result = make_shared<promise<int>>();
+
+    enqueue(shard, [&shard, sessionID, count, result]() {
+        ChessGame* game = findGame(shard, sessionID);
+        result->set_value(game != nullptr ? game->undoMoves(count) : 0);
+    });
+    return result->get_future();
+}
+
+/* REDOES MOVES TAKEN BACK IN A SESSION */
+future<int> SessionManager::redoMoves(uint64_t sessionID, int count) {
+    Shard& shard = shardFor(sessionID);
+    shared_ptr<promise<int>> result = make_shared<promise<int>>();
+
+    enqueue(shard, [&shard, sessionID, count, result]() {
+        ChessGame* game = findGame(shard, sessionID);
+        result->set_value(game != nullptr ? game->redoMoves(count) : 0);
+    });
+    return result->get_future();
+}
+
+/* QUERIES THE STATUS OF A SESSION */
+future<SessionStatus> SessionManager::querySession(uint64_t sessionID) {
+    Shard& shard = shardFor(sessionID);
+    shared_ptr<promise<SessionStatus>> result = make_shared<promise<SessionStatus>>();
+
+    enqueue(shard, [&shard, sessionID, result]() {
+        SessionStatus status;
+        ChessGame* game = findGame(shard, sessionID);
+        if (game != nullptr) {
+            status.exists = true;
+            status.inProgress = game->isInProgress();
+            status.turn = game->getTurn();
+            status.inCheck = game->isInCheck(status.turn);
+        }
+        result->set_value(status);
+    });
+    return result->get_future();
+}
+
+/* CLOSES A SESSION AND DELETES ITS GAME */
+future<bool> SessionManager::closeSession(uint64_t sessionID) {
+    Shard& shard = shardFor(sessionID);
+    shared_ptr<promise<bool>> result = make_shared<promise<bool>>();
+
+    enqueue(shard, [&shard, sessionID, result]() {
+        result->set_value(shard.sessions.erase(sessionID) != 0);
+    });
+    return result->get_future();
+}
+
+/* GETTER FOR THE NUMBER OF SHARDS */
+unsigned SessionManager::getShardCount() const {
+    return shards.size();
+}
+
+/* RETURNS THE SHARD THAT OWNS A SESSION */
+SessionManager::Shard& SessionManager::shardFor(uint64_t sessionID) {
+    return *shards[sessionID % shards.size()];
+}
+
+/* QUEUES A TASK ON A SHARD AND WAKES ITS WORKER */
+void SessionManager::enqueue(Shard& shard, function<void()> task) {
+    {
+        lock_guard<mutex> lock(shard.queueMutex);
+        shard.tasks.push_back(move(task));
+    }
+    shard.queueReady.notify_one();
+}
+
+/* WORKER LOOP - EXECUTES A SHARD'S TASKS IN SUBMISSION ORDER */
+void SessionManager::runShard(Shard& shard) {
+    deque<function<void()>> batch;
+
+    while (true) {
+        {
+            unique_lock<mutex> lock(shard.queueMutex);
+            shard.queueReady.wait(lock, [&shard]() { return shard.stopping || !shard.tasks.empty(); });
+            if (shard.tasks.empty()) { // Stopping and fully drained
+                break;
+            }
+            batch.swap(shard.tasks); // Take every queued task at once to keep the lock hold time short
+        }
+
+        for (function<void()>& task : batch) {
+            task();
+        }
+        batch.clear();
+    }
+    shard.sessions.clear();
+}
+
+/* RETURNS THE GAME FOR A SESSION OWNED BY A SHARD */
+ChessGame* SessionManager::findGame(Shard& shard, uint64_t sessionID) {
+    auto session = shard.sessions.find(sessionID);
+    return (session == shard.sessions.end() ? nullptr : session->second.get());
+}
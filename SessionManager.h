@@ -0,0 +1,194 @@
+/*
+ * SessionManager.h - Header file for the SessionManager class which hosts
+ * many concurrent chess games, sharded by session ID across worker threads.
+ */
+
+#ifndef SESSIONMANAGER_H
+#define SESSIONMANAGER_H
+
+#include "ChessGame.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// The number of moves each session can take back
+const int sessionHistoryLimit = 256;
+
+/*
+ * Snapshot of the status of a single hosted game, returned by SessionManager::querySession().
+ */
+struct SessionStatus {
+    bool exists = false; // Indicates whether a session with the requested ID exists
+    bool inProgress = false; // Indicates whether a game is loaded and has not yet ended
+    PieceColour turn = white; // The active colour of the game
+    bool inCheck = false; // Indicates whether the active colour is in check
+};
+
+
+/****************************** Class SessionManager ******************************/
+
+class SessionManager final {
+
+    public:
+        /*
+         * Parameterised constructor which starts one worker thread per shard. Each shard
+         * exclusively owns the games whose session ID maps to it, so requests for a given
+         * game are executed one after another on the same thread without locking the game.
+         *
+         * @param shardCount The number of shards (worker threads). Zero selects one per hardware thread.
+         * @param pinThreads true to pin each worker thread to a CPU core (shard index modulo core count).
+         * @param moveCache A legal move cache to share between every hosted game (nullptr for none).
+         */
+        SessionManager(unsigned shardCount = 0, bool pinThreads = true, MoveCache* moveCache = nullptr);
+
+        /*
+         * Destructor drains every shard's queue, stops the worker threads and deletes the hosted games.
+         */
+        ~SessionManager();
+
+        SessionManager(const SessionManager&) = delete;
+        SessionManager& operator=(const SessionManager&) = delete;
+
+        /*
+         * Creates a new (unloaded) game session on the shard that owns the returned ID.
+         *
+         * @return The ID of the new session.
+         */
+        uint64_t createSession();
+
+        /*
+         * Loads a FEN string into an existing session. The FEN string comes from a client, so it
+         * is parsed strictly and its position must be playable (see ChessGame::restorePlayablePosition())
+         * before the game is touched.
+         *
+         * @param sessionID The ID of the session to load.
+         * @param fenString The FEN string describing the state of the chess game to load.
+         *
+         * @return A future holding true if the session exists and was loaded; false (leaving the
+         *         session unchanged) if there is no such session or the FEN string is malformed or unplayable.
+         */
+        std::future<bool> loadSession(uint64_t sessionID, const std::string& fenString);
+
+        /*
+         * Submits a move to an existing session. Moves submitted for the same session are
+         * applied in the order they were submitted.
+         *
+         * @param sessionID The ID of the session to move in.
+         * @param stringCoord1 The string literal letter-integer coordinates (e.g. "A1") of the piece to move.
+         * @param stringCoord2 The string literal letter-integer coordinates (e.g. "B2") of the destination square.
+         *
+         * @return A future holding true if the session exists and the move was legal; false otherwise
+         *         (at once, without reaching the game, if either coordinate is not a square).
+         */
+        std::future<bool> submitMove(uint64_t sessionID, const char* stringCoord1, const char* stringCoord2);
+
+        /*
+         * Takes back the most recent moves of an existing session (a takeback), from the
+         * session's history of its last sessionHistoryLimit moves, rather than reloading the game.
+         *
+         * @param sessionID The ID of the session.
+         * @param count The number of moves to take back.
+         *
+         * @return A future holding the number of moves taken back (0 if there is no such session).
+         */
+        std::future<int> undoMoves(uint64_t sessionID, int count);
+
+        /*
+         * Makes again the moves of an existing session most recently taken back by undoMoves(),
+         * until another move is submitted.
+         *
+         * @param sessionID The ID of the session.
+         * @param count The number of moves to redo.
+         *
+         * @return A future holding the number of moves redone (0 if there is no such session).
+         */
+        std::future<int> redoMoves(uint64_t sessionID, int count);
+
+        /*
+         * Queries the status of an existing session.
+         *
+         * @param sessionID The ID of the session to query.
+         *
+         * @return A future holding the status of the session (exists = false if there is no such session).
+         */
+        std::future<SessionStatus> querySession(uint64_t sessionID);
+
+        /*
+         * Closes a session and deletes its game.
+         *
+         * @param sessionID The ID of the session to close.
+         *
+         * @return A future holding true if the session existed; false otherwise.
+         */
+        std::future<bool> closeSession(uint64_t sessionID);
+
+        /*
+         * Getter function for the number of shards.
+         *
+         * @return The number of shards (worker threads).
+         */
+        unsigned getShardCount() const;
+
+    private:
+        /*
+         * A shard owns a set of sessions and the single worker thread that executes every
+         * request for them. Only the task queue is shared with other threads.
+         */
+        struct Shard {
+            std::thread worker; // The thread that executes this shard's tasks
+            std::mutex queueMutex; // Guards 'tasks' and 'stopping'
+            std::condition_variable queueReady; // Signalled when a task is queued or the shard is stopping
+            std::deque<std::function<void()>> tasks; // Requests waiting to be executed, in submission order
+            bool stopping = false; // Indicates that the worker should exit once the queue is empty
+            std::unordered_map<uint64_t, std::unique_ptr<ChessGame>> sessions; // Games owned by this shard (worker thread only)
+        };
+
+        std::vector<std::unique_ptr<Shard>> shards; // The shards, indexed by sessionID modulo shard count
+        std::atomic<uint64_t> nextSessionID; // The ID to give to the next session created
+        MoveCache* moveCache; // The legal move cache shared between every hosted game (nullptr if none)
+
+        /*
+         * Obtains the shard that owns a given session.
+         *
+         * @param sessionID The ID of the session.
+         *
+         * @return A reference to the owning shard.
+         */
+        Shard& shardFor(uint64_t sessionID);
+
+        /*
+         * Appends a task to the queue of a shard and wakes its worker thread.
+         *
+         * @param shard The shard that is to execute the task.
+         * @param task The task to execute on the shard's worker thread.
+         */
+        void enqueue(Shard& shard, std::function<void()> task);
+
+        /*
+         * Executes a shard's tasks until the shard is stopped and its queue has been drained.
+         *
+         * @param shard The shard whose tasks to execute.
+         */
+        static void runShard(Shard& shard);
+
+        /*
+         * Obtains the game for a session owned by a shard. Must only be called on that shard's worker thread.
+         *
+         * @param shard The shard that owns the session.
+         * @param sessionID The ID of the session.
+         *
+         * @return A pointer to the game (nullptr if no such session exists).
+         */
+        static ChessGame* findGame(Shard& shard, uint64_t sessionID);
+};
+
+#endif
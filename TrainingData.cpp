@@ -0,0 +1,312 @@
+/*
+ * TrainingData.cpp - Implementation file for generating training data from self-play and
+ * for streaming it to and from the packed record format.
+ */
+
+#include "TrainingData.h"
+#include "ChessGame.h"
+#include "Search.h"
+#include "TranspositionTable.h"
+#include "Zobrist.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+static const char* const startingPosition = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+static const size_t readBlockRecords = 1 << 12; // The number of records a reader reads from a file at once
+static const size_t transpositionEntries = 1 << 16; // The size of each worker's transposition table
+
+/* PACKS A TRAINING RECORD INTO THE 32-BYTE RECORD FORMAT */
+void packTrainingRecord(const TrainingRecord& record, uint8_t* bytes) {
+    PackedPosition packed;
+    packPosition(record.position, packed);
+    uint16_t evaluation = static_cast<uint16_t>(record.evaluation);
+    packed.bytes[packedFreeOffset] = record.result;
+    packed.bytes[packedFreeOffset + 1] = static_cast<uint8_t>(evaluation & 0xFF);
+    packed.bytes[packedFreeOffset + 2] = static_cast<uint8_t>(evaluation >> 8);
+    memcpy(bytes, packed.bytes, trainingRecordSize);
+}
+
+/* UNPACKS A TRAINING RECORD FROM THE 32-BYTE RECORD FORMAT */
+bool unpackTrainingRecord(const uint8_t* bytes, TrainingRecord& record) {
+    PackedPosition packed;
+    memcpy(packed.bytes, bytes, trainingRecordSize);
+    record.result = static_cast<GameResult>(packed.bytes[packedFreeOffset]);
+    record.evaluation = static_cast<int16_t>(static_cast<uint16_t>(packed.bytes[packedFreeOffset + 1] | (packed.bytes[packedFreeOffset + 2] << 8)));
+    return unpackPosition(packed, record.position) && record.result <= drawnGame;
+}
+
+
+/****************************** TrainingDataWriter - Member Function Definitions ******************************/
+
+/* CONSTRUCTOR - CREATES THE SHARD FILES AND STARTS THE WRITER THREAD */
+TrainingDataWriter::TrainingDataWriter(const string& prefix, size_t shardCount, size_t maxQueuedBuffers)
+    : shards(max<size_t>(shardCount, 1)), maxQueuedBuffers(max<size_t>(maxQueuedBuffers, 1)) {
+    for (size_t index = 0; index < shards.size(); index++) {
+        char suffix[32];
+        snprintf(suffix, sizeof(suffix), "-%03zu.bin", index);
+        shards[index].open(prefix + suffix, ios::binary | ios::trunc);
+    }
+    writer = thread(&TrainingDataWriter::runWriter, this);
+}
+
+/* DESTRUCTOR - WRITES EVERY QUEUED BUFFER */
+TrainingDataWriter::~TrainingDataWriter() {
+    close();
+}
+
+/* DETERMINES WHETHER EVERY SHARD FILE WAS CREATED */
+bool TrainingDataWriter::isOpen() const {
+    return all_of(shards.begin(), shards.end(), [](const ofstream& shard) { return shard.is_open(); });
+}
+
+/* QUEUES A BUFFER TO BE WRITTEN, HANDING BACK AN EMPTY ONE */
+void TrainingDataWriter::write(vector<uint8_t>& buffer) {
+    if (buffer.empty()) {
+        return;
+    }
+    unique_lock<mutex> lock(queueMutex);
+    queueChanged.wait(lock, [this]() { return queued.size() < maxQueuedBuffers || stopping; });
+    queued.push_back(move(buffer));
+    buffer.clear();
+    if (!spare.empty()) {
+        buffer.swap(spare.back());
+        spare.pop_back();
+    }
+    queueChanged.notify_all();
+}
+
+/* WRITES EVERY QUEUED BUFFER AND STOPS THE WRITER THREAD */
+bool TrainingDataWriter::close() {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueChanged.notify_all();
+    if (writer.joinable()) {
+        writer.join();
+    }
+    for (ofstream& shard : shards) {
+        if (shard.is_open()) {
+            shard.close();
+            failed = failed || shard.fail();
+        }
+    }
+    return !failed;
+}
+
+/* GETTER FOR THE NUMBER OF BYTES WRITTEN */
+uint64_t TrainingDataWriter::getBytesWritten() {
+    lock_guard<mutex> lock(queueMutex);
+    return bytesWritten;
+}
+
+/* WRITES QUEUED BUFFERS UNTIL STOPPED AND DRAINED */
+void TrainingDataWriter::runWriter() {
+    unique_lock<mutex> lock(queueMutex);
+    while (true) {
+        queueChanged.wait(lock, [this]() { return !queued.empty() || stopping; });
+        if (queued.empty()) {
+            return;
+        }
+        vector<uint8_t> buffer = move(queued.front());
+        queued.pop_front();
+        ofstream& shard = shards[nextShard];
+        nextShard = (nextShard + 1) % shards.size();
+        queueChanged.notify_all(); // A worker waiting for room may queue another buffer while this one is written
+
+        lock.unlock();
+        shard.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        bool written = static_cast<bool>(shard);
+        lock.lock();
+
+        failed = failed || !written;
+        bytesWritten += (written ? buffer.size() : 0);
+        buffer.clear();
+        spare.push_back(move(buffer));
+    }
+}
+
+
+/****************************** TrainingDataReader - Member Function Definitions ******************************/
+
+/* CONSTRUCTOR */
+TrainingDataReader::TrainingDataReader(const vector<string>& paths) : paths(paths), block(readBlockRecords * trainingRecordSize) {}
+
+/* READS THE NEXT RECORD */
+bool TrainingDataReader::next(TrainingRecord& record) {
+    if (blockOffset == blockSize && !fillBlock()) {
+        return false;
+    }
+    if (!unpackTrainingRecord(block.data() + blockOffset, record)) {
+        failed = true;
+        blockOffset = blockSize = 0;
+        nextPath = paths.size();
+        return false;
+    }
+    blockOffset += trainingRecordSize;
+    return true;
+}
+
+/* DETERMINES WHETHER AN ERROR STOPPED THE READER */
+bool TrainingDataReader::hasFailed() const {
+    return failed;
+}
+
+/* REFILLS THE BLOCK, MOVING ON TO THE NEXT FILE WHEN ONE IS EXHAUSTED */
+bool TrainingDataReader::fillBlock() {
+    blockOffset = blockSize = 0;
+    while (!failed) {
+        if (input.is_open()) {
+            input.read(reinterpret_cast<char*>(block.data()), block.size());
+            blockSize = static_cast<size_t>(input.gcount());
+            if (blockSize % trainingRecordSize != 0) { // The file ends part way through a record
+                failed = true;
+                return false;
+            }
+            if (blockSize > 0) {
+                return true;
+            }
+            input.close();
+        }
+        if (nextPath == paths.size()) {
+            return false;
+        }
+        input.clear();
+        input.open(paths[nextPath++], ios::binary);
+        failed = !input.is_open();
+    }
+    return false;
+}
+
+
+/****************************** Training Data Generation ******************************/
+
+/*
+ * A sampled position waiting for the result of its game.
+ */
+struct PendingRecord {
+    Position position; // The position
+    int evaluation; // The search score from the side to move's point of view
+};
+
+/* PLAYS SELF-PLAY GAMES ACROSS WORKER THREADS, WRITING SAMPLED POSITIONS TO TRAINING DATA */
+TrainingDataStatistics generateTrainingData(const TrainingDataSettings& settings, TrainingDataWriter& writer) {
+    unsigned threadCount = settings.threadCount;
+    if (threadCount == 0) {
+        threadCount = max(thread::hardware_concurrency(), 1u);
+    }
+
+    TrainingDataStatistics statistics;
+    atomic<uint64_t> nextGame(0), positionsWritten(0);
+    mutex statisticsMutex; // Guards the statistics
+
+    auto playGames = [&]() {
+        ChessGame game;
+        game.setConsoleOutput(false);
+        game.loadState(startingPosition);
+        TranspositionTable table(transpositionEntries);
+        TrainingDataStatistics local;
+
+        vector<uint8_t> buffer;
+        buffer.reserve(settings.recordsPerBuffer * trainingRecordSize);
+        vector<PendingRecord> pending;
+        vector<uint64_t> hashes;
+        Move moveList[maxLegalMoves];
+        ChessGame::MoveUndo undo; // Moves are never taken back, so one undo record is reused
+
+        while (positionsWritten < settings.positions) {
+            uint64_t randomState = settings.firstSeed + nextGame++;
+            game.resetState(startingPosition);
+            table.clear();
+            Search search(game, table);
+            pending.clear();
+
+            // A random opening, restarted from the beginning in the rare case that it ends the game
+            for (int ply = 0; ply < settings.randomOpeningPlies; ply++) {
+                int count = game.generateLegalMoves(moveList);
+                if (count == 0) {
+                    game.resetState(startingPosition);
+                    ply = -1;
+                    continue;
+                }
+                sort(moveList, moveList + count, [](Move first, Move second) { return first.getRaw() < second.getRaw(); });
+                game.makeLegalMove(moveList[splitMix64(randomState) % count], undo);
+            }
+            hashes.assign(1, game.positionHash());
+
+            GameResult result = drawnGame;
+            for (int ply = 0; ply < settings.maxPlies; ply++) {
+                if (game.generateLegalMoves(moveList) == 0) {
+                    if (game.activeColourInCheck()) {
+                        result = (game.getTurn() == white ? blackWins : whiteWins);
+                    }
+                    break;
+                }
+                if (game.getHalfMoveCounter() >= 100) {
+                    break;
+                }
+
+                if (ChessGame::countRepetitions(hashes, game.getHalfMoveCounter()) >= 3) {
+                    break;
+                }
+
+                SearchResult searchResult;
+                for (int depth = 1; depth <= settings.searchDepth; depth++) {
+                    search.searchDepth(depth, searchResult);
+                }
+
+                Move best = searchResult.bestMove;
+                Position position = game.savePosition();
+                bool tactical = (position.squares[best.getDestination()] != '\0' || best.getPromotion() != noPromotion);
+                if (ply >= settings.skipPlies && !tactical && !game.activeColourInCheck()
+                    && (splitMix64(randomState) >> 11) * 0x1.0p-53 < settings.sampleRate) {
+                    pending.push_back({position, searchResult.score});
+                }
+
+                game.makeLegalMove(best, undo);
+                hashes.push_back(game.positionHash());
+                local.plies++;
+            }
+
+            // The result is known, so the game's records can be packed
+            for (const PendingRecord& entry : pending) {
+                TrainingRecord record{entry.position, static_cast<int16_t>(max(-32767, min(32767, entry.evaluation))), result};
+                buffer.resize(buffer.size() + trainingRecordSize);
+                packTrainingRecord(record, buffer.data() + buffer.size() - trainingRecordSize);
+                if (buffer.size() >= settings.recordsPerBuffer * trainingRecordSize) {
+                    writer.write(buffer);
+                }
+            }
+            positionsWritten += pending.size();
+            local.games++;
+            local.positions += pending.size();
+            local.results[result]++;
+        }
+        writer.write(buffer);
+
+        lock_guard<mutex> lock(statisticsMutex);
+        statistics.games += local.games;
+        statistics.plies += local.plies;
+        statistics.positions += local.positions;
+        for (int result = 0; result < 4; result++) {
+            statistics.results[result] += local.results[result];
+        }
+    };
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (unsigned index = 1; index < threadCount; index++) {
+        workers.emplace_back(playGames);
+    }
+    playGames(); // The calling thread plays too
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    statistics.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return statistics;
+}
@@ -0,0 +1,226 @@
+/*
+ * TrainingData.h - Header file for generating training data for evaluation weights from
+ * self-play, and for the fixed-size packed record format it is stored in.
+ *
+ * A training data file is a sequence of 32-byte records, each a packed position (see
+ * PackedPosition.h) whose free bytes hold:
+ *
+ *     1-byte GameResult of the game the position was played in (byte 27)
+ *     2-byte evaluation in centipawns from the side to move's point of view (signed, little-endian, bytes 28-29)
+ */
+
+#ifndef TRAININGDATA_H
+#define TRAININGDATA_H
+
+#include "GameRecord.h"
+#include "PackedPosition.h"
+#include "Position.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The size of a packed training record in bytes
+const size_t trainingRecordSize = packedPositionSize;
+
+/*
+ * A position sampled from a self-play game, with the engine's evaluation and the game's result.
+ */
+struct TrainingRecord {
+    Position position; // The position (statusFlags is positionLoaded | positionStateStale once unpacked)
+    int16_t evaluation; // The search score in centipawns from the side to move's point of view
+    GameResult result; // The result of the game the position was played in
+};
+
+/*
+ * Packs a training record into the 32-byte record format.
+ *
+ * @param record The record to pack (its position must hold at most 32 pieces).
+ * @param bytes An array of at least trainingRecordSize bytes to store the packed record in.
+ */
+void packTrainingRecord(const TrainingRecord& record, uint8_t* bytes);
+
+/*
+ * Unpacks a training record from the 32-byte record format.
+ *
+ * @param bytes The packed record.
+ * @param record A reference to store the record in.
+ *
+ * @return true if the record is well formed (matching occupancy and piece codes); false otherwise.
+ */
+bool unpackTrainingRecord(const uint8_t* bytes, TrainingRecord& record);
+
+
+/****************************** Class TrainingDataWriter ******************************/
+
+class TrainingDataWriter final {
+
+    public:
+        /*
+         * Parameterised constructor which creates the shard files (named <prefix>-000.bin,
+         * <prefix>-001.bin and so on) and starts the thread that writes to them.
+         *
+         * @param prefix The path and name prefix of the shard files.
+         * @param shardCount The number of shard files (at least one).
+         * @param maxQueuedBuffers The number of buffers that may wait to be written before
+         *                         write() blocks, bounding the memory used when the disk falls behind.
+         */
+        TrainingDataWriter(const std::string& prefix, size_t shardCount, size_t maxQueuedBuffers = 16);
+
+        /*
+         * Destructor writes every queued buffer and closes the shard files (see close()).
+         */
+        ~TrainingDataWriter();
+
+        TrainingDataWriter(const TrainingDataWriter&) = delete;
+        TrainingDataWriter& operator=(const TrainingDataWriter&) = delete;
+
+        /*
+         * Determines whether every shard file was created.
+         *
+         * @return true if the shard files are open; false otherwise.
+         */
+        bool isOpen() const;
+
+        /*
+         * Queues a buffer of packed records to be appended to the next shard (in turn) by the
+         * writer thread, and hands back an empty buffer (recycled from one already written, so
+         * callers reuse its capacity). Blocks while too many buffers are queued. Thread-safe, but
+         * must not be called once close() has been.
+         *
+         * @param buffer The buffer to write (a whole number of records), left empty on return.
+         */
+        void write(std::vector<uint8_t>& buffer);
+
+        /*
+         * Writes every queued buffer, stops the writer thread and closes the shard files. Further
+         * calls have no effect.
+         *
+         * @return true if every record was written; false if a write failed.
+         */
+        bool close();
+
+        /*
+         * Getter function for the number of bytes written to the shard files so far.
+         *
+         * @return The number of bytes written.
+         */
+        uint64_t getBytesWritten();
+
+    private:
+        std::vector<std::ofstream> shards; // The shard files
+        size_t maxQueuedBuffers; // The number of queued buffers at which write() blocks
+        std::mutex queueMutex; // Guards every member below
+        std::condition_variable queueChanged; // Signalled when a buffer is queued or written, or the writer is stopping
+        std::deque<std::vector<uint8_t>> queued; // Buffers waiting to be written, in submission order
+        std::vector<std::vector<uint8_t>> spare; // Written buffers, kept for their capacity
+        size_t nextShard = 0; // The shard the next buffer is appended to
+        uint64_t bytesWritten = 0; // The number of bytes written
+        bool failed = false; // Indicates that a write failed
+        bool stopping = false; // Indicates that the writer should exit once the queue is empty
+        std::thread writer; // The thread writing queued buffers
+
+        /*
+         * Writes queued buffers until the writer is stopped and its queue has been drained.
+         */
+        void runWriter();
+};
+
+
+/****************************** Class TrainingDataReader ******************************/
+
+class TrainingDataReader final {
+
+    public:
+        /*
+         * Parameterised constructor for a reader that streams the records of training data files
+         * in turn, reading each file in large blocks.
+         *
+         * @param paths The paths of the files (for example, every shard of a run).
+         */
+        explicit TrainingDataReader(const std::vector<std::string>& paths);
+
+        /*
+         * Reads the next record.
+         *
+         * @param record A reference to store the record in.
+         *
+         * @return true if a record was read; false at the end of the last file or on an error (see hasFailed()).
+         */
+        bool next(TrainingRecord& record);
+
+        /*
+         * Determines whether reading stopped early: a file could not be opened, ended part
+         * way through a record or held a malformed record.
+         *
+         * @return true if an error stopped the reader; false otherwise.
+         */
+        bool hasFailed() const;
+
+    private:
+        std::vector<std::string> paths; // The files to read, in order
+        size_t nextPath = 0; // The index of the next file to open
+        std::ifstream input; // The file being read
+        std::vector<uint8_t> block; // Records read from the file but not yet returned
+        size_t blockOffset = 0; // The offset of the next record in 'block'
+        size_t blockSize = 0; // The number of valid bytes in 'block'
+        bool failed = false; // Indicates that an error stopped the reader
+
+        /*
+         * Refills the block from the current file, opening the next file when one is exhausted.
+         *
+         * @return true if at least one record is available; false at the end of the last file or on an error.
+         */
+        bool fillBlock();
+};
+
+
+/*
+ * The parameters of a run of the self-play training data generator.
+ */
+struct TrainingDataSettings {
+    uint64_t positions = 100000; // The number of positions to write (whole games are played, so slightly more are written)
+    unsigned threadCount = 0; // The number of games played at once (0 for one per hardware thread)
+    int searchDepth = 3; // The depth each move is searched to
+    int randomOpeningPlies = 8; // The number of random legal moves played from the starting position, for variety
+    int skipPlies = 8; // The number of plies after the random opening before positions are sampled
+    double sampleRate = 0.5; // The probability of sampling each eligible position
+    int maxPlies = 400; // Games still in progress after this many plies are adjudicated drawn
+    uint64_t firstSeed = 1; // The seed of the first game (game 'index' is played from seed firstSeed + index)
+    size_t recordsPerBuffer = 1 << 14; // The number of records a worker packs before queueing them to be written
+};
+
+/*
+ * Counters describing a run of generateTrainingData().
+ */
+struct TrainingDataStatistics {
+    uint64_t games = 0; // The number of games played
+    uint64_t plies = 0; // The number of moves played across every game
+    uint64_t positions = 0; // The number of positions written
+    uint64_t results[4] = {0, 0, 0, 0}; // The number of games with each result, indexed by GameResult
+    double seconds = 0; // The time taken
+};
+
+/*
+ * Plays self-play games across worker threads and writes a sample of their positions to
+ * training data. Each game starts with random legal moves from the starting position and is
+ * then played by the search at a fixed depth until checkmate, stalemate, the 50-move rule,
+ * threefold repetition or the ply limit. Positions in check, and positions whose best move
+ * captures or promotes, are never sampled, as their evaluation is not settled. Each game's
+ * records are packed once its result is known, into a buffer local to the worker, and full
+ * buffers are queued to the writer, so the workers never wait for the disk. Every record has
+ * been queued (but not necessarily written) on return; close the writer to finish writing.
+ *
+ * @param settings The number of positions, threads, search depth and sampling parameters.
+ * @param writer The writer to queue the packed records to.
+ *
+ * @return The number of games, plies and positions, the results of the games and the time taken.
+ */
+TrainingDataStatistics generateTrainingData(const TrainingDataSettings& settings, TrainingDataWriter& writer);
+
+#endif
@@ -0,0 +1,108 @@
+/*
+ * TrainingDataTool.cpp - Command line tool to generate training data for evaluation weights
+ * from self-play, and to read it back.
+ *
+ * generate: plays self-play games across worker threads and writes a sample of their positions,
+ * each with its search score and the game's result, as 32-byte packed records into sharded files
+ * (<prefix>-000.bin and so on), written asynchronously.
+ *
+ * read: streams the records of training data files, checks that each unpacks to a position the
+ * rules engine accepts (ChessGame::restorePlayablePosition(), with at least one legal move), and
+ * reports how many were read, the results and evaluations, and the read speed.
+ *
+ * Usage: datagen generate <output prefix> <positions> [threads] [shards] [depth] [first seed]
+ *        datagen read <file>...
+ */
+
+#include "ChessGame.h"
+#include "TrainingData.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+static const int maxInvalidListed = 20;
+
+/* GENERATES TRAINING DATA INTO SHARD FILES */
+static int generateData(int argc, char** argv) {
+    TrainingDataSettings settings;
+    settings.positions = strtoull(argv[3], nullptr, 10);
+    settings.threadCount = (argc > 4 ? atoi(argv[4]) : 0);
+    size_t shardCount = (argc > 5 ? strtoull(argv[5], nullptr, 10) : 1);
+    settings.searchDepth = (argc > 6 ? atoi(argv[6]) : settings.searchDepth);
+    settings.firstSeed = (argc > 7 ? strtoull(argv[7], nullptr, 10) : settings.firstSeed);
+
+    TrainingDataWriter writer(argv[2], shardCount);
+    if (!writer.isOpen()) {
+        cerr << "Could not create the shard files " << argv[2] << "-*.bin\n";
+        return 1;
+    }
+    Clock::time_point start = Clock::now();
+    TrainingDataStatistics statistics = generateTrainingData(settings, writer);
+    bool written = writer.close();
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+    cout << statistics.positions << " positions from " << statistics.games << " games (" << statistics.plies
+         << " plies, depth " << settings.searchDepth << ") in " << seconds << " s\n";
+    cout << "  " << static_cast<uint64_t>(statistics.positions / seconds) << " positions/s ("
+         << static_cast<uint64_t>(statistics.positions / seconds * 3600) << " per hour), "
+         << writer.getBytesWritten() << " bytes in " << max<size_t>(shardCount, 1) << " shard(s)\n";
+    cout << "  results: " << statistics.results[whiteWins] << " white wins, " << statistics.results[blackWins]
+         << " black wins, " << statistics.results[drawnGame] << " draws\n";
+    if (!written) {
+        cerr << "Could not write every record\n";
+        return 2;
+    }
+    return 0;
+}
+
+/* STREAMS TRAINING DATA FILES, CHECKING EACH RECORD */
+static int readData(int argc, char** argv) {
+    TrainingDataReader reader(vector<string>(argv + 2, argv + argc));
+    ChessGame game;
+    game.setConsoleOutput(false);
+
+    Clock::time_point start = Clock::now();
+    TrainingRecord record;
+    uint64_t records = 0, invalid = 0, results[4] = {0, 0, 0, 0}, absoluteEvaluations = 0;
+    Move moveList[maxLegalMoves];
+    while (reader.next(record)) {
+        records++;
+        results[record.result]++;
+        absoluteEvaluations += abs(record.evaluation);
+
+        bool valid = game.restorePlayablePosition(record.position) && game.generateLegalMoves(moveList) > 0;
+        if (!valid && invalid++ < maxInvalidListed) {
+            cout << "record " << records << ": not a playable position\n";
+        }
+    }
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+    if (reader.hasFailed()) {
+        cerr << "Reading stopped after " << records << " records: a file could not be read or is malformed\n";
+    }
+    cout << "Read " << records << " records in " << seconds << " s (" << static_cast<uint64_t>(records / seconds)
+         << " records/s): " << invalid << " invalid\n";
+    cout << "  results: " << results[whiteWins] << " white wins, " << results[blackWins] << " black wins, "
+         << results[drawnGame] << " draws; mean |evaluation| "
+         << (records == 0 ? 0 : absoluteEvaluations / records) << " cp\n";
+    return (reader.hasFailed() || invalid > 0 ? 2 : 0);
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 4 && strcmp(argv[1], "generate") == 0) {
+        return generateData(argc, argv);
+    }
+    if (argc >= 3 && strcmp(argv[1], "read") == 0) {
+        return readData(argc, argv);
+    }
+    cerr << "Usage: " << argv[0] << " generate <output prefix> <positions> [threads] [shards] [depth] [first seed]\n"
+         << "       " << argv[0] << " read <file>...\n";
+    return 1;
+}
@@ -0,0 +1,53 @@
+/*
+ * TranspositionTable.cpp - Implementation file for the TranspositionTable class, a
+ * fixed-size table of search results indexed by position hash.
+ */
+
+#include "TranspositionTable.h"
+
+using namespace std;
+
+
+/****************************** TranspositionTable - Member Function Definitions ******************************/
+
+/* CONSTRUCTOR - ALLOCATES A POWER OF TWO NUMBER OF EMPTY SLOTS */
+TranspositionTable::TranspositionTable(size_t entryCount) {
+    size_t slotCount = 1;
+    while (slotCount * 2 <= entryCount) {
+        slotCount *= 2;
+    }
+    entries.resize(slotCount);
+    indexMask = slotCount - 1;
+    clear();
+}
+
+/* LOOKS UP A POSITION */
+bool TranspositionTable::probe(uint64_t hash, TranspositionEntry& entry) const {
+    const TranspositionEntry& slot = entries[hash & indexMask];
+    if (slot.hash != hash || slot.depth < 0) {
+        return false;
+    }
+    entry = slot;
+    return true;
+}
+
+/* STORES A SEARCH RESULT, PREFERRING DEEPER RESULTS FOR OTHER POSITIONS */
+void TranspositionTable::store(const TranspositionEntry& entry) {
+    TranspositionEntry& slot = entries[entry.hash & indexMask];
+    if (slot.hash != entry.hash && slot.depth > entry.depth) {
+        return;
+    }
+    slot = entry;
+}
+
+/* EMPTIES THE TABLE */
+void TranspositionTable::clear() {
+    for (TranspositionEntry& slot : entries) {
+        slot = TranspositionEntry{0, Move(), 0, -1, exactScore};
+    }
+}
+
+/* GETTER FOR THE SIZE OF THE TABLE IN BYTES */
+size_t TranspositionTable::getMemoryUsage() const {
+    return entries.size() * sizeof(TranspositionEntry);
+}
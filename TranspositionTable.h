@@ -0,0 +1,78 @@
+/*
+ * TranspositionTable.h - Header file for the TranspositionTable class, a fixed-size
+ * table of search results indexed by position hash, owned by a single search.
+ */
+
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include "Move.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Enum representing how a stored score bounds the true score of a position.
+ */
+enum ScoreBound : uint8_t {exactScore, lowerBound, upperBound};
+
+/*
+ * The stored result of searching a single position.
+ */
+struct TranspositionEntry {
+    uint64_t hash; // The Zobrist hash of the position (ChessGame::positionHash())
+    Move bestMove; // The best move found (the null move if none)
+    int16_t score; // The score from the perspective of the side to move
+    int8_t depth; // The depth that the position was searched to
+    ScoreBound bound; // How 'score' bounds the true score
+};
+
+
+/****************************** Class TranspositionTable ******************************/
+
+class TranspositionTable final {
+
+    public:
+        /*
+         * Parameterised constructor for a table holding a fixed number of entries.
+         *
+         * @param entryCount The number of entries (rounded down to a power of two, at least one).
+         */
+        explicit TranspositionTable(size_t entryCount);
+
+        /*
+         * Looks up a position.
+         *
+         * @param hash The Zobrist hash of the position.
+         * @param entry A reference to copy the stored entry into if found.
+         *
+         * @return true if the position was found; false otherwise.
+         */
+        bool probe(uint64_t hash, TranspositionEntry& entry) const;
+
+        /*
+         * Stores the result of searching a position, replacing the entry in its slot unless that
+         * entry is for a different position searched to a greater depth.
+         *
+         * @param entry The entry to store.
+         */
+        void store(const TranspositionEntry& entry);
+
+        /*
+         * Empties the table.
+         */
+        void clear();
+
+        /*
+         * Getter function for the size of the table.
+         *
+         * @return The number of bytes of entries held.
+         */
+        size_t getMemoryUsage() const;
+
+    private:
+        std::vector<TranspositionEntry> entries; // The slots, indexed by the low bits of the hash
+        uint64_t indexMask; // The number of slots less one
+};
+
+#endif
@@ -0,0 +1,69 @@
+/*
+ * Zobrist.h - Header file for the Zobrist keys used to hash chess positions.
+ * The keys are generated at compile time, so hashing needs no runtime initialisation.
+ */
+
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "Enums.h"
+#include <cstdint>
+
+/*
+ * The complete set of random keys. A position's hash is the XOR of the keys for each
+ * (colour, piece type, square) on the board, the side to move, each castling right
+ * still held and the file of the en passant square (if any).
+ */
+struct ZobristKeys {
+    uint64_t pieces[2][6][64]; // Indexed by [PieceColour][PieceType][rank * 8 + file]
+    uint64_t blackToMove; // XORed in when it is black's turn
+    uint64_t castling[4]; // White kingside, white queenside, black kingside, black queenside
+    uint64_t enPassantFile[8]; // Indexed by the file of the en passant square
+};
+
+/*
+ * Advances a SplitMix64 generator and returns its next output. It is also the generator of the
+ * seeded random games and training data: any seed (including zero) is accepted, and
+ * consecutive seeds give unrelated sequences.
+ *
+ * @param state A reference to the generator state.
+ * @return The next pseudo-random 64-bit value.
+ */
+constexpr uint64_t splitMix64(uint64_t& state) {
+    state += 0x9E3779B97F4A7C15ULL;
+    uint64_t value = state;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+/*
+ * Generates the Zobrist keys from a fixed seed, so that hashes are stable between builds
+ * and can be stored on disk.
+ *
+ * @return The complete set of keys.
+ */
+constexpr ZobristKeys generateZobristKeys() {
+    ZobristKeys keys{};
+    uint64_t state = 0x43484553535A4F42ULL;
+
+    for (int colour = 0; colour < 2; colour++) {
+        for (int type = 0; type < 6; type++) {
+            for (int square = 0; square < 64; square++) {
+                keys.pieces[colour][type][square] = splitMix64(state);
+            }
+        }
+    }
+    keys.blackToMove = splitMix64(state);
+    for (int right = 0; right < 4; right++) {
+        keys.castling[right] = splitMix64(state);
+    }
+    for (int file = 0; file < 8; file++) {
+        keys.enPassantFile[file] = splitMix64(state);
+    }
+    return keys;
+}
+
+inline constexpr ZobristKeys zobristKeys = generateZobristKeys();
+
+#endif